@@ -29,9 +29,15 @@ public class BirdGameProject : Project
         conf.Options.Add(Options.Vc.General.TreatWarningsAsErrors.Enable);
         conf.Options.Add(Options.Vc.General.WindowsTargetPlatformVersion.Latest);
 
-        conf.Options.Add(Options.Vc.Compiler.CppLanguageStandard.CPP17);
+        // C++20 for the coroutines of the task system. It turns on /permissive- by default, which rejects the addresses of
+        // temporaries that the d3dx12 helpers are passed by all over the renderer, so keep the conformance mode of C++17.
+        conf.Options.Add(Options.Vc.Compiler.CppLanguageStandard.CPP20);
+        conf.Options.Add(Options.Vc.Compiler.ConformanceMode.Disable);
         conf.Options.Add(Options.Vc.Compiler.Exceptions.Enable);
 
+        // The font atlas is built by a constexpr function, which takes more steps than the compiler allows by default
+        conf.AdditionalCompilerOptions.Add("/constexpr:steps10000000");
+
         conf.Options.Add(Options.Vc.Linker.SubSystem.Windows);
         conf.Options.Add(Options.Vc.Linker.LargeAddress.SupportLargerThan2Gb);
 
@@ -39,6 +45,367 @@ public class BirdGameProject : Project
         conf.LibraryFiles.Add("dxgi");
         conf.LibraryFiles.Add("d3dcompiler");
         conf.LibraryFiles.Add("dxguid");
+
+        // Pack the data directory after every build so the game only has to open data.pak at startup
+        conf.AddPrivateDependency<AssetPackerProject>(target, DependencySetting.OnlyBuildOrder);
+        conf.EventPostBuild.Add(@"""$(OutDir)AssetPacker.exe"" ""[project.SharpmakeCsPath]\data"" ""[project.SharpmakeCsPath]\data.pak""");
+    }
+}
+
+[Generate]
+public class LogDecoderProject : Project
+{
+    public LogDecoderProject()
+    {
+        Name = "LogDecoder";
+        AddTargets(new Target(Platform.win64, DevEnv.vs2022, Optimization.Debug | Optimization.Release));
+        SourceRootPath = @"[project.SharpmakeCsPath]\tools\LogDecoder";
+
+        // The decoder shares the argument formatting code with the game
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\LogFormat.cpp");
+    }
+
+    [Configure()]
+    public void Configure(Configuration conf, Target target)
+    {
+        conf.ProjectFileName = "LogDecoder";
+        conf.ProjectPath = @"[project.SharpmakeCsPath]\generated";
+
+        conf.IncludePaths.Add(@"[project.SharpmakeCsPath]\include");
+
+        conf.Options.Add(Options.Vc.General.CharacterSet.Unicode);
+        conf.Options.Add(Options.Vc.General.WarningLevel.Level3);
+        conf.Options.Add(Options.Vc.General.TreatWarningsAsErrors.Enable);
+        conf.Options.Add(Options.Vc.General.WindowsTargetPlatformVersion.Latest);
+
+        conf.Options.Add(Options.Vc.Compiler.CppLanguageStandard.CPP17);
+        conf.Options.Add(Options.Vc.Compiler.Exceptions.Enable);
+
+        conf.Options.Add(Options.Vc.Linker.SubSystem.Console);
+
+        // fopen and friends are fine for a command line tool
+        conf.Defines.Add("_CRT_SECURE_NO_WARNINGS");
+    }
+}
+
+[Generate]
+public class AssetPackerProject : Project
+{
+    public AssetPackerProject()
+    {
+        Name = "AssetPacker";
+        AddTargets(new Target(Platform.win64, DevEnv.vs2022, Optimization.Debug | Optimization.Release));
+        SourceRootPath = @"[project.SharpmakeCsPath]\tools\AssetPacker";
+
+        // The packer writes the same format the game reads
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Assets.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Util.cpp");
+    }
+
+    [Configure()]
+    public void Configure(Configuration conf, Target target)
+    {
+        conf.ProjectFileName = "AssetPacker";
+        conf.ProjectPath = @"[project.SharpmakeCsPath]\generated";
+
+        conf.IncludePaths.Add(@"[project.SharpmakeCsPath]\include");
+
+        conf.Options.Add(Options.Vc.General.CharacterSet.Unicode);
+        conf.Options.Add(Options.Vc.General.WarningLevel.Level3);
+        conf.Options.Add(Options.Vc.General.TreatWarningsAsErrors.Enable);
+        conf.Options.Add(Options.Vc.General.WindowsTargetPlatformVersion.Latest);
+
+        conf.Options.Add(Options.Vc.Compiler.CppLanguageStandard.CPP17);
+        conf.Options.Add(Options.Vc.Compiler.Exceptions.Enable);
+
+        conf.Options.Add(Options.Vc.Linker.SubSystem.Console);
+
+        conf.Defines.Add("_CRT_SECURE_NO_WARNINGS");
+    }
+}
+
+[Generate]
+public class FramePacingSimProject : Project
+{
+    public FramePacingSimProject()
+    {
+        Name = "FramePacingSim";
+        AddTargets(new Target(Platform.win64, DevEnv.vs2022, Optimization.Debug | Optimization.Release));
+        SourceRootPath = @"[project.SharpmakeCsPath]\tools\FramePacingSim";
+    }
+
+    [Configure()]
+    public void Configure(Configuration conf, Target target)
+    {
+        conf.ProjectFileName = "FramePacingSim";
+        conf.ProjectPath = @"[project.SharpmakeCsPath]\generated";
+
+        conf.Options.Add(Options.Vc.General.CharacterSet.Unicode);
+        conf.Options.Add(Options.Vc.General.WarningLevel.Level3);
+        conf.Options.Add(Options.Vc.General.TreatWarningsAsErrors.Enable);
+        conf.Options.Add(Options.Vc.General.WindowsTargetPlatformVersion.Latest);
+
+        conf.Options.Add(Options.Vc.Compiler.CppLanguageStandard.CPP17);
+        conf.Options.Add(Options.Vc.Compiler.Exceptions.Enable);
+
+        conf.Options.Add(Options.Vc.Linker.SubSystem.Console);
+    }
+}
+
+[Generate]
+public class RenderBenchProject : Project
+{
+    public RenderBenchProject()
+    {
+        Name = "RenderBench";
+        AddTargets(new Target(Platform.win64, DevEnv.vs2022, Optimization.Debug | Optimization.Release));
+        SourceRootPath = @"[project.SharpmakeCsPath]\tools\RenderBench";
+
+        // The renderer front end and the recording backend, nothing that needs D3D12 or a window
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Renderer.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\RecordingBackend.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\SoftwareBackend.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\SoftwareRasterizer.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\PassRecorder.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\SpriteBatch.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\SkylinePacker.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\FrameRingAllocator.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\TextLayout.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Font.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Log.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\LogFormat.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\LogSinks.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Util.cpp");
+    }
+
+    [Configure()]
+    public void Configure(Configuration conf, Target target)
+    {
+        conf.ProjectFileName = "RenderBench";
+        conf.ProjectPath = @"[project.SharpmakeCsPath]\generated";
+
+        conf.IncludePaths.Add(@"[project.SharpmakeCsPath]\include");
+
+        conf.Options.Add(Options.Vc.General.CharacterSet.Unicode);
+        conf.Options.Add(Options.Vc.General.WarningLevel.Level3);
+        conf.Options.Add(Options.Vc.General.TreatWarningsAsErrors.Enable);
+        conf.Options.Add(Options.Vc.General.WindowsTargetPlatformVersion.Latest);
+
+        conf.Options.Add(Options.Vc.Compiler.CppLanguageStandard.CPP17);
+        conf.Options.Add(Options.Vc.Compiler.Exceptions.Enable);
+
+        // Same as the game, for the font atlas
+        conf.AdditionalCompilerOptions.Add("/constexpr:steps10000000");
+
+        conf.Options.Add(Options.Vc.Linker.SubSystem.Console);
+
+        conf.Defines.Add("_CRT_SECURE_NO_WARNINGS");
+    }
+}
+
+[Generate]
+public class JobBenchProject : Project
+{
+    public JobBenchProject()
+    {
+        Name = "JobBench";
+        AddTargets(new Target(Platform.win64, DevEnv.vs2022, Optimization.Debug | Optimization.Release));
+        SourceRootPath = @"[project.SharpmakeCsPath]\tools\JobBench";
+
+        // Tasks need C++20 coroutines, and LoadAsset pulls in the asset streamer
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\JobSystem.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Task.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Assets.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\AssetStreamer.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Log.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\LogFormat.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\LogSinks.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Util.cpp");
+    }
+
+    [Configure()]
+    public void Configure(Configuration conf, Target target)
+    {
+        conf.ProjectFileName = "JobBench";
+        conf.ProjectPath = @"[project.SharpmakeCsPath]\generated";
+
+        conf.IncludePaths.Add(@"[project.SharpmakeCsPath]\include");
+
+        conf.Options.Add(Options.Vc.General.CharacterSet.Unicode);
+        conf.Options.Add(Options.Vc.General.WarningLevel.Level3);
+        conf.Options.Add(Options.Vc.General.TreatWarningsAsErrors.Enable);
+        conf.Options.Add(Options.Vc.General.WindowsTargetPlatformVersion.Latest);
+
+        conf.Options.Add(Options.Vc.Compiler.CppLanguageStandard.CPP20);
+        conf.Options.Add(Options.Vc.Compiler.Exceptions.Enable);
+
+        conf.Options.Add(Options.Vc.Linker.SubSystem.Console);
+
+        conf.Defines.Add("_CRT_SECURE_NO_WARNINGS");
+    }
+}
+
+[Generate]
+public class LogBenchProject : Project
+{
+    public LogBenchProject()
+    {
+        Name = "LogBench";
+        AddTargets(new Target(Platform.win64, DevEnv.vs2022, Optimization.Debug | Optimization.Release));
+        SourceRootPath = @"[project.SharpmakeCsPath]\tools\LogBench";
+
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Log.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\LogFormat.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\LogSinks.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Util.cpp");
+    }
+
+    [Configure()]
+    public void Configure(Configuration conf, Target target)
+    {
+        conf.ProjectFileName = "LogBench";
+        conf.ProjectPath = @"[project.SharpmakeCsPath]\generated";
+
+        conf.IncludePaths.Add(@"[project.SharpmakeCsPath]\include");
+
+        conf.Options.Add(Options.Vc.General.CharacterSet.Unicode);
+        conf.Options.Add(Options.Vc.General.WarningLevel.Level3);
+        conf.Options.Add(Options.Vc.General.TreatWarningsAsErrors.Enable);
+        conf.Options.Add(Options.Vc.General.WindowsTargetPlatformVersion.Latest);
+
+        conf.Options.Add(Options.Vc.Compiler.CppLanguageStandard.CPP17);
+        conf.Options.Add(Options.Vc.Compiler.Exceptions.Enable);
+
+        conf.Options.Add(Options.Vc.Linker.SubSystem.Console);
+
+        conf.Defines.Add("_CRT_SECURE_NO_WARNINGS");
+    }
+}
+
+[Generate]
+public class AssetStreamBenchProject : Project
+{
+    public AssetStreamBenchProject()
+    {
+        Name = "AssetStreamBench";
+        AddTargets(new Target(Platform.win64, DevEnv.vs2022, Optimization.Debug | Optimization.Release));
+        SourceRootPath = @"[project.SharpmakeCsPath]\tools\AssetStreamBench";
+
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\AssetStreamer.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Assets.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Util.cpp");
+    }
+
+    [Configure()]
+    public void Configure(Configuration conf, Target target)
+    {
+        conf.ProjectFileName = "AssetStreamBench";
+        conf.ProjectPath = @"[project.SharpmakeCsPath]\generated";
+
+        conf.IncludePaths.Add(@"[project.SharpmakeCsPath]\include");
+
+        conf.Options.Add(Options.Vc.General.CharacterSet.Unicode);
+        conf.Options.Add(Options.Vc.General.WarningLevel.Level3);
+        conf.Options.Add(Options.Vc.General.TreatWarningsAsErrors.Enable);
+        conf.Options.Add(Options.Vc.General.WindowsTargetPlatformVersion.Latest);
+
+        conf.Options.Add(Options.Vc.Compiler.CppLanguageStandard.CPP17);
+        conf.Options.Add(Options.Vc.Compiler.Exceptions.Enable);
+
+        conf.Options.Add(Options.Vc.Linker.SubSystem.Console);
+
+        conf.Defines.Add("_CRT_SECURE_NO_WARNINGS");
+    }
+}
+
+[Generate]
+public class RendererTestsProject : Project
+{
+    public RendererTestsProject()
+    {
+        Name = "RendererTests";
+        AddTargets(new Target(Platform.win64, DevEnv.vs2022, Optimization.Debug | Optimization.Release));
+        SourceRootPath = @"[project.SharpmakeCsPath]\tests\RendererTests";
+
+        // Only the parts of the renderer that don't need D3D12
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\SkylinePacker.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\DescriptorAllocator.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\FrameRingAllocator.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\TextLayout.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Font.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\SpriteBatch.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\SoftwareRasterizer.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\PassRecorder.cpp");
+
+        // The software rasterizer logs when it can't write an image
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Log.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\LogFormat.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\LogSinks.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Util.cpp");
+    }
+
+    [Configure()]
+    public void Configure(Configuration conf, Target target)
+    {
+        conf.ProjectFileName = "RendererTests";
+        conf.ProjectPath = @"[project.SharpmakeCsPath]\generated";
+
+        conf.IncludePaths.Add(@"[project.SharpmakeCsPath]\include");
+
+        conf.Options.Add(Options.Vc.General.CharacterSet.Unicode);
+        conf.Options.Add(Options.Vc.General.WarningLevel.Level3);
+        conf.Options.Add(Options.Vc.General.TreatWarningsAsErrors.Enable);
+        conf.Options.Add(Options.Vc.General.WindowsTargetPlatformVersion.Latest);
+
+        conf.Options.Add(Options.Vc.Compiler.CppLanguageStandard.CPP17);
+        conf.Options.Add(Options.Vc.Compiler.Exceptions.Enable);
+
+        conf.Options.Add(Options.Vc.Linker.SubSystem.Console);
+
+        conf.Defines.Add("_CRT_SECURE_NO_WARNINGS");
+    }
+}
+
+[Generate]
+public class JobTestsProject : Project
+{
+    public JobTestsProject()
+    {
+        Name = "JobTests";
+        AddTargets(new Target(Platform.win64, DevEnv.vs2022, Optimization.Debug | Optimization.Release));
+        SourceRootPath = @"[project.SharpmakeCsPath]\tests\JobTests";
+
+        // Tasks need C++20 coroutines, and LoadAsset pulls in the asset streamer. MSVC has no thread sanitizer, JobTests.cpp
+        // has the command line for a build with clang's or gcc's.
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\JobSystem.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Task.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Assets.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\AssetStreamer.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Log.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\LogFormat.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\LogSinks.cpp");
+        SourceFiles.Add(@"[project.SharpmakeCsPath]\src\Util.cpp");
+    }
+
+    [Configure()]
+    public void Configure(Configuration conf, Target target)
+    {
+        conf.ProjectFileName = "JobTests";
+        conf.ProjectPath = @"[project.SharpmakeCsPath]\generated";
+
+        conf.IncludePaths.Add(@"[project.SharpmakeCsPath]\include");
+
+        conf.Options.Add(Options.Vc.General.CharacterSet.Unicode);
+        conf.Options.Add(Options.Vc.General.WarningLevel.Level3);
+        conf.Options.Add(Options.Vc.General.TreatWarningsAsErrors.Enable);
+        conf.Options.Add(Options.Vc.General.WindowsTargetPlatformVersion.Latest);
+
+        conf.Options.Add(Options.Vc.Compiler.CppLanguageStandard.CPP20);
+        conf.Options.Add(Options.Vc.Compiler.Exceptions.Enable);
+
+        conf.Options.Add(Options.Vc.Linker.SubSystem.Console);
+
+        conf.Defines.Add("_CRT_SECURE_NO_WARNINGS");
     }
 }
 
@@ -57,6 +424,15 @@ public class BirdGameSolution : Solution
         conf.SolutionFileName = "BirdGame";
         conf.SolutionPath = @"[solution.SharpmakeCsPath]\generated";
         conf.AddProject<BirdGameProject>(target);
+        conf.AddProject<LogDecoderProject>(target);
+        conf.AddProject<AssetPackerProject>(target);
+        conf.AddProject<FramePacingSimProject>(target);
+        conf.AddProject<RenderBenchProject>(target);
+        conf.AddProject<JobBenchProject>(target);
+        conf.AddProject<LogBenchProject>(target);
+        conf.AddProject<AssetStreamBenchProject>(target);
+        conf.AddProject<RendererTestsProject>(target);
+        conf.AddProject<JobTestsProject>(target);
     }
 }
 
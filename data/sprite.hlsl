@@ -0,0 +1,35 @@
+// Each instance is one sprite, see SpriteInstance in SpriteBatch.h. The quad is expanded from SV_VertexID as a 4 vertex
+// triangle strip like the text.
+
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD;
+    float4 color : COLOR;
+};
+
+cbuffer SpriteConstants : register(b0)
+{
+    float2 g_screenSize;
+};
+
+Texture2D g_texture : register(t0);
+SamplerState g_sampler : register(s0);
+
+PSInput VSMain(float4 rect : RECT, float4 uvRect : TEXCOORD, float4 color : COLOR, uint vertexId : SV_VertexID)
+{
+    PSInput result;
+
+    const float2 corner = float2(vertexId & 1, vertexId >> 1);
+    const float2 pixel = rect.xy + corner * rect.zw;
+    result.position = float4((pixel.x / g_screenSize.x) * 2.0 - 1.0, 1.0 - (pixel.y / g_screenSize.y) * 2.0, 0.0, 1.0);
+    result.uv = lerp(uvRect.xy, uvRect.zw, corner);
+    result.color = color;
+
+    return result;
+}
+
+float4 PSMain(PSInput input) : SV_TARGET
+{
+    return g_texture.Sample(g_sampler, input.uv) * input.color;
+}
@@ -0,0 +1,46 @@
+// Each instance is one glyph. The quad is expanded from SV_VertexID as a 4 vertex triangle strip and the UVs are worked out
+// from the glyph index, see ExpandGlyphInstance in TextLayout.cpp for the CPU version of this.
+
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD;
+    float3 color : COLOR;
+};
+
+cbuffer TextConstants : register(b0)
+{
+    float2 g_screenSize;
+};
+
+// The font atlas stores glyph coverage in the red channel
+Texture2D g_fontAtlas : register(t0);
+SamplerState g_sampler : register(s0);
+
+// These have to match the constants in Font.h
+static const uint CharWidth = 8;
+static const uint CharHeight = 16;
+static const uint CharsPerRow = 32;
+static const float2 AtlasSize = float2(256.0, 256.0);
+
+PSInput VSMain(int2 position : POSITION, uint glyphAndColor : GLYPH, uint vertexId : SV_VertexID)
+{
+    PSInput result;
+
+    const uint2 corner = uint2(vertexId & 1, vertexId >> 1);
+    const uint glyph = glyphAndColor & 0xFF;
+    const uint2 cell = uint2(glyph % CharsPerRow, glyph / CharsPerRow);
+    const float2 charSize = float2(CharWidth, CharHeight);
+
+    const float2 pixel = float2(position) + float2(corner) * charSize;
+    result.position = float4((pixel.x / g_screenSize.x) * 2.0 - 1.0, 1.0 - (pixel.y / g_screenSize.y) * 2.0, 0.0, 1.0);
+    result.uv = (float2(cell + corner) * charSize) / AtlasSize;
+    result.color = float3((glyphAndColor >> 8) & 0xFF, (glyphAndColor >> 16) & 0xFF, glyphAndColor >> 24) / 255.0;
+
+    return result;
+}
+
+float4 PSMain(PSInput input) : SV_TARGET
+{
+    return float4(input.color, g_fontAtlas.Sample(g_sampler, input.uv).r);
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <GameLoop.h>
 #include <Renderer.h>
 #include <Window.h>
 
@@ -26,11 +27,26 @@ private:
     Application();
     Application(const Application&) = delete;
 
-    void Update();
-    void Render();
+    // Everything the simulation changes. Update steps it by a fixed time, Render draws the state before the last step
+    // blended towards the one after it.
+    struct GameState
+    {
+        double mScroll = 0.0;       // How far the world has scrolled, in pixels
+    };
+
+    // One fixed step of the simulation, in seconds
+    void Update(double step);
+    void Render(double alpha);
 
     Window mWindow;
     Renderer mRenderer;
 
+    FixedTimestep mTimestep;
+    FrameBudget mFrameBudget;
+
+    GameState mPreviousState;
+    GameState mState;
+    TextHandle mHelloText = RetainedText::InvalidHandle;
+
     static std::unique_ptr<Application> mInstance;
 };
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <Assets.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+enum class AssetPriority : uint8_t
+{
+    Critical,       // Needed for the next frame
+    High,
+    Normal,
+    Low,            // Prefetching
+};
+
+// AssetStreamer loads assets in the background so that startup doesn't wait for all of them.
+//
+// Requests go into a priority queue that is served by a couple of I/O threads. These load the asset through the
+// AssetManager and fault its pages in, then hand it to the decode threads which run the request's decode callback. The
+// completion callback runs on the main thread the next time DispatchCompletions is called, which the Application does
+// once per update. Within a priority requests are served in the order they were made.
+class AssetStreamer
+{
+public:
+    // Runs on a decode thread. Returns false if the asset couldn't be decoded.
+    using DecodeFunction = std::function<bool(const Asset& asset)>;
+
+    // Runs on the main thread. loaded is false if the asset couldn't be found or decoded.
+    using CompleteFunction = std::function<void(bool loaded)>;
+
+    static AssetStreamer& Get();
+
+    void Start(uint32_t ioThreadCount = 2, uint32_t decodeThreadCount = 0);
+
+    // Calls the completion callbacks of every request left, on the calling thread. Those that finished get their result
+    // and those that didn't are dropped with loaded false.
+    void Stop();
+
+    void Request(std::string_view path, AssetPriority priority, DecodeFunction decode, CompleteFunction complete);
+
+    // Calls the completion callbacks of everything that finished since the last call. Returns how many were called.
+    size_t DispatchCompletions();
+
+    uint32_t GetPendingCount() const { return mPendingCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Job
+    {
+        std::string mPath;
+        AssetPriority mPriority;
+        uint64_t mSequence;
+        DecodeFunction mDecode;
+        CompleteFunction mComplete;
+        Asset mAsset;
+        bool mLoaded = false;
+    };
+
+    struct JobOrder
+    {
+        bool operator()(const std::unique_ptr<Job>& a, const std::unique_ptr<Job>& b) const
+        {
+            // std::push_heap keeps the largest element at the front so compare backwards
+            return a->mPriority != b->mPriority ? a->mPriority > b->mPriority : a->mSequence > b->mSequence;
+        }
+    };
+
+    AssetStreamer() = default;
+    ~AssetStreamer();
+
+    void RunIO();
+    void RunDecode();
+
+    std::vector<std::thread> mThreads;
+    bool mStopRequested = false;
+    uint64_t mNextSequence = 0;
+    std::atomic<uint32_t> mPendingCount { 0 };
+
+    // Both queues are heaps ordered by JobOrder and guarded by mMutex
+    std::mutex mMutex;
+    std::condition_variable mIOCondition;
+    std::condition_variable mDecodeCondition;
+    std::vector<std::unique_ptr<Job>> mIOQueue;
+    std::vector<std::unique_ptr<Job>> mDecodeQueue;
+
+    std::mutex mCompletedMutex;
+    std::vector<std::unique_ptr<Job>> mCompleted;
+};
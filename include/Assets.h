@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Util.h>
+
+#include <cstdint>
+#include <string_view>
+
+// Layout of the packed asset archives built by the AssetPacker tool.
+//
+// The archive is a header, an index of entries sorted by the hash of their path, a table of the paths themselves and then
+// the file contents. Every blob starts at a multiple of the alignment in the header (16 bytes or a page) so that it can be
+// used in place straight out of the memory mapped archive.
+namespace AssetPack
+{
+    constexpr uint32_t Magic = 0x4B415042; // "BPAK"
+    constexpr uint32_t Version = 1;
+
+    struct Header
+    {
+        uint32_t mMagic;
+        uint32_t mVersion;
+        uint32_t mEntryCount;
+        uint32_t mAlignment;
+        uint64_t mIndexOffset;      // mEntryCount Entry structs sorted by mHash
+        uint64_t mNamesOffset;      // Paths of all the entries, not null terminated
+    };
+
+    struct Entry
+    {
+        uint64_t mHash;
+        uint64_t mOffset;
+        uint64_t mSize;
+        uint32_t mNameOffset;       // Relative to Header::mNamesOffset
+        uint32_t mNameLength;
+    };
+}
+
+// Paths are hashed with forward slashes so that "data\basic.hlsl" and "data/basic.hlsl" find the same asset
+uint64_t HashAssetPath(std::string_view path);
+
+// A memory mapped archive. Lookups are a binary search over the sorted index followed by a comparison of the names that
+// share the hash, and return a view into the mapping.
+class AssetArchive
+{
+public:
+    bool Open(std::string_view path);
+    void Close();
+
+    bool IsOpen() const { return mHeader != nullptr; }
+
+    // Returns false if the archive doesn't contain the path. Otherwise the view stays valid until the archive is closed.
+    bool Find(std::string_view path, std::string_view& data) const;
+
+    uint32_t GetEntryCount() const { return mHeader != nullptr ? mHeader->mEntryCount : 0; }
+    std::string_view GetEntryName(uint32_t index) const;
+
+private:
+    MappedFile mFile;
+    const AssetPack::Header* mHeader = nullptr;
+    const AssetPack::Entry* mEntries = nullptr;
+    const char* mNames = nullptr;
+};
+
+// The contents of one asset, either a view into the mounted archive or a loose file mapped on its own
+class Asset
+{
+public:
+    bool IsValid() const { return mValid; }
+    const uint8_t* GetData() const { return reinterpret_cast<const uint8_t*>(mData.data()); }
+    size_t GetSize() const { return mData.size(); }
+    std::string_view GetView() const { return mData; }
+
+private:
+    friend class AssetManager;
+
+    bool mValid = false;
+    std::string_view mData;
+    MappedFile mLooseFile;
+};
+
+// AssetManager is a singleton that finds assets by path. Assets come from the mounted archive if there is one so that
+// startup only opens a single file. Anything that isn't in the archive is loaded from disk so that assets can be
+// iterated on without repacking.
+class AssetManager
+{
+public:
+    static AssetManager& Get();
+
+    bool Mount(std::string_view archivePath);
+    Asset Load(std::string_view path) const;
+
+private:
+    AssetManager() = default;
+
+    AssetArchive mArchive;
+};
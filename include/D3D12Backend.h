@@ -0,0 +1,15 @@
+#pragma once
+
+#include <RenderBackend.h>
+
+#include <cstdint>
+#include <memory>
+
+class Window;
+
+constexpr uint32_t D3D12MaxFramesInFlight = 3;
+
+// Draws to the window's swap chain. framesInFlight is how many frames the CPU may get ahead of the GPU, clamped to
+// [1, D3D12MaxFramesInFlight]. One means the CPU waits for every frame to finish, more trades latency for keeping both
+// busy.
+std::unique_ptr<RenderBackend> CreateD3D12Backend(Window& window, uint32_t framesInFlight = 2);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <FrameRingAllocator.h>
+
+#include <cstdint>
+#include <vector>
+
+// Hands out slots of a single descriptor heap. It only deals in indices, the heap itself belongs to whoever owns the
+// allocator (see DescriptorHeap in D3D12Backend.cpp).
+//
+// The heap is split in two. The front is for persistent descriptors such as texture SRVs, allocated from a free list that
+// merges neighbouring ranges when they are freed. The back is a ring of transient descriptors that only live for the frame
+// they were allocated in, released with the same EndFrame and Retire calls as the upload ring. Persistent descriptors
+// that are freed are held back until the GPU is done with the frames that may still use them.
+class DescriptorAllocator
+{
+public:
+    static constexpr uint32_t InvalidIndex = ~0u;
+
+    void Initialize(uint32_t persistentCount, uint32_t transientCount);
+
+    // count descriptors in a row. Returns the index of the first one, or InvalidIndex if there is no free range that large.
+    uint32_t AllocatePersistent(uint32_t count);
+    void FreePersistent(uint32_t index, uint32_t count);
+
+    // Same as AllocatePersistent but only valid until the GPU is done with the current frame
+    uint32_t AllocateTransient(uint32_t count);
+
+    void EndFrame(uint64_t fenceValue);
+    void Retire(uint64_t completedFenceValue);
+
+    uint32_t GetDescriptorCount() const { return mPersistentCount + mTransientCount; }
+    uint32_t GetFreePersistentCount() const;
+    uint32_t GetLargestFreePersistentRange() const;
+
+private:
+    struct Range
+    {
+        uint32_t mFirst;
+        uint32_t mCount;
+    };
+
+    struct PendingFree
+    {
+        Range mRange;
+        uint64_t mFenceValue;
+    };
+
+    void Release(const Range& range);
+
+    uint32_t mPersistentCount = 0;
+    uint32_t mTransientCount = 0;
+
+    std::vector<Range> mFreeRanges;                 // Sorted by first index, never adjacent
+    std::vector<Range> mFreedThisFrame;
+    std::vector<PendingFree> mPendingFrees;         // In fence order
+    FrameRingAllocator mTransient;
+};
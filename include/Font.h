@@ -0,0 +1,190 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// The bitmap font used for debug text. Glyphs are laid out in a grid in a texture atlas that is built at compile time, so
+// startup only has to copy it into an upload heap.
+namespace Font
+{
+    // The font is monochrome so the atlas only stores coverage in a single channel by default. Set this to false to get the
+    // white RGBA atlas instead. The text shader reads coverage from the red channel so it works with either.
+    constexpr bool SingleChannelAtlas = true;
+
+    constexpr uint32_t TextureWidth = 256;
+    constexpr uint32_t TextureHeight = 256;
+    constexpr uint32_t TexturePixelSize = SingleChannelAtlas ? 1 : 4;  // R8 or RGBA
+    constexpr uint32_t CharWidth = 8;
+    constexpr uint32_t CharHeight = 16;
+    constexpr uint32_t CharsPerRow = TextureWidth / CharWidth;
+    constexpr uint32_t FirstChar = 0;  // Space
+    constexpr uint32_t NumChars = 128;   // Basic ASCII set
+
+    constexpr size_t AtlasSize = TextureWidth * TextureHeight * TexturePixelSize;
+
+    // Dump of Sweet16mono.f8 from https://github.com/kmar/Sweet16Font
+    inline constexpr std::array<std::array<uint8_t, 16>, 128> fontData = {{
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x00,0x10,0x10,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x28,0x28,0x28,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x24,0x24,0x7E,0x24,0x24,0x24,0x7E,0x24,0x24,0x00,0x00,0x00,0x00},
+        {0x00,0x10,0x38,0x44,0x44,0x40,0x38,0x04,0x04,0x44,0x44,0x38,0x10,0x00,0x00,0x00},
+        {0x00,0x00,0x40,0xA0,0xA2,0x44,0x08,0x10,0x20,0x44,0x8A,0x0A,0x04,0x00,0x00,0x00},
+        {0x00,0x00,0x30,0x48,0x48,0x48,0x32,0x52,0x8C,0x84,0x8C,0x72,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x08,0x08,0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x08,0x10,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x10,0x08,0x00,0x00,0x00},
+        {0x00,0x00,0x20,0x10,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x10,0x20,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x24,0x18,0x7E,0x18,0x24,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x10,0x10,0x7C,0x10,0x10,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x08,0x08,0x10,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3C,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x10,0x10,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x04,0x04,0x08,0x08,0x10,0x10,0x20,0x20,0x40,0x40,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x3C,0x42,0x46,0x4A,0x4A,0x52,0x52,0x62,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x04,0x0C,0x14,0x24,0x04,0x04,0x04,0x04,0x04,0x04,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x3C,0x42,0x02,0x04,0x08,0x10,0x20,0x40,0x40,0x7E,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x3C,0x42,0x02,0x02,0x1C,0x02,0x02,0x02,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x04,0x0C,0x14,0x24,0x44,0x7E,0x04,0x04,0x04,0x04,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x7E,0x40,0x40,0x40,0x7C,0x02,0x02,0x02,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x1C,0x20,0x40,0x40,0x7C,0x42,0x42,0x42,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x7E,0x02,0x02,0x02,0x04,0x08,0x10,0x10,0x10,0x10,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x3C,0x42,0x42,0x42,0x3C,0x42,0x42,0x42,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x3C,0x42,0x42,0x42,0x3E,0x02,0x02,0x02,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x10,0x10,0x00,0x00,0x00,0x10,0x10,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x08,0x08,0x00,0x00,0x00,0x08,0x08,0x10,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x04,0x08,0x10,0x20,0x40,0x20,0x10,0x08,0x04,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x7E,0x00,0x7E,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x40,0x20,0x10,0x08,0x04,0x08,0x10,0x20,0x40,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x3C,0x42,0x42,0x02,0x04,0x08,0x10,0x00,0x10,0x10,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x3C,0x42,0x99,0x85,0x9D,0xA5,0x9E,0x40,0x3E,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x3C,0x42,0x42,0x42,0x42,0x7E,0x42,0x42,0x42,0x42,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x7C,0x42,0x42,0x42,0x7C,0x42,0x42,0x42,0x42,0x7C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x3C,0x42,0x40,0x40,0x40,0x40,0x40,0x40,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x78,0x44,0x42,0x42,0x42,0x42,0x42,0x42,0x44,0x78,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x7E,0x40,0x40,0x40,0x78,0x40,0x40,0x40,0x40,0x7E,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x7E,0x40,0x40,0x40,0x78,0x40,0x40,0x40,0x40,0x40,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x3C,0x42,0x40,0x40,0x40,0x4E,0x42,0x42,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x42,0x42,0x42,0x42,0x7E,0x42,0x42,0x42,0x42,0x42,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x7C,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x7C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x42,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x42,0x42,0x44,0x48,0x70,0x48,0x44,0x42,0x42,0x42,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x7E,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x82,0xC6,0xAA,0x92,0x92,0x82,0x82,0x82,0x82,0x82,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x42,0x62,0x52,0x4A,0x46,0x42,0x42,0x42,0x42,0x42,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x3C,0x42,0x42,0x42,0x42,0x42,0x42,0x42,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x7C,0x42,0x42,0x42,0x7C,0x40,0x40,0x40,0x40,0x40,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x3C,0x42,0x42,0x42,0x42,0x42,0x42,0x4A,0x46,0x3E,0x02,0x00,0x00,0x00},
+        {0x00,0x00,0x7C,0x42,0x42,0x42,0x7C,0x44,0x42,0x42,0x42,0x42,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x3C,0x42,0x40,0x20,0x18,0x04,0x02,0x02,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0xFE,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x42,0x42,0x42,0x42,0x42,0x42,0x42,0x42,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x82,0x82,0x82,0x82,0x44,0x44,0x28,0x28,0x10,0x10,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x82,0x82,0x82,0x82,0x92,0x92,0x92,0xAA,0xC6,0x82,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x42,0x42,0x42,0x24,0x18,0x18,0x24,0x42,0x42,0x42,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x82,0x82,0x44,0x44,0x28,0x10,0x10,0x10,0x10,0x10,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x7E,0x02,0x02,0x04,0x08,0x10,0x20,0x40,0x40,0x7E,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x38,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x38,0x00,0x00,0x00},
+        {0x00,0x00,0x40,0x40,0x20,0x20,0x10,0x10,0x08,0x08,0x04,0x04,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x38,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x38,0x00,0x00,0x00},
+        {0x00,0x10,0x28,0x44,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7E,0x00,0x00},
+        {0x00,0x00,0x10,0x10,0x08,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x3C,0x02,0x3E,0x42,0x42,0x42,0x3E,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x40,0x40,0x40,0x7C,0x42,0x42,0x42,0x42,0x42,0x7C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x3C,0x42,0x40,0x40,0x40,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x02,0x02,0x02,0x3E,0x42,0x42,0x42,0x42,0x42,0x3E,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x3C,0x42,0x42,0x7E,0x40,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x1C,0x22,0x20,0x20,0x78,0x20,0x20,0x20,0x20,0x20,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x3C,0x42,0x42,0x42,0x42,0x46,0x3A,0x02,0x42,0x3C,0x00},
+        {0x00,0x00,0x40,0x40,0x40,0x7C,0x42,0x42,0x42,0x42,0x42,0x42,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x10,0x00,0x70,0x10,0x10,0x10,0x10,0x10,0x7C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x04,0x00,0x04,0x04,0x04,0x04,0x04,0x04,0x04,0x44,0x44,0x38,0x00},
+        {0x00,0x00,0x40,0x40,0x40,0x42,0x42,0x44,0x78,0x44,0x42,0x42,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x70,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x7C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0xEC,0x92,0x92,0x92,0x92,0x92,0x82,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x7C,0x42,0x42,0x42,0x42,0x42,0x42,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x3C,0x42,0x42,0x42,0x42,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x7C,0x42,0x42,0x42,0x42,0x42,0x7C,0x40,0x40,0x40,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x3E,0x42,0x42,0x42,0x42,0x42,0x3E,0x02,0x02,0x02,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x5C,0x60,0x40,0x40,0x40,0x40,0x40,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x3C,0x42,0x40,0x3C,0x02,0x42,0x3C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x10,0x10,0x7C,0x10,0x10,0x10,0x10,0x10,0x0C,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x42,0x42,0x42,0x42,0x42,0x42,0x3E,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x82,0x82,0x44,0x44,0x28,0x28,0x10,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x82,0x82,0x92,0x92,0x92,0xAA,0x44,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x82,0x44,0x28,0x10,0x28,0x44,0x82,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x42,0x42,0x42,0x42,0x42,0x46,0x3A,0x02,0x04,0x78,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x7E,0x04,0x08,0x10,0x20,0x40,0x7E,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x0C,0x10,0x10,0x10,0x10,0x60,0x10,0x10,0x10,0x10,0x0C,0x00,0x00,0x00},
+        {0x00,0x00,0x10,0x10,0x10,0x10,0x00,0x10,0x10,0x10,0x10,0x10,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x60,0x10,0x10,0x10,0x10,0x0C,0x10,0x10,0x10,0x10,0x60,0x00,0x00,0x00},
+        {0x00,0x00,0x32,0x4C,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}
+    }};
+
+    // Expands every glyph into its cell of the atlas. Set pixels are white and opaque, everything else is transparent.
+    constexpr std::array<uint8_t, AtlasSize> BuildAtlas()
+    {
+        std::array<uint8_t, AtlasSize> data = {};
+
+        for (uint32_t charIndex = 0; charIndex < NumChars; ++charIndex)
+        {
+            const uint32_t gridX = charIndex % CharsPerRow;
+            const uint32_t gridY = charIndex / CharsPerRow;
+
+            for (uint32_t y = 0; y < CharHeight; ++y)
+            {
+                const uint8_t row = fontData[charIndex][y];
+                const size_t rowStart = ((gridY * CharHeight + y) * TextureWidth + gridX * CharWidth) * TexturePixelSize;
+
+                for (uint32_t x = 0; x < CharWidth; ++x)
+                {
+                    const uint8_t value = (row & (1 << (CharWidth - 1 - x))) != 0 ? 0xFF : 0x00;
+                    for (uint32_t channel = 0; channel < TexturePixelSize; ++channel)
+                    {
+                        data[rowStart + x * TexturePixelSize + channel] = value;
+                    }
+                }
+            }
+        }
+
+        return data;
+    }
+
+    // The atlas built by BuildAtlas, evaluated by the compiler so it lives in read only data
+    extern const std::array<uint8_t, AtlasSize> Atlas;
+
+    void GetCharacterUVs(char c, float& u1, float& v1, float& u2, float& v2);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Bookkeeping for a ring buffer of per frame transient data such as vertices and constants. It only hands out offsets, the
+// memory itself belongs to whoever owns the allocator (see UploadRing in D3D12Backend.cpp).
+//
+// Allocations are linear. At the end of a frame, EndFrame tags everything allocated so far with the fence value the GPU
+// will signal once it is done with the frame. Retire is then given the last completed fence value and releases the space
+// of all frames up to it. An allocation that doesn't fit before the end of the buffer wraps around to the start.
+class FrameRingAllocator
+{
+public:
+    static constexpr uint64_t InvalidOffset = ~0ull;
+    static constexpr uint32_t MaxFramesInFlight = 8;
+
+    void Initialize(uint64_t capacity);
+
+    // alignment has to be a power of two. Returns InvalidOffset if the frames in flight don't leave enough space.
+    uint64_t Allocate(uint64_t size, uint64_t alignment);
+
+    void EndFrame(uint64_t fenceValue);
+    void Retire(uint64_t completedFenceValue);
+
+    uint64_t GetCapacity() const { return mCapacity; }
+    uint64_t GetUsed() const { return mHead - mTail; }
+    uint64_t GetHighWaterMark() const { return mHighWaterMark; }
+
+private:
+    struct Frame
+    {
+        uint64_t mFenceValue;
+        uint64_t mEnd;
+    };
+
+    // mHead and mTail only ever grow. The position in the buffer is the value modulo the capacity. Space skipped when an
+    // allocation wraps around counts as allocated, so that it is released along with the frame that skipped it.
+    uint64_t mCapacity = 0;
+    uint64_t mHead = 0;
+    uint64_t mTail = 0;
+    uint64_t mHighWaterMark = 0;
+
+    std::array<Frame, MaxFramesInFlight> mFrames = {};
+    uint32_t mFirstFrame = 0;
+    uint32_t mFrameCount = 0;
+};
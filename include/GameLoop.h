@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Runs the simulation at a fixed rate however fast frames are drawn. Real time is added to an accumulator every frame and
+// taken out one step at a time, so a fast display runs no step in some frames and a slow one runs several. What is left
+// over is how far the next step has already progressed, which is what the render state is interpolated by.
+class FixedTimestep
+{
+public:
+    // A frame never runs more than maxStepsPerFrame steps. Time beyond that is dropped and the game slows down instead of
+    // falling further and further behind, e.g. after a hitch or a breakpoint.
+    explicit FixedTimestep(double stepSeconds = 1.0 / 60.0, uint32_t maxStepsPerFrame = 5);
+
+    // Adds the real time since the last frame and returns how many steps to simulate this frame
+    uint32_t Advance(double elapsedSeconds);
+
+    double GetStep() const { return mStep; }
+
+    // How far past the last step the frame is, in [0, 1). Render the previous state blended towards the current one by this.
+    double GetAlpha() const { return mAccumulator / mStep; }
+
+    uint64_t GetStepCount() const { return mStepCount; }
+    double GetDroppedTime() const { return mDroppedTime; }
+
+private:
+    double mStep;
+    uint32_t mMaxStepsPerFrame;
+
+    double mAccumulator = 0.0;
+    uint64_t mStepCount = 0;
+    double mDroppedTime = 0.0;      // Seconds thrown away by the catch up limit
+
+    // Frames in a row that dropped time and what they dropped, for logging when the simulation falls behind and catches up
+    uint32_t mBehindFrames = 0;
+    double mBehindDroppedTime = 0.0;
+};
+
+template <typename T>
+T Interpolate(const T& previous, const T& current, double alpha)
+{
+    return static_cast<T>(previous + (current - previous) * alpha);
+}
+
+// The phases every frame of the game loop is split into
+enum FramePhase : uint32_t
+{
+    UpdatePhase,        // Simulation steps and everything else the game does on the CPU before drawing
+    RenderPhase,        // Renderer::Render, apart from waiting
+    WaitPhase,          // Waiting for the GPU to free a frame and for Present to return, which is where vsync throttles
+    FramePhaseCount
+};
+
+// Keeps the phase times of the last frames and checks the work of every frame against a budget. Waiting doesn't count
+// against the budget, since a frame that is done early spends the rest of it waiting for the display.
+class FrameBudget
+{
+public:
+    static constexpr uint32_t HistorySize = 120;
+
+    explicit FrameBudget(double budgetMilliseconds = 1000.0 / 60.0);
+
+    // Times are in milliseconds
+    void EndFrame(const std::array<double, FramePhaseCount>& phaseTimes);
+
+    double GetBudget() const { return mBudget; }
+
+    // Over the frames in the history
+    double GetAverage(FramePhase phase) const;
+    double GetMax(FramePhase phase) const;
+    double GetAverageFrame() const;
+
+    // Frames whose update and render took longer than the budget, since the start
+    uint64_t GetOverBudgetCount() const { return mOverBudgetCount; }
+    uint64_t GetFrameCount() const { return mFrameCount; }
+
+private:
+    double mBudget;
+
+    std::array<std::array<double, FramePhaseCount>, HistorySize> mHistory = {};
+    uint64_t mFrameCount = 0;
+    uint64_t mOverBudgetCount = 0;
+};
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Counts the jobs and tasks that were started with it and haven't finished yet. Wait on it to join them, or co_await it
+// from a task. A counter can be reused once it is done.
+class JobCounter
+{
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool IsDone() const { return mState.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    // The count is in the low bits. WaitersBit is set while tasks are suspended on the counter, and only cleared once
+    // the last job has handed them back to the job system, so the counter isn't done while that still touches it.
+    static constexpr uint64_t CountMask = 0xFFFFFFFF;
+    static constexpr uint64_t WaitersBit = 1ull << 32;
+
+    std::atomic<uint64_t> mState{ 0 };
+    std::mutex mWaitersMutex;
+    std::vector<std::coroutine_handle<>> mWaiters;
+};
+
+// A fixed pool of worker threads for short CPU jobs. Every pool thread, the one that called Start included, has its own
+// Chase-Lev deque: it pushes and pops jobs at the bottom without locking, and threads that run out of work steal from the
+// top of the others. Jobs started from threads outside the pool, like the asset streamer's, go through a locked queue
+// that everyone takes from as well.
+//
+// Waiting on a counter runs other jobs until the counter is done instead of blocking, so jobs can start more jobs and wait
+// for them without tying up a thread.
+class JobSystem
+{
+public:
+    using JobFunction = std::function<void()>;
+
+    static JobSystem& Get();
+
+    // workerCount threads besides the calling one, which becomes part of the pool. With none, jobs run when waited on.
+    void Start(uint32_t workerCount);
+
+    // Jobs that haven't run yet are run on the calling thread before it returns
+    void Stop();
+
+    // The workers and the thread that called Start
+    uint32_t GetThreadCount() const { return static_cast<uint32_t>(mThreads.size()) + 1; }
+
+    // counter, if there is one, has to stay alive until it is done
+    void Run(JobFunction function, JobCounter* counter = nullptr);
+    void Wait(JobCounter& counter);
+
+    // Queues a suspended coroutine to be resumed by whichever thread gets to it first
+    void Resume(std::coroutine_handle<> coroutine);
+
+    // Counts work that isn't a job against a counter, like a task. Every AddWork needs one FinishWork.
+    void AddWork(JobCounter& counter);
+    void FinishWork(JobCounter& counter);
+
+    // Suspends coroutine until counter is done. Returns false without suspending if it already is.
+    bool AddWaiter(JobCounter& counter, std::coroutine_handle<> coroutine);
+
+    // Calls body(begin, end) for ranges of at most grainSize indices covering [0, count) and returns once all of them
+    // have. The calling thread takes the first range.
+    template <typename Body>
+    void ParallelFor(uint32_t count, uint32_t grainSize, const Body& body);
+
+    // Picks a grain size that gives every thread a few ranges to balance over
+    template <typename Body>
+    void ParallelFor(uint32_t count, const Body& body)
+    {
+        ParallelFor(count, std::max(count / (GetThreadCount() * 4), 1u), body);
+    }
+
+private:
+    // The tests drive the work queue directly
+    friend class JobSystemTests;
+
+    // Either a function or a coroutine to resume
+    struct Job
+    {
+        JobFunction mFunction;
+        std::coroutine_handle<> mCoroutine;
+        JobCounter* mCounter = nullptr;
+        int32_t mOwner = -1;            // Pool thread that allocated the job, or -1 for other threads
+    };
+
+    // Chase-Lev deque with a fixed capacity. Only the owning thread calls Push and Pop, any thread can Steal.
+    class WorkQueue
+    {
+    public:
+        static constexpr int64_t Capacity = 4096;
+
+        // Returns false if the queue is full
+        bool Push(Job* job);
+        Job* Pop();
+        Job* Steal();
+
+    private:
+        // Top and bottom on their own cache lines so stealing doesn't slow down the owner
+        alignas(64) std::atomic<int64_t> mTop{ 0 };
+        alignas(64) std::atomic<int64_t> mBottom{ 0 };
+        alignas(64) std::array<std::atomic<Job*>, Capacity> mJobs = {};
+    };
+
+    // Every pool thread reuses the jobs it allocated. Jobs that finish on another thread are handed back through
+    // mReturnedJobs and only picked up once mFreeJobs runs out, so the lock is rarely taken by the owner.
+    struct ThreadState
+    {
+        WorkQueue mQueue;
+        std::vector<Job*> mFreeJobs;
+
+        std::mutex mReturnedMutex;
+        std::vector<Job*> mReturnedJobs;
+    };
+
+    JobSystem() = default;
+    ~JobSystem();
+
+    void RunWorker(uint32_t threadIndex);
+
+    Job* AllocateJob();
+    void FreeJob(Job* job);
+    void Queue(Job* job);
+
+    // Looks in the thread's own queue, then the shared one, then steals from the others
+    Job* FindJob();
+    void Execute(Job* job);
+
+    std::vector<std::unique_ptr<ThreadState>> mThreadStates;
+    std::vector<std::thread> mThreads;
+    std::atomic<bool> mRunning{ false };
+
+    // Jobs that are queued and not taken yet, so idle workers know when to sleep
+    std::atomic<int64_t> mQueuedJobs{ 0 };
+    std::atomic<uint32_t> mSleepingWorkers{ 0 };
+    std::mutex mWakeMutex;
+    std::condition_variable mWakeCondition;
+
+    // Jobs from threads outside the pool
+    std::mutex mSharedMutex;
+    std::deque<Job*> mSharedQueue;
+};
+
+template <typename Body>
+void JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, const Body& body)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    grainSize = std::max(grainSize, 1u);
+    JobCounter counter;
+    for (uint32_t begin = grainSize; begin < count; begin += grainSize)
+    {
+        const uint32_t end = count - begin > grainSize ? begin + grainSize : count;
+        Run([&body, begin, end] { body(begin, end); }, &counter);
+    }
+
+    body(0u, std::min(grainSize, count));
+    Wait(counter);
+}
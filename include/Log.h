@@ -1,36 +1,310 @@
 #pragma once
 
+#include <LogFormat.h>
+
 #include <array>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
+
+// Messages below this level are compiled out entirely. Everything is compiled in by default and filtered at runtime instead.
+#if !defined(LOG_COMPILED_LEVEL)
+#define LOG_COMPILED_LEVEL 0
+#endif
+
+// Each LOG call site describes itself once in a static LogSite and registers it with the logger the first time it runs.
+// After that a message only needs the site id and the argument bytes. The arguments are not evaluated to build the site,
+// and not evaluated at all if the level and category are filtered out.
+#define LOG_AT(level, category, format, ...) \
+    do \
+    { \
+        if constexpr (IsLogLevelCompiled(LogLevel::level)) \
+        { \
+            if (Logger::IsEnabled(LogLevel::level, LogCategory::category)) \
+            { \
+                using LogSiteArgs = decltype(LogArgTypes(__VA_ARGS__)); \
+                static constexpr LogSite logSite = { __FILE__, __LINE__, format, LogSiteArgs::Types, LogSiteArgs::Count, LogLevel::level, LogCategory::category }; \
+                static const uint16_t logSiteId = Logger::Get().RegisterSite(logSite); \
+                Logger::Get().Log(logSiteId, std::chrono::high_resolution_clock::now().time_since_epoch().count(), ##__VA_ARGS__); \
+            } \
+        } \
+    } while (false)
+
+#define LOG_TRACE(category, format, ...) LOG_AT(Trace, category, format, ##__VA_ARGS__)
+#define LOG_DEBUG(category, format, ...) LOG_AT(Debug, category, format, ##__VA_ARGS__)
+#define LOG_INFO(category, format, ...) LOG_AT(Info, category, format, ##__VA_ARGS__)
+#define LOG_WARN(category, format, ...) LOG_AT(Warn, category, format, ##__VA_ARGS__)
+#define LOG_ERROR(category, format, ...) LOG_AT(Error, category, format, ##__VA_ARGS__)
+
+#define LOGGER_FLUSH() Logger::Get().Flush()
+
+enum class LogLevel : uint8_t
+{
+    Trace,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Count
+};
+
+// One per subsystem. The runtime filter has a byte per category so there can be at most 8 of these.
+enum class LogCategory : uint8_t
+{
+    General,
+    Application,
+    Window,
+    Renderer,
+    Assets,
+    Jobs,
+    Count
+};
+
+static_assert(static_cast<int>(LogLevel::Count) <= 8, "Each category gets 8 bits in the filter mask");
+static_assert(static_cast<int>(LogCategory::Count) <= 8, "The filter mask only has room for 8 categories");
+
+constexpr const char* GetLogLevelName(LogLevel level)
+{
+    constexpr const char* names[] = { "Trace", "Debug", "Info", "Warn", "Error" };
+    return level < LogLevel::Count ? names[static_cast<int>(level)] : "?";
+}
+
+constexpr const char* GetLogCategoryName(LogCategory category)
+{
+    constexpr const char* names[] = { "General", "Application", "Window", "Renderer", "Assets", "Jobs" };
+    return category < LogCategory::Count ? names[static_cast<int>(category)] : "?";
+}
+
+// Compares as levels rather than as integers, which gcc warns is always true for the default of 0
+constexpr bool IsLogLevelCompiled(LogLevel level)
+{
+    return level >= static_cast<LogLevel>(LOG_COMPILED_LEVEL);
+}
 
-#define LOG(format, ...) Logger::Get().Log(__FILE__, __LINE__, std::chrono::high_resolution_clock::now().time_since_epoch().count(), 0, format, ##__VA_ARGS__)
-#define LOGGER_FLUSH() Logger::Get().ProcessQueue()
+// Static description of a LOG call site
+struct LogSite
+{
+    const char* mFile;
+    int mLine;
+    const char* mFormat;
+    const LogArgType* mSignature;
+    size_t mArgCount;
+    LogLevel mLevel;
+    LogCategory mCategory;
+};
+
+// A single log record. The arguments are stored as raw bytes (see LogArgEncoder) so that logging a message never formats
+// a string or touches the heap on the calling thread. Everything that is the same for every message from a call site lives
+// in its LogSite. This has to stay trivially copyable because the consumer copies records out of the ring with memcpy.
+struct LogMessage
+{
+    static constexpr size_t MaxPayloadSize = 240;
+
+    uint64_t mTimestamp;
+    uint16_t mSiteId;
+    uint16_t mPayloadSize;
+    uint32_t mThreadId;
+    std::array<uint8_t, MaxPayloadSize> mPayload;
+};
+
+// Where messages go once the logger thread has pulled them out of the rings. Sinks are only ever called from the thread
+// that is processing the queue.
+class LogSink
+{
+public:
+    virtual ~LogSink() = default;
 
-class LogMessage;
+    virtual void Write(const LogSite& site, const LogMessage& message) = 0;
 
-// Logger is a singleton that writes to a file and a stdout.
+    // Called once after each batch of messages
+    virtual void Flush() {}
+};
+
+// What a producer does when its ring is full. None of these wait on the consumer indefinitely.
+enum class LogOverflowPolicy
+{
+    Drop,               // Discard the new message and count it
+    Block,              // Wait for the consumer up to the block timeout, then drop
+    OverwriteOldest,    // Discard the oldest unread message to make room
+};
+
+struct LogStats
+{
+    uint64_t mDropped;          // Messages lost to the overflow policy, summed over all threads
+    uint32_t mHighWaterMark;    // Highest occupancy seen in any single ring
+    uint32_t mThreadCount;      // Number of threads that have logged at least once
+};
+
+// Single producer, single consumer ring of log messages. Every thread that logs gets its own ring the first time it logs
+// so producers never contend with each other. The read and write counters live on separate cache lines so the producer
+// and the logger thread don't fight over them either.
+class alignas(64) LogRing
+{
+public:
+    static constexpr uint32_t Capacity = 512;
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    explicit LogRing(uint32_t threadIndex);
+
+    // Producer side. EndWrite returns the number of unread messages.
+    LogMessage* TryBeginWrite();
+    uint32_t EndWrite();
+    bool DropOldest();
+    void CountDropped() { mDropped.store(mDropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+    // Consumer side. Returns false if the ring is empty.
+    bool TryRead(LogMessage& message);
+    bool IsEmpty() const { return mRead.load(std::memory_order_acquire) == mWrite.load(std::memory_order_acquire); }
+
+    uint32_t GetThreadIndex() const { return mThreadIndex; }
+    uint64_t GetDropped() const { return mDropped.load(std::memory_order_relaxed); }
+    uint32_t GetHighWaterMark() const { return mHighWaterMark.load(std::memory_order_relaxed); }
+
+private:
+    alignas(64) std::atomic<uint64_t> mWrite;
+    std::atomic<uint64_t> mDropped;
+    std::atomic<uint32_t> mHighWaterMark;
+    uint32_t mThreadIndex;
+
+    alignas(64) std::atomic<uint64_t> mRead;
+
+    alignas(64) std::array<LogMessage, Capacity> mMessages;
+};
+
+// Logger is a singleton that collects messages from every thread and hands them to its sinks.
 // Goals:
 //    - Thread safe and lock free
 //    - Does not allocate memory
-//    - Queue processing done on a separate thread
+//    - Queue processing done on a separate thread that only wakes up when there is something to do
 //    - Format strings are processesed offline to improve runtime performance
 class Logger
 {
 public:
+    static constexpr uint32_t MaxThreads = 64;
+    static constexpr uint16_t MaxSites = 4096;
+    static constexpr uint16_t InvalidSiteId = 0xFFFF;
+
+    // A ring filling up to this point wakes the logger thread right away instead of waiting for the next flush interval
+    static constexpr uint32_t WakeThreshold = LogRing::Capacity / 2;
+
     static Logger& Get();
 
-    void Log(std::string_view file, int line, uint64_t timestamp, uint64_t threadId, std::string_view format, ...);
-    void ProcessQueue();
+    // Checked before a message's arguments are evaluated, so this needs to stay a single relaxed load
+    static bool IsEnabled(LogLevel level, LogCategory category)
+    {
+        const uint32_t bit = static_cast<uint32_t>(category) * 8 + static_cast<uint32_t>(level);
+        return (mFilterMask.load(std::memory_order_relaxed) >> bit) & 1;
+    }
+
+    // Enables messages at or above minLevel for one category or for all of them
+    static void SetLevel(LogCategory category, LogLevel minLevel);
+    static void SetLevel(LogLevel minLevel);
+    static void SetFilterMask(uint64_t mask) { mFilterMask.store(mask, std::memory_order_relaxed); }
+    static uint64_t GetFilterMask() { return mFilterMask.load(std::memory_order_relaxed); }
+
+    // The site must outlive the logger since only a pointer to it is stored. The LOG macro uses a static for this.
+    uint16_t RegisterSite(const LogSite& site);
+    const LogSite* GetSite(uint16_t siteId) const;
+
+    template <typename... Args>
+    void Log(uint16_t siteId, uint64_t timestamp, const Args&... args)
+    {
+        if (siteId == InvalidSiteId)
+        {
+            return;
+        }
+
+        LogRing* ring = mThreadRing != nullptr ? mThreadRing : RegisterThread();
+        LogMessage* message = ring != nullptr ? AcquireMessage(*ring) : nullptr;
+        if (message == nullptr)
+        {
+            return;
+        }
+
+        message->mTimestamp = timestamp;
+        message->mSiteId = siteId;
+        message->mThreadId = ring->GetThreadIndex();
+
+        LogArgEncoder encoder(message->mPayload.data(), message->mPayload.size());
+        (encoder.Encode(args), ...);
+        message->mPayloadSize = static_cast<uint16_t>(encoder.GetSize());
+
+        const uint32_t used = ring->EndWrite();
+
+        // Pairs with the fence in Run so that either the logger thread sees this message before going to sleep or we see
+        // that it is asleep and wake it up
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (used == WakeThreshold || mConsumerSleeping.load(std::memory_order_relaxed))
+        {
+            Wake();
+        }
+    }
+
+    // Starts the logger thread. Messages are written in batches at most flushInterval after they are logged, sooner if a
+    // thread logs a lot. The thread sleeps without a timeout while nothing is being logged.
+    void Start(std::chrono::milliseconds flushInterval = std::chrono::milliseconds(50));
+
+    // Stops the logger thread after writing out everything that has been logged so far
+    void Stop();
+
+    // Drains every thread's ring in timestamp order and returns the number of messages written. Only one thread drains at a time.
+    size_t ProcessQueue();
+
+    // Drains the queue from a thread other than the logger thread, e.g. right before crashing. Gives up if the logger
+    // thread doesn't let go of the queue in time so that this can't hang a crashing program. The crash handler calls this
+    // too, which is best effort since none of it is async-signal-safe.
+    void Flush();
+
+    void AddSink(std::unique_ptr<LogSink> sink);
+
+    void SetOverflowPolicy(LogOverflowPolicy policy, std::chrono::microseconds blockTimeout = std::chrono::microseconds(1000));
+    LogStats GetStats() const;
 
 private:
     Logger();
-    FILE* mFile;
-    thread_local static std::array<LogMessage, 512> mMessagePool;
-    thread_local static size_t mMessagePoolIndex;
-    std::atomic<LogMessage*> mHead;
-    LogMessage* mTail;
+
+    // One bit per level per category. Info and above are enabled by default.
+    static inline std::atomic<uint64_t> mFilterMask { 0xFCFCFCFCFCFCFCFCull };
+
+    ~Logger();
+
+    LogRing* RegisterThread();
+    LogMessage* AcquireMessage(LogRing& ring);
+    void Wake();
+    void Run();
+    bool HasUnreadMessages() const;
+    size_t ProcessQueueLocked();
+    void Write(const LogMessage& message);
+
+    std::array<std::atomic<const LogSite*>, MaxSites> mSites;
+    std::atomic<uint16_t> mSiteCount;
+
+    thread_local static LogRing* mThreadRing;
+    std::array<std::atomic<LogRing*>, MaxThreads> mRings;
+    std::atomic<uint32_t> mRingCount;
+    std::atomic<uint64_t> mUnregisteredDropped;
+
+    std::atomic<LogOverflowPolicy> mOverflowPolicy;
+    std::atomic<int64_t> mBlockTimeoutUs;
+
+    std::thread mThread;
+    std::chrono::milliseconds mFlushInterval;
+    std::mutex mWakeMutex;
+    std::condition_variable mWakeCondition;
+    bool mWakeRequested;
+    bool mStopRequested;
+    std::atomic<bool> mConsumerSleeping;
+
+    // Only the consumer touches these. A message that has been read out of a ring but not written yet because an older
+    // message might still be waiting in another ring.
+    std::timed_mutex mConsumerMutex;
+    std::array<LogMessage, MaxThreads> mPending;
+    std::array<bool, MaxThreads> mHasPending;
+    std::vector<std::unique_ptr<LogSink>> mSinks;
 };
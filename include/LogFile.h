@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Layout of the binary log files written by BinaryLogFileSink and read by the LogDecoder tool.
+//
+// The file is created at its full size up front and is made of a header page followed by a fixed number of equally sized
+// chunks. Chunks are filled one after another and reused oldest first once the file is full, so the file never grows.
+// The header keeps a small index with the sequence number and fill level of every chunk so a reader can put them back
+// in order.
+//
+// A chunk is a list of records. Every chunk is self contained: the first time a call site is used in a chunk, a site
+// record with its file, line, format string and argument signature is written before the message that uses it.
+namespace LogFile
+{
+    constexpr uint32_t Magic = 0x474F4C42; // "BLOG"
+    constexpr uint32_t Version = 2;
+    constexpr uint32_t HeaderSize = 4096;
+    constexpr uint32_t MaxChunks = 128;
+    constexpr uint32_t RecordAlignment = 8;
+
+    struct ChunkInfo
+    {
+        uint64_t mSequence;         // 0 if the chunk has never been written
+        uint64_t mFirstTimestamp;
+        uint32_t mUsedBytes;
+        uint32_t mReserved;
+    };
+
+    struct Header
+    {
+        uint32_t mMagic;
+        uint32_t mVersion;
+        uint32_t mChunkSize;
+        uint32_t mChunkCount;
+        uint64_t mTicksPerSecond;   // Resolution of the message timestamps
+        ChunkInfo mChunks[MaxChunks];
+    };
+
+    static_assert(sizeof(Header) <= HeaderSize, "The header has to fit in the header page");
+
+    enum class RecordType : uint8_t
+    {
+        Site = 1,
+        Message = 2,
+    };
+
+    // Common to all records. mSize is the size of the whole record including this header, padded to RecordAlignment.
+    struct RecordHeader
+    {
+        RecordType mType;
+        uint8_t mReserved;
+        uint16_t mSize;
+    };
+
+    // Followed by mArgCount LogArgType bytes, then mFileLength characters of the file name and mFormatLength characters of
+    // the format string. The strings are not null terminated.
+    struct SiteRecord
+    {
+        RecordHeader mHeader;
+        uint16_t mSiteId;
+        uint16_t mArgCount;
+        uint32_t mLine;
+        uint16_t mFileLength;
+        uint16_t mFormatLength;
+        uint8_t mLevel;             // LogLevel
+        uint8_t mCategory;          // LogCategory
+        uint16_t mReserved;
+    };
+
+    // Followed by mPayloadSize bytes of arguments encoded by LogArgEncoder
+    struct MessageRecord
+    {
+        RecordHeader mHeader;
+        uint16_t mSiteId;
+        uint16_t mPayloadSize;
+        uint64_t mTimestamp;
+        uint32_t mThreadId;
+        uint32_t mReserved;
+    };
+
+    constexpr uint32_t AlignRecordSize(size_t size)
+    {
+        return static_cast<uint32_t>((size + RecordAlignment - 1) & ~static_cast<size_t>(RecordAlignment - 1));
+    }
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Log arguments are not formatted on the thread that logs them. Instead, each argument is written into the message payload
+// as raw bytes. The types of the arguments are known at compile time so they are stored once per call site (see LogSite)
+// rather than in every message. The payload is turned into text later by FormatLogMessage, either on the logger thread
+// or by an offline tool.
+enum class LogArgType : uint8_t
+{
+    Int,        // int64_t
+    UInt,       // uint64_t
+    Double,     // double
+    Pointer,    // uint64_t
+    String,     // uint16_t length followed by the characters, not null terminated
+};
+
+template <typename T>
+constexpr LogArgType GetLogArgType()
+{
+    using Type = std::decay_t<T>;
+
+    if constexpr (std::is_same_v<Type, bool>)
+    {
+        return LogArgType::Int;
+    }
+    else if constexpr (std::is_enum_v<Type>)
+    {
+        return GetLogArgType<std::underlying_type_t<Type>>();
+    }
+    else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+    {
+        return LogArgType::Int;
+    }
+    else if constexpr (std::is_integral_v<Type>)
+    {
+        return LogArgType::UInt;
+    }
+    else if constexpr (std::is_floating_point_v<Type>)
+    {
+        return LogArgType::Double;
+    }
+    else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*> ||
+                       std::is_same_v<Type, std::string_view> || std::is_same_v<Type, std::string>)
+    {
+        return LogArgType::String;
+    }
+    else if constexpr (std::is_pointer_v<Type>)
+    {
+        return LogArgType::Pointer;
+    }
+    else
+    {
+        static_assert(sizeof(Type) == 0, "Unsupported log argument type");
+        return LogArgType::Int;
+    }
+}
+
+// The argument type signature of a call site, built entirely at compile time
+template <typename... Args>
+struct LogArgTypeList
+{
+    static constexpr size_t Count = sizeof...(Args);
+    static constexpr LogArgType Types[Count > 0 ? Count : 1] = { GetLogArgType<Args>()... };
+};
+
+// Only used inside decltype to get the argument types of a LOG call without evaluating the arguments
+template <typename... Args>
+LogArgTypeList<std::decay_t<Args>...> LogArgTypes(const Args&...);
+
+class LogArgEncoder
+{
+public:
+    LogArgEncoder(uint8_t* buffer, size_t capacity)
+        : mBuffer(buffer)
+        , mCapacity(capacity)
+        , mSize(0)
+    {
+    }
+
+    template <typename T>
+    void Encode(const T& value)
+    {
+        using Type = std::decay_t<T>;
+        constexpr LogArgType type = GetLogArgType<Type>();
+
+        if constexpr (type == LogArgType::String)
+        {
+            if constexpr (std::is_array_v<T>)
+            {
+                WriteString(std::string_view(value));
+            }
+            else if constexpr (std::is_pointer_v<Type>)
+            {
+                WriteString(value != nullptr ? std::string_view(value) : std::string_view("(null)"));
+            }
+            else
+            {
+                WriteString(value);
+            }
+        }
+        else if constexpr (type == LogArgType::Pointer)
+        {
+            Write(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)));
+        }
+        else if constexpr (std::is_enum_v<Type>)
+        {
+            Encode(static_cast<std::underlying_type_t<Type>>(value));
+        }
+        else if constexpr (type == LogArgType::Int)
+        {
+            Write(static_cast<int64_t>(value));
+        }
+        else if constexpr (type == LogArgType::UInt)
+        {
+            Write(static_cast<uint64_t>(value));
+        }
+        else
+        {
+            Write(static_cast<double>(value));
+        }
+    }
+
+    size_t GetSize() const { return mSize; }
+
+private:
+    template <typename T>
+    void Write(T value)
+    {
+        // Once an argument doesn't fit, nothing after it is written either so the decoder doesn't misinterpret the payload
+        if (mSize + sizeof(T) > mCapacity)
+        {
+            mSize = mCapacity;
+            return;
+        }
+
+        memcpy(mBuffer + mSize, &value, sizeof(T));
+        mSize += sizeof(T);
+    }
+
+    void WriteString(std::string_view value)
+    {
+        // Strings are truncated to whatever fits in the payload rather than dropping the argument entirely
+        if (mSize + sizeof(uint16_t) > mCapacity)
+        {
+            mSize = mCapacity;
+            return;
+        }
+
+        const size_t available = mCapacity - mSize - sizeof(uint16_t);
+        const uint16_t length = static_cast<uint16_t>(value.size() < available ? value.size() : available);
+
+        memcpy(mBuffer + mSize, &length, sizeof(length));
+        mSize += sizeof(length);
+        memcpy(mBuffer + mSize, value.data(), length);
+        mSize += length;
+    }
+
+    uint8_t* mBuffer;
+    size_t mCapacity;
+    size_t mSize;
+};
+
+// Expands a printf style format string using arguments encoded by LogArgEncoder. Length modifiers in the format string are
+// ignored because the signature tells us the real argument types. Returns the number of characters written, not including
+// the null terminator.
+size_t FormatLogMessage(char* buffer, size_t bufferSize, const char* format, const LogArgType* signature, size_t argCount,
+                        const uint8_t* payload, size_t payloadSize);
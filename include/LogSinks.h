@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Log.h>
+#include <LogFile.h>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+// Appends binary records to a memory mapped, pre-sized ring of file chunks. Writing a message is a memcpy into the mapping
+// so there are no system calls while the game is running. Use the LogDecoder tool to turn the file back into text.
+class BinaryLogFileSink : public LogSink
+{
+public:
+    BinaryLogFileSink(const char* path, uint32_t chunkSize = 1024 * 1024, uint32_t chunkCount = 8);
+    ~BinaryLogFileSink() override;
+
+    void Write(const LogSite& site, const LogMessage& message) override;
+    void Flush() override;
+
+private:
+    bool Map(const char* path, size_t size);
+    void Unmap();
+
+    uint32_t GetSiteRecordSize(const LogSite& site) const;
+    void NextChunk();
+    uint8_t* Append(uint32_t size);
+    void WriteSite(uint16_t siteId, const LogSite& site);
+
+    uint8_t* mData;
+    size_t mSize;
+    LogFile::Header* mHeader;
+
+    uint32_t mChunkSize;
+    uint32_t mChunkCount;
+    uint32_t mCurrentChunk;
+    uint64_t mSequence;
+
+    // The chunk sequence number each site was last described in. Sites are described again in every chunk they are used in.
+    std::vector<uint64_t> mSiteSequence;
+
+#if defined(_WIN32)
+    void* mFileHandle;
+    void* mMappingHandle;
+#endif
+};
+
+// Formats messages as text and writes them to stdout. Limited to a number of lines per second so that a log storm can't
+// turn into a console storm. Suppressed lines are counted and reported once output resumes.
+class ConsoleLogSink : public LogSink
+{
+public:
+    explicit ConsoleLogSink(uint32_t maxLinesPerSecond = 200);
+
+    void Write(const LogSite& site, const LogMessage& message) override;
+    void Flush() override;
+
+private:
+    uint32_t mMaxLinesPerSecond;
+    uint32_t mLinesThisSecond;
+    uint64_t mSuppressed;
+    std::chrono::steady_clock::time_point mSecondStart;
+};
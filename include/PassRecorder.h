@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Records the passes of a frame in parallel. Every pass is a function that records into its own command list, which is
+// looked up by the pass index it is called with. Execute hands the passes out to a few worker threads and the calling
+// thread, and returns once all of them are recorded. Passes finish in any order, the caller submits their command lists
+// by pass index so the GPU still sees them in the order they were added.
+//
+// This doesn't know about any graphics API, so the splitting and ordering can be run anywhere with passes that record
+// into plain buffers.
+class PassRecorder
+{
+public:
+    using RecordFunction = std::function<void(uint32_t passIndex)>;
+
+    PassRecorder() = default;
+    ~PassRecorder();
+
+    PassRecorder(const PassRecorder&) = delete;
+    PassRecorder& operator=(const PassRecorder&) = delete;
+
+    // workerCount threads besides the one calling Execute. With none, passes are recorded one after the other.
+    void Start(uint32_t workerCount);
+    void Stop();
+
+    // Passes stay added until Clear, so a renderer with a fixed set of passes only adds them once
+    uint32_t AddPass(const char* name, RecordFunction record);
+    void Clear();
+
+    void Execute();
+
+    uint32_t GetPassCount() const { return static_cast<uint32_t>(mPasses.size()); }
+    const char* GetPassName(uint32_t passIndex) const { return mPasses[passIndex].mName; }
+
+    // Time the last Execute spent recording each pass, in milliseconds
+    double GetPassTime(uint32_t passIndex) const { return mPasses[passIndex].mTime; }
+
+private:
+    struct Pass
+    {
+        const char* mName;
+        RecordFunction mRecord;
+        double mTime = 0.0;
+    };
+
+    void RunWorker();
+    void RecordPasses();
+
+    std::vector<Pass> mPasses;
+    std::vector<std::thread> mWorkers;
+
+    // Every Execute is a new generation. Workers record passes until none are left and then report back, Execute only
+    // returns once every worker has done so, so no worker can still be looking at the passes afterwards.
+    std::mutex mMutex;
+    std::condition_variable mStartCondition;
+    std::condition_variable mDoneCondition;
+    uint64_t mGeneration = 0;
+    uint32_t mNextPass = 0;
+    uint32_t mFinishedWorkers = 0;
+    bool mStopRequested = false;
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <PassRecorder.h>
+#include <RenderBackend.h>
+#include <SkylinePacker.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// The pipelines of the D3D12 backend, see the shaders in the data directory
+enum class RecordedPipeline : uint8_t
+{
+    Color,              // basic.hlsl, three ColorVertex per triangle
+    Textured,           // textured.hlsl, three TexturedVertex per triangle
+    SpriteOpaque,       // sprite.hlsl, one SpriteInstance per sprite
+    SpriteAlpha,
+    Text,               // text.hlsl, one GlyphInstance per glyph
+};
+
+// Same layouts as the vertices of TriangleRenderer and TexturedTriangleRenderer. Positions are in clip space.
+struct ColorVertex
+{
+    float mX;
+    float mY;
+    float mZ;
+    float mR;
+    float mG;
+    float mB;
+    float mA;
+};
+
+struct TexturedVertex
+{
+    float mX;
+    float mY;
+    float mZ;
+    float mU;
+    float mV;
+};
+
+struct RecordedCommand
+{
+    enum class Type : uint8_t
+    {
+        Clear,                  // Clear the render target to mColor
+        UploadRetainedText,     // Copy mCount glyphs at mDataOffset to the retained text slots starting at mFirst
+        Draw,                   // Draw mCount instances of mVertexCount vertices, starting at instance mFirst
+    };
+
+    // Where the vertex or instance data of a draw is
+    enum class Source : uint8_t
+    {
+        PassData,               // The data of the pass, starting at mDataOffset
+        RetainedText,           // The retained glyphs of the backend
+    };
+
+    Type mType;
+    RecordedPipeline mPipeline;
+    Source mSource;
+    SpriteTexture mTexture;     // Atlas page of a sprite draw
+    uint32_t mVertexCount;
+    uint32_t mCount;
+    uint32_t mFirst;
+    uint32_t mColor;            // 0xRRGGBB
+    uint64_t mDataOffset;
+};
+
+// A backend without a GPU. Every pass is recorded into a command stream in memory the same way the D3D12 backend records
+// its command lists: on the same threads, with the same draws and copying the same vertex and instance data. Nothing is
+// executed, so the frame's CPU cost can be measured on any machine and the stream can be inspected until the next
+// BeginFrame.
+class RecordingBackend : public RenderBackend
+{
+public:
+    // Every pass records the commands and the vertex and instance data they point to
+    struct Pass
+    {
+        std::vector<RecordedCommand> mCommands;
+        std::vector<uint8_t> mData;
+    };
+
+    // An atlas page of sprite images. Unlike on the GPU the pixels are kept so the stream can be drawn later.
+    struct Page
+    {
+        SkylinePacker mPacker;
+        std::vector<uint8_t> mPixels;       // RGBA8
+    };
+
+    // workerCount threads record passes besides the one calling Render, same as the D3D12 backend by default
+    RecordingBackend(uint32_t width, uint32_t height, uint32_t workerCount = RenderPassCount - 1);
+
+    uint32_t GetWidth() const override { return mWidth; }
+    uint32_t GetHeight() const override { return mHeight; }
+
+    SpriteImage CreateSpriteImage(uint32_t width, uint32_t height, const uint8_t* pixels) override;
+
+    void BeginFrame() override;
+    void Record(const RenderFrame& frame, RenderTimings& timings) override;
+    void Submit() override;
+    void Present() override;
+    void EndFrame() override;
+
+    // Frames recorded so far
+    uint64_t GetFrameCount() const { return mFrameCount; }
+
+    const Pass& GetPass(RenderPass pass) const { return mPasses[pass]; }
+    const std::vector<GlyphInstance>& GetRetainedGlyphs() const { return mRetainedGlyphs; }
+
+    uint32_t GetPageCount() const { return static_cast<uint32_t>(mPages.size()); }
+    const Page& GetPage(SpriteTexture texture) const { return mPages[texture]; }
+
+private:
+    static constexpr uint32_t PageSize = 1024;
+    static constexpr uint32_t MaxPages = UINT16_MAX;
+
+    // Returns the offset of size new bytes of pass data. The data can move until the pass is done with it.
+    static uint64_t AllocateData(Pass& pass, uint64_t size);
+
+    void RecordScene(Pass& pass);
+    void RecordSprites(Pass& pass, SpriteBatch& batch);
+    void RecordText(Pass& pass, RetainedText& retainedText, const GlyphPageArena& debugText);
+
+    uint32_t mWidth;
+    uint32_t mHeight;
+    uint64_t mFrameCount = 0;
+
+    std::array<Pass, RenderPassCount> mPasses;
+    PassRecorder mPassRecorder;
+    const RenderFrame* mFrame = nullptr;
+
+    std::array<TexturedVertex, 3> mSceneVertices;
+    std::vector<Page> mPages;
+    std::vector<SpriteDraw> mSpriteDraws;
+    std::vector<RetainedText::SlotRange> mRetainedChanges;
+    std::vector<GlyphInstance> mRetainedGlyphs;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <SpriteBatch.h>
+#include <TextLayout.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Every backend splits the frame into the same passes. They are recorded in parallel and submitted in this order.
+enum RenderPass : uint32_t
+{
+    ScenePass,
+    SpritePass,
+    TextPass,
+    RenderPassCount
+};
+
+// CPU time in milliseconds that Renderer::Render spent in each stage of the last frame
+struct RenderTimings
+{
+    double mWait = 0.0;         // Until the resources of the frame can be reused
+    double mRecord = 0.0;       // All passes, from the start of the first one until the last one is done
+    std::array<double, RenderPassCount> mPasses = {};
+    double mSubmit = 0.0;
+    double mPresent = 0.0;
+    double mFrame = 0.0;
+};
+
+// The checkerboard the triangle of the scene pass is textured with
+std::vector<uint8_t> GenerateTextureData(const uint32_t textureWidth, const uint32_t textureHeight, const uint32_t texturePixelSize);
+
+// What the renderer draws this frame. The renderer owns all of it and clears the sprites and debug text once the frame is
+// recorded. Retained text changes are left for the backend to flush when it uploads them.
+struct RenderFrame
+{
+    SpriteBatch& mSprites;
+    RetainedText& mRetainedText;
+    const GlyphPageArena& mDebugText;
+};
+
+// The part of the renderer that talks to a graphics API. Renderer keeps everything that doesn't, so the same submissions
+// can be drawn by D3D12 or recorded without a GPU (see D3D12Backend.h and RecordingBackend.h).
+class RenderBackend
+{
+public:
+    // Retained text instances are kept in a buffer of this many glyphs
+    static constexpr uint32_t MaxRetainedGlyphs = 1 << 18;
+
+    virtual ~RenderBackend() = default;
+
+    virtual uint32_t GetWidth() const = 0;
+    virtual uint32_t GetHeight() const = 0;
+
+    // pixels is width * height RGBA8 and is copied. The image is packed into a shared atlas page and can be used right away.
+    virtual SpriteImage CreateSpriteImage(uint32_t width, uint32_t height, const uint8_t* pixels) = 0;
+
+    // Called in this order once per frame. Record fills in the time of every pass.
+    virtual void BeginFrame() = 0;
+    virtual void Record(const RenderFrame& frame, RenderTimings& timings) = 0;
+    virtual void Submit() = 0;
+    virtual void Present() = 0;
+    virtual void EndFrame() = 0;
+};
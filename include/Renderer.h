@@ -1,24 +1,55 @@
 #pragma once
 
+#include <RenderBackend.h>
+#include <SpriteBatch.h>
+#include <TextLayout.h>
+
 #include <memory>
 #include <string_view>
 
-class Window;
-class RendererImpl;
+using TextHandle = RetainedText::Handle;
 
+// Collects what is drawn every frame and hands it to a RenderBackend. Nothing in here depends on the graphics API.
 class Renderer
 {
 public:
     Renderer();
     ~Renderer();
 
-    void Initialize(Window& window);
+    // The game uses CreateD3D12Backend, benchmarks and tools can run headless with a RecordingBackend
+    void Initialize(std::unique_ptr<RenderBackend> backend);
     void Shutdown();
 
     void Render();
 
-    void AddDebugText(std::string_view text, int32_t x, int32_t y);
+    // Where the CPU time of the last Render went
+    const RenderTimings& GetTimings() const { return mTimings; }
+    RenderBackend& GetBackend() { return *mBackend; }
+
+    // Text that is only drawn this frame. color is 0xRRGGBB.
+    void AddDebugText(std::string_view text, int32_t x, int32_t y, uint32_t color = TextColorWhite);
+
+    // Text that stays on screen until it is destroyed. Its layout is cached and only redone when it changes, so use this
+    // for anything that is drawn every frame.
+    TextHandle CreateText(std::string_view text, int32_t x, int32_t y, uint32_t color = TextColorWhite);
+    void DestroyText(TextHandle handle);
+    void SetText(TextHandle handle, std::string_view text);
+    void SetTextPosition(TextHandle handle, int32_t x, int32_t y);
+    void SetTextColor(TextHandle handle, uint32_t color);
+
+    // pixels is width * height RGBA8 and is copied. The image is packed into a shared atlas page and can be used right away.
+    SpriteImage CreateSpriteImage(uint32_t width, uint32_t height, const uint8_t* pixels);
+
+    // Sprites are only drawn this frame. They are batched by layer, blend mode and texture and drawn under the text.
+    void DrawSprite(const Sprite& sprite);
 
 private:
-    std::unique_ptr<RendererImpl> mImpl;
-};
\ No newline at end of file
+    std::unique_ptr<RenderBackend> mBackend;
+    RenderTimings mTimings;
+
+    SpriteBatch mSprites;
+    RetainedText mRetainedText;
+
+    // Debug text is laid out when it is added and drawn one page at a time
+    GlyphPageArena mDebugText;
+};
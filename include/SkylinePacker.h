@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct AtlasRect
+{
+    uint32_t mX;
+    uint32_t mY;
+    uint32_t mWidth;
+    uint32_t mHeight;
+};
+
+// Packs rectangles into a fixed size page with the skyline bottom-left heuristic. The packer only tracks the top edge of
+// what has been placed so far, a list of horizontal segments, and puts every new rectangle where its top ends up lowest.
+// Space below the skyline that a rectangle hangs over is lost, which is fine for sprites and glyphs that are added once
+// and never freed. It doesn't know about any texture so it can be used offline as well as at runtime.
+class SkylinePacker
+{
+public:
+    // padding is left empty to the right of and below every rectangle so that filtering doesn't pick up its neighbours
+    void Initialize(uint32_t width, uint32_t height, uint32_t padding = 1);
+    void Reset();
+
+    // Returns false if the rectangle doesn't fit anywhere in the page
+    bool Allocate(uint32_t width, uint32_t height, AtlasRect& rect);
+
+    uint32_t GetWidth() const { return mWidth; }
+    uint32_t GetHeight() const { return mHeight; }
+
+    // Fraction of the page covered by allocated rectangles, padding included
+    float GetOccupancy() const { return static_cast<float>(mUsedArea) / (static_cast<float>(mWidth) * static_cast<float>(mHeight)); }
+
+private:
+    struct Segment
+    {
+        uint32_t mX;
+        uint32_t mY;
+        uint32_t mWidth;
+    };
+
+    // Returns the y the rectangle would be placed at if its left edge was at segment index, or false if it doesn't fit
+    bool Fit(size_t index, uint32_t width, uint32_t height, uint32_t& y) const;
+
+    std::vector<Segment> mSkyline;
+    uint32_t mWidth = 0;
+    uint32_t mHeight = 0;
+    uint32_t mPadding = 0;
+    uint64_t mUsedArea = 0;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <RecordingBackend.h>
+#include <SoftwareRasterizer.h>
+
+#include <string_view>
+#include <vector>
+
+// A backend that draws on the CPU. Passes are recorded exactly like the RecordingBackend does, Submit then replays the
+// streams through a SoftwareRasterizer with the same vertex math, samplers and blend states as the shaders and pipelines
+// of the D3D12 backend. The frame stays in the rasterizer until the next Submit, so it can be read back or written out.
+class SoftwareBackend : public RecordingBackend
+{
+public:
+    // workerCount threads record passes and draw tiles besides the one calling Render
+    SoftwareBackend(uint32_t width, uint32_t height, uint32_t workerCount = RenderPassCount - 1);
+
+    void Submit() override;
+
+    const SoftwareRasterizer& GetRasterizer() const { return mRasterizer; }
+
+    // Writes the last submitted frame as an uncompressed 32 bit TGA
+    bool WriteImage(std::string_view path) const { return mRasterizer.WriteTga(path); }
+
+private:
+    void DrawPass(const Pass& pass);
+    void DrawColorTriangles(const Pass& pass, const RecordedCommand& command);
+    void DrawTexturedTriangles(const Pass& pass, const RecordedCommand& command);
+    void DrawSprites(const Pass& pass, const RecordedCommand& command);
+    void DrawGlyphs(const GlyphInstance* glyphs, uint32_t count);
+
+    // Clip space to pixels, for a viewport that covers the target
+    RasterVertex ToPixels(float x, float y) const;
+
+    SoftwareRasterizer mRasterizer;
+
+    std::vector<uint8_t> mSceneTextureData;
+    RasterTexture mSceneTexture;
+    RasterTexture mFontTexture;
+    std::vector<RasterTexture> mPageTextures;
+};
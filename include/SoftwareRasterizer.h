@@ -0,0 +1,141 @@
+#pragma once
+
+#include <PassRecorder.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// RGBA8 or single channel texture. Single channel textures read as (r, 0, 0, 1), like an R8_UNORM view.
+struct RasterTexture
+{
+    const uint8_t* mPixels = nullptr;
+    uint32_t mWidth = 0;
+    uint32_t mHeight = 0;
+    uint32_t mPixelSize = 4;
+};
+
+enum class RasterFilter : uint8_t
+{
+    Point,
+    Linear,
+};
+
+enum class RasterAddress : uint8_t
+{
+    Clamp,
+    Border,             // Transparent black outside the texture
+};
+
+// The pixel shaders of the renderer's pipelines
+enum class RasterShader : uint8_t
+{
+    VertexColor,        // basic.hlsl, the interpolated color
+    Texture,            // textured.hlsl, the texture sample
+    TextureTimesColor,  // sprite.hlsl, the texture sample times the color
+    Coverage,           // text.hlsl, the color with the red channel of the texture as alpha
+};
+
+struct RasterState
+{
+    RasterShader mShader = RasterShader::VertexColor;
+    RasterFilter mFilter = RasterFilter::Point;
+    RasterAddress mAddress = RasterAddress::Clamp;
+    bool mAlphaBlend = false;                   // Source alpha over the render target, otherwise the target is replaced
+    const RasterTexture* mTexture = nullptr;    // Has to stay valid until Rasterize returns
+};
+
+struct RasterVertex
+{
+    float mX;           // In pixels, the top left of the target is 0, 0
+    float mY;
+    float mU;
+    float mV;
+    float mR;
+    float mG;
+    float mB;
+    float mA;
+};
+
+// Draws triangles into an RGBA8 target on the CPU, following the D3D12 rasterization rules closely enough that frames
+// can be compared against golden images. Positions are snapped to 1/256 of a pixel, pixels are sampled at their center
+// and edges follow the top left rule, so triangles that share an edge never both draw a pixel on it.
+//
+// Triangles are binned into tiles as they are added. Rasterize draws the tiles in parallel, each one on a single thread
+// and in the order its triangles were added, so blending works as it does on the GPU. Edge tests, interpolation, sampling
+// math and blending are done four pixels at a time with SSE2.
+class SoftwareRasterizer
+{
+public:
+    static constexpr uint32_t TileSize = 32;
+
+    SoftwareRasterizer() = default;
+    SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+    SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+
+    // workerCount threads draw tiles besides the one calling Rasterize
+    void Initialize(uint32_t width, uint32_t height, uint32_t workerCount);
+
+    // Starts a new frame cleared to color, 0xRRGGBB. Triangles added before are dropped since they would be covered anyway.
+    void Clear(uint32_t color);
+
+    void AddTriangle(const RasterState& state, const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2);
+    void Rasterize();
+
+    uint32_t GetWidth() const { return mWidth; }
+    uint32_t GetHeight() const { return mHeight; }
+    uint32_t GetTriangleCount() const { return static_cast<uint32_t>(mTriangles.size()); }
+
+    // R8G8B8A8, red in the low byte. Rows are GetPitch() pixels apart.
+    const uint32_t* GetPixels() const { return mPixels.data(); }
+    uint32_t GetPitch() const { return mPitch; }
+    uint32_t GetPixel(uint32_t x, uint32_t y) const { return mPixels[static_cast<size_t>(y) * mPitch + x]; }
+
+    // Writes the target as an uncompressed 32 bit TGA
+    bool WriteTga(std::string_view path) const;
+
+private:
+    struct Triangle
+    {
+        RasterState mState;
+
+        // Vertices and edges are laid out so they load straight into SSE registers, the fourth lane is unused.
+        // Edge i runs from vertex i to the next one.
+        alignas(16) float mX[4];
+        alignas(16) float mY[4];
+        alignas(16) float mEdgeA[4];
+        alignas(16) float mEdgeB[4];
+        uint32_t mTopLeftEdges;                 // Bit i is set if edge i is a top or left edge
+
+        // Inclusive range of pixels whose centers can be inside
+        int32_t mMinX;
+        int32_t mMinY;
+        int32_t mMaxX;
+        int32_t mMaxY;
+
+        // u, v, r, g, b, a at vertex 0 and how they change per pixel
+        alignas(16) float mAttributes[8];
+        alignas(16) float mAttributesDx[8];
+        alignas(16) float mAttributesDy[8];
+    };
+
+    void RasterizeTiles();
+    void RasterizeTile(uint32_t tileIndex);
+
+    uint32_t mWidth = 0;
+    uint32_t mHeight = 0;
+    uint32_t mTilesX = 0;
+    uint32_t mTilesY = 0;
+    uint32_t mPitch = 0;
+
+    // The target is padded to whole tiles so tiles never have to check for the edge of the target
+    std::vector<uint32_t> mPixels;
+    uint32_t mClearColor = 0;
+
+    std::vector<Triangle> mTriangles;
+    std::vector<std::vector<uint32_t>> mBins;   // Triangle indices per tile, in the order they were added
+
+    PassRecorder mPassRecorder;
+    std::atomic<uint32_t> mNextTile{ 0 };
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Index of an atlas page in the sprite renderer
+using SpriteTexture = uint16_t;
+
+// Every blend mode is its own pipeline state
+enum class SpriteBlend : uint8_t
+{
+    Opaque,
+    Alpha,
+    Count
+};
+
+// Where an image created with Renderer::CreateSpriteImage ended up in the atlas
+struct SpriteImage
+{
+    SpriteTexture mTexture;
+    float mU0;
+    float mV0;
+    float mU1;
+    float mV1;
+};
+
+struct Sprite
+{
+    float mX = 0.0f;                // Top left corner in pixels
+    float mY = 0.0f;
+    float mWidth = 0.0f;
+    float mHeight = 0.0f;
+    float mU0 = 0.0f;               // Part of the texture to draw
+    float mV0 = 0.0f;
+    float mU1 = 1.0f;
+    float mV1 = 1.0f;
+    uint32_t mColor = 0xFFFFFF;     // Multiplied with the texture, 0xRRGGBB
+    SpriteTexture mTexture = 0;
+    uint8_t mLayer = 0;             // Higher layers are drawn on top of lower ones
+    SpriteBlend mBlend = SpriteBlend::Alpha;
+
+    void SetImage(const SpriteImage& image)
+    {
+        mTexture = image.mTexture;
+        mU0 = image.mU0;
+        mV0 = image.mV0;
+        mU1 = image.mU1;
+        mV1 = image.mV1;
+    }
+};
+
+// One sprite as the vertex shader in data/sprite.hlsl reads it. The quad is expanded from SV_VertexID like the text.
+struct SpriteInstance
+{
+    float mX;
+    float mY;
+    float mWidth;
+    float mHeight;
+    float mU0;
+    float mV0;
+    float mU1;
+    float mV1;
+    uint32_t mColor;                // R8G8B8A8_UNORM, red in the low byte
+};
+
+static_assert(sizeof(SpriteInstance) == 36, "SpriteInstance has to match the input layout of the sprite shader");
+
+// A run of instances that share a pipeline and a texture
+struct SpriteDraw
+{
+    SpriteBlend mBlend;
+    SpriteTexture mTexture;
+    uint32_t mFirstInstance;
+    uint32_t mInstanceCount;
+};
+
+// Collects the sprites of a frame and turns them into as few draws as possible. Sprites are sorted by layer, then blend
+// mode, then texture with a radix sort on a 32 bit key. The sort is stable, so sprites with the same key are drawn in the
+// order they were added. This doesn't touch the GPU so it can be run and timed without a renderer.
+class SpriteBatch
+{
+public:
+    void Add(const Sprite& sprite);
+    void Clear();
+
+    bool IsEmpty() const { return mSprites.empty(); }
+    uint32_t GetSpriteCount() const { return static_cast<uint32_t>(mSprites.size()); }
+
+    // Writes GetSpriteCount() instances in draw order and appends the draws that cover them to draws
+    void Build(SpriteInstance* instances, std::vector<SpriteDraw>& draws);
+
+private:
+    static uint32_t MakeKey(const Sprite& sprite);
+
+    void Sort();
+
+    std::vector<Sprite> mSprites;
+
+    // Sort key in the high 32 bits and the sprite index in the low 32 bits
+    std::vector<uint64_t> mSortEntries;
+    std::vector<uint64_t> mSortScratch;
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <AssetStreamer.h>
+#include <JobSystem.h>
+
+#include <coroutine>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// A coroutine that runs on the job system. Where a job would block on something, a task co_awaits it instead and its
+// thread goes on with other jobs. Whichever pool thread gets to the task first once the wait is over resumes it, so a
+// task can hop threads at every co_await.
+//
+//     Task LoadLevel(Level& level)
+//     {
+//         JobCounter counter;
+//         RunTask(LoadTiles(level), &counter);
+//         RunTask(LoadSprites(level), &counter);
+//         co_await counter;
+//     }
+//
+// Tasks don't run until they are started with RunTask and destroy themselves when they return. Arguments are copied into
+// the task like into any coroutine, so references have to outlive it.
+class Task
+{
+public:
+    struct promise_type
+    {
+        JobCounter* mCounter = nullptr;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept
+        {
+            // The task is destroyed before its counter goes down, so nothing it owns is left once a waiter resumes
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept { return false; }
+                void await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept
+                {
+                    JobCounter* counter = coroutine.promise().mCounter;
+                    coroutine.destroy();
+                    if (counter != nullptr)
+                    {
+                        JobSystem::Get().FinishWork(*counter);
+                    }
+                }
+                void await_resume() noexcept {}
+            };
+            return FinalAwaiter();
+        }
+        void return_void() {}
+        void unhandled_exception();
+    };
+
+    Task(Task&& other) noexcept : mCoroutine(std::exchange(other.mCoroutine, nullptr)) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    Task& operator=(Task&&) = delete;
+
+    // A task that was never started is thrown away
+    ~Task()
+    {
+        if (mCoroutine)
+        {
+            mCoroutine.destroy();
+        }
+    }
+
+private:
+    friend void RunTask(Task task, JobCounter* counter);
+
+    explicit Task(std::coroutine_handle<promise_type> coroutine) : mCoroutine(coroutine) {}
+
+    std::coroutine_handle<promise_type> mCoroutine;
+};
+
+// Queues the task on the job system. counter, if there is one, is done once the task has returned.
+void RunTask(Task task, JobCounter* counter = nullptr);
+
+// co_await counter suspends the task until every job and task started with the counter has finished
+inline auto operator co_await(JobCounter& counter)
+{
+    struct CounterAwaiter
+    {
+        JobCounter& mCounter;
+
+        bool await_ready() const { return mCounter.IsDone(); }
+        bool await_suspend(std::coroutine_handle<> coroutine) { return JobSystem::Get().AddWaiter(mCounter, coroutine); }
+        void await_resume() const {}
+    };
+    return CounterAwaiter{ counter };
+}
+
+// A value that only goes up, like a GPU fence. Tasks co_await Reached(value) to wait until it has been signaled with at
+// least value. With 0 and 1 it works as an event that is set once.
+class TaskFence
+{
+public:
+    explicit TaskFence(uint64_t initialValue = 0) : mCompletedValue(initialValue) {}
+    TaskFence(const TaskFence&) = delete;
+    TaskFence& operator=(const TaskFence&) = delete;
+
+    uint64_t GetCompletedValue() const { return mCompletedValue.load(std::memory_order_acquire); }
+
+    // Resumes the tasks waiting for value or less. Values lower than the completed one are ignored.
+    void Signal(uint64_t value);
+
+    auto Reached(uint64_t value)
+    {
+        struct FenceAwaiter
+        {
+            TaskFence& mFence;
+            uint64_t mValue;
+
+            bool await_ready() const { return mFence.GetCompletedValue() >= mValue; }
+            bool await_suspend(std::coroutine_handle<> coroutine) { return mFence.AddWaiter(mValue, coroutine); }
+            void await_resume() const {}
+        };
+        return FenceAwaiter{ *this, value };
+    }
+
+private:
+    struct Waiter
+    {
+        uint64_t mValue;
+        std::coroutine_handle<> mCoroutine;
+    };
+
+    bool AddWaiter(uint64_t value, std::coroutine_handle<> coroutine);
+
+    std::atomic<uint64_t> mCompletedValue;
+    std::mutex mMutex;
+    std::vector<Waiter> mWaiters;
+};
+
+// co_await LoadAsset(...) streams an asset in through the AssetStreamer without holding a thread while the file is read.
+// decode runs on a decode thread as usual. The task resumes with whether the asset was loaded and decoded.
+class LoadAsset
+{
+public:
+    LoadAsset(std::string_view path, AssetPriority priority, AssetStreamer::DecodeFunction decode = nullptr)
+        : mPath(path)
+        , mPriority(priority)
+        , mDecode(std::move(decode))
+    {
+    }
+
+    bool await_ready() const { return false; }
+    void await_suspend(std::coroutine_handle<> coroutine);
+    bool await_resume() const { return mLoaded; }
+
+private:
+    std::string mPath;
+    AssetPriority mPriority;
+    AssetStreamer::DecodeFunction mDecode;
+    bool mLoaded = false;
+};
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Text is drawn as one instance per glyph. The vertex shader in data/text.hlsl turns each instance into a quad and looks up
+// its UVs in the font atlas, so all the CPU has to write is 8 bytes per character.
+struct GlyphInstance
+{
+    int16_t mX;                 // Top left corner of the glyph in pixels
+    int16_t mY;
+    uint32_t mGlyphAndColor;    // Glyph index in the low 8 bits, then red, green and blue
+};
+
+static_assert(sizeof(GlyphInstance) == 8, "GlyphInstance has to match the input layout of the text shader");
+
+constexpr uint32_t TextColorWhite = 0xFFFFFF;
+
+// color is 0xRRGGBB
+constexpr uint32_t PackGlyph(uint8_t glyph, uint32_t color)
+{
+    return glyph | (((color >> 16) & 0xFF) << 8) | (((color >> 8) & 0xFF) << 16) | ((color & 0xFF) << 24);
+}
+
+// An instance that is entirely off screen. Used to fill slots that don't hold a glyph so they can still be drawn.
+constexpr GlyphInstance HiddenGlyph = { INT16_MIN, INT16_MIN, 0 };
+
+// Writes one instance per character of text starting at pixel x, y into instances. Characters outside of the font are
+// drawn as '?'. Returns how many instances were written, which is less than the length of text if capacity runs out.
+// Uses SSE2 to do 16 characters at a time where it is available.
+size_t LayoutText(std::string_view text, int32_t x, int32_t y, uint32_t color, GlyphInstance* instances, size_t capacity);
+
+// A corner of a glyph quad after expansion. Positions are in clip space.
+struct GlyphVertex
+{
+    float mX;
+    float mY;
+    float mU;
+    float mV;
+    uint32_t mColor;            // 0xRRGGBB
+};
+
+// CPU version of the expansion done by the text vertex shader. Writes the corners in triangle strip order: top left, top
+// right, bottom left, bottom right. This is what the shader has to match, so use it to check changes to either.
+void ExpandGlyphInstance(const GlyphInstance& instance, float screenWidth, float screenHeight, GlyphVertex (&vertices)[4]);
+
+// Storage for text that is laid out again every frame, such as debug overlays. Text is laid out as soon as it is added,
+// into fixed size pages of instances. Reset rewinds to the first page but keeps every page around, so once the arena has
+// grown to fit the largest frame, adding text doesn't allocate. There is no limit on the amount of text, a frame just
+// uses more pages.
+class GlyphPageArena
+{
+public:
+    static constexpr uint32_t GlyphsPerPage = 8192;
+
+    struct Page
+    {
+        std::unique_ptr<GlyphInstance[]> mGlyphs;
+        uint32_t mCount = 0;
+    };
+
+    // Text that doesn't fit in the current page continues in the next one
+    void AddText(std::string_view text, int32_t x, int32_t y, uint32_t color);
+    void Reset();
+
+    bool IsEmpty() const { return mGlyphCount == 0; }
+    uint32_t GetGlyphCount() const { return mGlyphCount; }
+
+    // Pages in use this frame. All but the last one are full.
+    uint32_t GetUsedPageCount() const { return mUsedPageCount; }
+    const Page& GetPage(uint32_t index) const { return mPages[index]; }
+
+    // Pages allocated so far, used or not
+    uint32_t GetAllocatedPageCount() const { return static_cast<uint32_t>(mPages.size()); }
+
+private:
+    std::vector<Page> mPages;
+    uint32_t mUsedPageCount = 0;
+    uint32_t mGlyphCount = 0;
+};
+
+// Keeps the glyph instances of long lived text such as HUD labels so that they are only laid out again when the text,
+// position or color changes.
+//
+// Every label owns a range of glyph slots, sized to a power of two so that it can be reused by other labels once it is
+// freed. Slots that don't hold a glyph contain HiddenGlyph, so all of [0, GetSlotCount()) can be drawn without looking
+// at the labels. FlushChanges lays out what changed since the last call and reports which slot ranges need uploading.
+class RetainedText
+{
+public:
+    using Handle = uint32_t;
+    static constexpr Handle InvalidHandle = ~0u;
+
+    struct SlotRange
+    {
+        uint32_t mFirst;
+        uint32_t mCount;
+    };
+
+    void Initialize(uint32_t maxSlots);
+
+    // Returns InvalidHandle if there are not enough slots left for the text
+    Handle Create(std::string_view text, int32_t x, int32_t y, uint32_t color);
+    void Destroy(Handle handle);
+
+    // If the longer text doesn't fit in the remaining slots it is cut off at the length of the old text
+    void SetText(Handle handle, std::string_view text);
+    void SetPosition(Handle handle, int32_t x, int32_t y);
+    void SetColor(Handle handle, uint32_t color);
+
+    bool HasChanges() const { return !mDirtyLabels.empty() || !mFreedRanges.empty(); }
+
+    // Upper bound on the number of instances FlushChanges will write
+    uint32_t GetChangedSlotCount() const;
+
+    // Writes the instances of every changed slot range to instances, in the order of the ranges appended to changes.
+    // Adjacent ranges are merged. Returns the number of instances written.
+    uint32_t FlushChanges(GlyphInstance* instances, std::vector<SlotRange>& changes);
+
+    uint32_t GetSlotCount() const { return mSlotEnd; }
+
+private:
+    struct Label
+    {
+        std::string mText;
+        int32_t mX = 0;
+        int32_t mY = 0;
+        uint32_t mColor = 0;
+        SlotRange mSlots = {};
+        bool mAlive = false;
+        bool mDirty = false;
+    };
+
+    static constexpr uint32_t MinSlotsPerLabel = 8;
+
+    bool AllocateSlots(uint32_t length, SlotRange& slots);
+    void FreeSlots(const SlotRange& slots);
+    void MarkDirty(Handle handle);
+
+    std::vector<Label> mLabels;
+    std::vector<Handle> mFreeHandles;
+    std::vector<Handle> mDirtyLabels;
+    std::vector<SlotRange> mFreedRanges;                    // Freed since the last flush, these need hiding
+    std::array<std::vector<uint32_t>, 32> mFreeSlots;      // First slot of free ranges by log2 of their size
+    uint32_t mSlotEnd = 0;
+    uint32_t mMaxSlots = 0;
+};
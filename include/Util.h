@@ -1,6 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
 
 #define ensureNoLog(x) if (!(x)) { int *y = 0; *y = 42; }
-#define ensure(x) if (!(x)) { LOG("ensure failed: %s", #x); LOGGER_FLUSH(); int *y = 0; *y = 42; }
+#define ensure(x) if (!(x)) { LOG_ERROR(General, "ensure failed: %s", #x); LOGGER_FLUSH(); int *y = 0; *y = 42; }
 
 std::string slurp(std::string_view path);
+
+// Read only view of an entire file. The file is memory mapped so it can be parsed straight out of the page cache without
+// copying. If mapping fails, the file is read into a single allocation sized up front instead. The view stays valid until
+// the MappedFile is closed or destroyed.
+class MappedFile
+{
+public:
+    enum class AccessHint
+    {
+        Normal,
+        Sequential,     // The file will be read front to back once
+        WillNeed,       // Start reading the whole file in now
+    };
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(std::string_view path, AccessHint hint = AccessHint::Normal);
+    void Close();
+
+    bool IsOpen() const { return mOpen; }
+    bool IsMapped() const { return mMapped; }
+    const uint8_t* GetData() const { return mData; }
+    size_t GetSize() const { return mSize; }
+    std::string_view GetView() const { return std::string_view(reinterpret_cast<const char*>(mData), mSize); }
+
+private:
+    bool Map(std::string_view path, AccessHint hint);
+    bool Read(std::string_view path);
+
+    const uint8_t* mData = nullptr;
+    size_t mSize = 0;
+    bool mOpen = false;
+    bool mMapped = false;
+    std::unique_ptr<uint8_t[]> mBuffer;
+};
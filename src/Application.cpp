@@ -1,7 +1,28 @@
 #include <Application.h>
+#include <Assets.h>
+#include <AssetStreamer.h>
+#include <D3D12Backend.h>
+#include <JobSystem.h>
 #include <Log.h>
+#include <LogSinks.h>
 
-#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MillisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Scroll speed of the world, in pixels per second
+    constexpr double ScrollSpeed = 60.0;
+}
 
 std::unique_ptr<Application> Application::mInstance;
 
@@ -17,22 +38,32 @@ Application::~Application()
 
 void Application::Initialize(HINSTANCE hInstance, int nCmdShow)
 {
-    auto log_thread = std::thread([]() {
-        using namespace std::chrono_literals;
-        while (true)
-        {
-            LOGGER_FLUSH();
-            std::this_thread::sleep_for(10ms);
-        }
-    });
+    // Use the LogDecoder tool to read this file
+    Logger::Get().AddSink(std::make_unique<BinaryLogFileSink>("log.bin"));
+#if defined(_DEBUG)
+    Logger::Get().AddSink(std::make_unique<ConsoleLogSink>());
+#endif
+
+    Logger::Get().Start();
+
+    // data.pak is built by the AssetPacker tool. Without it every asset is loaded from the data directory instead.
+    if (!AssetManager::Get().Mount("data.pak"))
+    {
+        LOG_INFO(Assets, "No asset archive found, loading loose files");
+    }
 
-    log_thread.detach();
+    AssetStreamer::Get().Start();
+
+    // The main thread is part of the job pool and works on jobs whenever it waits for them
+    JobSystem::Get().Start(std::max(std::thread::hardware_concurrency(), 2u) - 1);
 
     mInstance.reset(new Application());
     mInstance->mWindow.Initialize(L"Bird Game", 288, 512, hInstance, nCmdShow);
-    LOG("Initialized Window");
-    mInstance->mRenderer.Initialize(mInstance->mWindow);
-    LOG("Initialized Renderer");
+    LOG_INFO(Application, "Initialized Window");
+    mInstance->mRenderer.Initialize(CreateD3D12Backend(mInstance->mWindow));
+    LOG_INFO(Application, "Initialized Renderer");
+
+    mInstance->mHelloText = mInstance->mRenderer.CreateText("Hello World!", 100, 100);
 }
 
 Application& Application::Instance()
@@ -42,20 +73,63 @@ Application& Application::Instance()
 
 void Application::Run()
 {
+    Clock::time_point lastFrame = Clock::now();
     while (mWindow.ProcessMessages())
     {
-        Update();
-        Render();
+        const Clock::time_point frameStart = Clock::now();
+        const double elapsed = std::chrono::duration<double>(frameStart - lastFrame).count();
+        lastFrame = frameStart;
+
+        // Loads finish in the background. This is the one point in the frame where their callbacks run, once per frame
+        // however many steps it simulates.
+        AssetStreamer::Get().DispatchCompletions();
+
+        const uint32_t steps = mTimestep.Advance(elapsed);
+        for (uint32_t step = 0; step < steps; ++step)
+        {
+            mPreviousState = mState;
+            Update(mTimestep.GetStep());
+        }
+
+        std::array<double, FramePhaseCount> phaseTimes = {};
+        phaseTimes[UpdatePhase] = MillisecondsSince(frameStart);
+
+        const Clock::time_point renderStart = Clock::now();
+        Render(mTimestep.GetAlpha());
+
+        const RenderTimings& timings = mRenderer.GetTimings();
+        phaseTimes[WaitPhase] = timings.mWait + timings.mPresent;
+        phaseTimes[RenderPhase] = std::max(MillisecondsSince(renderStart) - phaseTimes[WaitPhase], 0.0);
+        mFrameBudget.EndFrame(phaseTimes);
     }
 }
 
-void Application::Update()
+void Application::Update(double step)
 {
-    mRenderer.AddDebugText("Hello World!", 100, 100);
+    mState.mScroll += ScrollSpeed * step;
 }
 
-void Application::Render()
+void Application::Render(double alpha)
 {
+    const GameState state = { Interpolate(mPreviousState.mScroll, mState.mScroll, alpha) };
+
+    // The text scrolls across the window and comes back in on the right once it is out on the left
+    const double wrapWidth = mWindow.GetWidth() + 100.0;
+    const double x = mWindow.GetWidth() - std::fmod(state.mScroll, wrapWidth);
+    mRenderer.SetTextPosition(mHelloText, static_cast<int32_t>(std::floor(x)), 100);
+
+    // Averages over the last frames, in yellow while frames go over the budget. The line above has the whole frame and the
+    // slowest update and render in the history, which show the spikes the averages smooth out.
+    char line[128];
+    snprintf(line, sizeof(line), "upd %.2f ren %.2f wait %.2f ms", mFrameBudget.GetAverage(UpdatePhase),
+             mFrameBudget.GetAverage(RenderPhase), mFrameBudget.GetAverage(WaitPhase));
+    const bool overBudget = mFrameBudget.GetAverage(UpdatePhase) + mFrameBudget.GetAverage(RenderPhase) > mFrameBudget.GetBudget();
+    mRenderer.AddDebugText(line, 0, static_cast<int32_t>(mWindow.GetHeight()) - 16, overBudget ? 0xFFFF00 : TextColorWhite);
+
+    snprintf(line, sizeof(line), "frame %.2f max upd %.2f ren %.2f ms", mFrameBudget.GetAverageFrame(),
+             mFrameBudget.GetMax(UpdatePhase), mFrameBudget.GetMax(RenderPhase));
+    mRenderer.AddDebugText(line, 0, static_cast<int32_t>(mWindow.GetHeight()) - 32);
+
     mRenderer.Render();
 }
 
@@ -0,0 +1,199 @@
+#include <AssetStreamer.h>
+
+#include <algorithm>
+
+AssetStreamer& AssetStreamer::Get()
+{
+    static AssetStreamer assetStreamer;
+    return assetStreamer;
+}
+
+AssetStreamer::~AssetStreamer()
+{
+    Stop();
+}
+
+void AssetStreamer::Start(uint32_t ioThreadCount, uint32_t decodeThreadCount)
+{
+    if (!mThreads.empty())
+    {
+        return;
+    }
+
+    if (decodeThreadCount == 0)
+    {
+        // Leave a core for the main thread and one for the I/O threads
+        const uint32_t cores = std::thread::hardware_concurrency();
+        decodeThreadCount = std::clamp(cores > 2 ? cores - 2 : 1u, 1u, 4u);
+    }
+
+    mStopRequested = false;
+    for (uint32_t i = 0; i < std::max(ioThreadCount, 1u); ++i)
+    {
+        mThreads.emplace_back([this]() { RunIO(); });
+    }
+    for (uint32_t i = 0; i < decodeThreadCount; ++i)
+    {
+        mThreads.emplace_back([this]() { RunDecode(); });
+    }
+}
+
+void AssetStreamer::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopRequested = true;
+    }
+    mIOCondition.notify_all();
+    mDecodeCondition.notify_all();
+
+    for (std::thread& thread : mThreads)
+    {
+        thread.join();
+    }
+    mThreads.clear();
+
+    // Whoever made a request may be waiting for its callback, like a task suspended in LoadAsset, so every request gets
+    // one. Callbacks can make new requests, which are collected by the next round.
+    while (true)
+    {
+        std::vector<std::unique_ptr<Job>> dropped;
+        {
+            std::lock_guard<std::mutex> lock(mCompletedMutex);
+            dropped.swap(mCompleted);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (std::vector<std::unique_ptr<Job>>* queue : { &mDecodeQueue, &mIOQueue })
+            {
+                for (std::unique_ptr<Job>& job : *queue)
+                {
+                    job->mLoaded = false;
+                    dropped.push_back(std::move(job));
+                }
+                queue->clear();
+            }
+        }
+
+        if (dropped.empty())
+        {
+            break;
+        }
+
+        // The ones that had finished report how they did, the rest that they weren't loaded
+        for (std::unique_ptr<Job>& job : dropped)
+        {
+            if (job->mComplete)
+            {
+                job->mComplete(job->mLoaded);
+            }
+        }
+        mPendingCount.fetch_sub(static_cast<uint32_t>(dropped.size()), std::memory_order_relaxed);
+    }
+}
+
+void AssetStreamer::Request(std::string_view path, AssetPriority priority, DecodeFunction decode, CompleteFunction complete)
+{
+    std::unique_ptr<Job> job = std::make_unique<Job>();
+    job->mPath = path;
+    job->mPriority = priority;
+    job->mDecode = std::move(decode);
+    job->mComplete = std::move(complete);
+
+    mPendingCount.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        job->mSequence = mNextSequence++;
+        mIOQueue.push_back(std::move(job));
+        std::push_heap(mIOQueue.begin(), mIOQueue.end(), JobOrder());
+    }
+
+    mIOCondition.notify_one();
+}
+
+size_t AssetStreamer::DispatchCompletions()
+{
+    std::vector<std::unique_ptr<Job>> completed;
+    {
+        std::lock_guard<std::mutex> lock(mCompletedMutex);
+        completed.swap(mCompleted);
+    }
+
+    for (std::unique_ptr<Job>& job : completed)
+    {
+        if (job->mComplete)
+        {
+            job->mComplete(job->mLoaded);
+        }
+    }
+
+    mPendingCount.fetch_sub(static_cast<uint32_t>(completed.size()), std::memory_order_relaxed);
+    return completed.size();
+}
+
+void AssetStreamer::RunIO()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        mIOCondition.wait(lock, [this]() { return mStopRequested || !mIOQueue.empty(); });
+        if (mStopRequested)
+        {
+            return;
+        }
+
+        std::pop_heap(mIOQueue.begin(), mIOQueue.end(), JobOrder());
+        std::unique_ptr<Job> job = std::move(mIOQueue.back());
+        mIOQueue.pop_back();
+        lock.unlock();
+
+        job->mAsset = AssetManager::Get().Load(job->mPath);
+        if (job->mAsset.IsValid())
+        {
+            // Fault every page in here so that the decode threads don't stall on the disk
+            const uint8_t* data = job->mAsset.GetData();
+            uint8_t touched = 0;
+            for (size_t offset = 0; offset < job->mAsset.GetSize(); offset += 4096)
+            {
+                touched ^= *static_cast<const volatile uint8_t*>(data + offset);
+            }
+            (void)touched;
+        }
+
+        lock.lock();
+        mDecodeQueue.push_back(std::move(job));
+        std::push_heap(mDecodeQueue.begin(), mDecodeQueue.end(), JobOrder());
+        mDecodeCondition.notify_one();
+    }
+}
+
+void AssetStreamer::RunDecode()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        mDecodeCondition.wait(lock, [this]() { return mStopRequested || !mDecodeQueue.empty(); });
+        if (mStopRequested)
+        {
+            return;
+        }
+
+        std::pop_heap(mDecodeQueue.begin(), mDecodeQueue.end(), JobOrder());
+        std::unique_ptr<Job> job = std::move(mDecodeQueue.back());
+        mDecodeQueue.pop_back();
+        lock.unlock();
+
+        job->mLoaded = job->mAsset.IsValid() && (!job->mDecode || job->mDecode(job->mAsset));
+
+        // Archive assets are views so this only releases loose files
+        job->mAsset = Asset();
+
+        {
+            std::lock_guard<std::mutex> completedLock(mCompletedMutex);
+            mCompleted.push_back(std::move(job));
+        }
+
+        lock.lock();
+    }
+}
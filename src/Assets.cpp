@@ -0,0 +1,162 @@
+#include <Assets.h>
+
+namespace
+{
+    // Compares the way paths are hashed, so the name matches whichever slashes the caller used
+    bool IsSameAssetPath(std::string_view name, std::string_view path)
+    {
+        if (name.size() != path.size())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < name.size(); ++i)
+        {
+            if (name[i] != (path[i] == '\\' ? '/' : path[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+uint64_t HashAssetPath(std::string_view path)
+{
+    // 64 bit FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (char c : path)
+    {
+        hash ^= static_cast<uint8_t>(c == '\\' ? '/' : c);
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+// ------------------------------------------------------------------------------------------------
+
+bool AssetArchive::Open(std::string_view path)
+{
+    Close();
+
+    if (!mFile.Open(path, MappedFile::AccessHint::Normal) || mFile.GetSize() < sizeof(AssetPack::Header))
+    {
+        mFile.Close();
+        return false;
+    }
+
+    const uint8_t* data = mFile.GetData();
+    const size_t size = mFile.GetSize();
+    const AssetPack::Header* header = reinterpret_cast<const AssetPack::Header*>(data);
+    if (header->mMagic != AssetPack::Magic || header->mVersion != AssetPack::Version ||
+        header->mIndexOffset + static_cast<uint64_t>(header->mEntryCount) * sizeof(AssetPack::Entry) > size ||
+        header->mNamesOffset > size)
+    {
+        mFile.Close();
+        return false;
+    }
+
+    mHeader = header;
+    mEntries = reinterpret_cast<const AssetPack::Entry*>(data + header->mIndexOffset);
+    mNames = reinterpret_cast<const char*>(data + header->mNamesOffset);
+    return true;
+}
+
+void AssetArchive::Close()
+{
+    mFile.Close();
+    mHeader = nullptr;
+    mEntries = nullptr;
+    mNames = nullptr;
+}
+
+bool AssetArchive::Find(std::string_view path, std::string_view& data) const
+{
+    if (mHeader == nullptr)
+    {
+        return false;
+    }
+
+    const uint64_t hash = HashAssetPath(path);
+
+    // Lower bound over the sorted index
+    uint32_t first = 0;
+    uint32_t count = mHeader->mEntryCount;
+    while (count > 0)
+    {
+        const uint32_t step = count / 2;
+        if (mEntries[first + step].mHash < hash)
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    // A matching hash doesn't mean it's the same path, so check the names of every entry with that hash
+    const uint64_t namesSize = mFile.GetSize() - mHeader->mNamesOffset;
+    for (; first < mHeader->mEntryCount && mEntries[first].mHash == hash; ++first)
+    {
+        const AssetPack::Entry& entry = mEntries[first];
+        if (static_cast<uint64_t>(entry.mNameOffset) + entry.mNameLength > namesSize ||
+            !IsSameAssetPath(std::string_view(mNames + entry.mNameOffset, entry.mNameLength), path))
+        {
+            continue;
+        }
+
+        if (entry.mOffset + entry.mSize > mFile.GetSize())
+        {
+            return false;
+        }
+
+        data = std::string_view(reinterpret_cast<const char*>(mFile.GetData() + entry.mOffset), static_cast<size_t>(entry.mSize));
+        return true;
+    }
+
+    return false;
+}
+
+std::string_view AssetArchive::GetEntryName(uint32_t index) const
+{
+    if (index >= GetEntryCount())
+    {
+        return std::string_view();
+    }
+
+    return std::string_view(mNames + mEntries[index].mNameOffset, mEntries[index].mNameLength);
+}
+
+// ------------------------------------------------------------------------------------------------
+
+AssetManager& AssetManager::Get()
+{
+    static AssetManager assetManager;
+    return assetManager;
+}
+
+bool AssetManager::Mount(std::string_view archivePath)
+{
+    return mArchive.Open(archivePath);
+}
+
+Asset AssetManager::Load(std::string_view path) const
+{
+    Asset asset;
+    if (mArchive.Find(path, asset.mData))
+    {
+        asset.mValid = true;
+        return asset;
+    }
+
+    if (asset.mLooseFile.Open(path, MappedFile::AccessHint::Sequential))
+    {
+        asset.mData = asset.mLooseFile.GetView();
+        asset.mValid = true;
+    }
+
+    return asset;
+}
@@ -0,0 +1,1555 @@
+#include <D3D12Backend.h>
+#include <Assets.h>
+#include <AssetStreamer.h>
+#include <DescriptorAllocator.h>
+#include <Font.h>
+#include <FrameRingAllocator.h>
+#include <PassRecorder.h>
+#include <SkylinePacker.h>
+#include <SpriteBatch.h>
+#include <TextLayout.h>
+#include <Log.h>
+#include <Util.h>
+#include <Window.h>
+
+// This helper library has to be included before any SDK headers
+#include <directx/d3dx12.h>
+
+#include <d3d12.h>
+#include <d3dcompiler.h>
+#include <DirectXMath.h>
+#include <dxcapi.h>
+#include <dxgi1_4.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+
+// Using a #define here because this is used to set uint32_t or size_t in different contexts and I didn't want cast it every time.
+// There is one more back buffer than the default of two frames in flight so presenting doesn't stall on the display.
+#define NUM_BACKBUFFERS 3
+
+// Transient per frame data for the GPU. A single upload buffer is created and mapped once up front and sub-allocated by a
+// FrameRingAllocator, so drawing doesn't create or map any resources once it is running. Anything allocated here is only
+// valid for the frame it was allocated in. Passes are recorded on several threads, so allocating is guarded by a mutex.
+class UploadRing
+{
+public:
+    struct Allocation
+    {
+        void* mCpuAddress;
+        D3D12_GPU_VIRTUAL_ADDRESS mGpuAddress;
+        ID3D12Resource* mResource;      // For copies out of the ring
+        uint64_t mOffset;
+    };
+
+    UploadRing() = default;
+    ~UploadRing();
+
+    void Initialize(ID3D12Device* device, uint64_t capacity);
+
+    // Returns false when the frames in flight have used up the ring. Callers skip their draw for this frame.
+    bool TryAllocate(uint64_t size, Allocation& allocation, uint64_t alignment = 16);
+
+    // The space used by this frame is recycled once the GPU has passed fenceValue
+    void EndFrame(uint64_t fenceValue) { mAllocator.EndFrame(fenceValue); }
+    void Retire(uint64_t completedFenceValue) { mAllocator.Retire(completedFenceValue); }
+
+private:
+    ID3D12Resource* mBuffer = nullptr;
+    uint8_t* mCpuAddress = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS mGpuAddress = 0;
+    FrameRingAllocator mAllocator;
+    std::mutex mMutex;
+};
+
+UploadRing::~UploadRing()
+{
+    if (mBuffer)
+    {
+        mBuffer->Unmap(0, nullptr);
+        mBuffer->Release();
+    }
+}
+
+void UploadRing::Initialize(ID3D12Device* device, uint64_t capacity)
+{
+    ensure(SUCCEEDED(device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+                                                     D3D12_HEAP_FLAG_NONE,
+                                                     &CD3DX12_RESOURCE_DESC::Buffer(capacity),
+                                                     D3D12_RESOURCE_STATE_GENERIC_READ,
+                                                     nullptr,
+                                                     IID_PPV_ARGS(&mBuffer))));
+
+    // Upload heaps can stay mapped for their whole lifetime. We never read from it so the read range is empty.
+    CD3DX12_RANGE readRange(0, 0);
+    ensure(SUCCEEDED(mBuffer->Map(0, &readRange, reinterpret_cast<void**>(&mCpuAddress))));
+    mGpuAddress = mBuffer->GetGPUVirtualAddress();
+
+    mAllocator.Initialize(capacity);
+}
+
+bool UploadRing::TryAllocate(uint64_t size, Allocation& allocation, uint64_t alignment)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    const uint64_t offset = mAllocator.Allocate(size, alignment);
+    lock.unlock();
+
+    if (offset == FrameRingAllocator::InvalidOffset)
+    {
+        return false;
+    }
+
+    allocation = { mCpuAddress + offset, mGpuAddress + offset, mBuffer, offset };
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+
+// The one shader visible CBV/SRV/UAV heap. It is bound once at the start of the frame and every renderer allocates its
+// descriptors from it, so drawing never has to switch heaps. See DescriptorAllocator for how the slots are handed out.
+class DescriptorHeap
+{
+public:
+    DescriptorHeap() = default;
+    ~DescriptorHeap();
+
+    void Initialize(ID3D12Device* device, uint32_t persistentCount, uint32_t transientCount);
+
+    uint32_t AllocatePersistent(uint32_t count = 1);
+    void FreePersistent(uint32_t index, uint32_t count = 1) { mAllocator.FreePersistent(index, count); }
+    uint32_t AllocateTransient(uint32_t count = 1);
+
+    D3D12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(uint32_t index) const { return CD3DX12_CPU_DESCRIPTOR_HANDLE(mCpuStart, index, mDescriptorSize); }
+    D3D12_GPU_DESCRIPTOR_HANDLE GetGpuHandle(uint32_t index) const { return CD3DX12_GPU_DESCRIPTOR_HANDLE(mGpuStart, index, mDescriptorSize); }
+
+    void Bind(ID3D12GraphicsCommandList* commandList);
+
+    void EndFrame(uint64_t fenceValue) { mAllocator.EndFrame(fenceValue); }
+    void Retire(uint64_t completedFenceValue) { mAllocator.Retire(completedFenceValue); }
+
+private:
+    ID3D12DescriptorHeap* mHeap = nullptr;
+    D3D12_CPU_DESCRIPTOR_HANDLE mCpuStart = {};
+    D3D12_GPU_DESCRIPTOR_HANDLE mGpuStart = {};
+    uint32_t mDescriptorSize = 0;
+    DescriptorAllocator mAllocator;
+};
+
+DescriptorHeap::~DescriptorHeap()
+{
+    if (mHeap) mHeap->Release();
+}
+
+void DescriptorHeap::Initialize(ID3D12Device* device, uint32_t persistentCount, uint32_t transientCount)
+{
+    D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+    heapDesc.NumDescriptors = persistentCount + transientCount;
+    heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    ensure(SUCCEEDED(device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&mHeap))));
+
+    mCpuStart = mHeap->GetCPUDescriptorHandleForHeapStart();
+    mGpuStart = mHeap->GetGPUDescriptorHandleForHeapStart();
+    mDescriptorSize = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    mAllocator.Initialize(persistentCount, transientCount);
+}
+
+uint32_t DescriptorHeap::AllocatePersistent(uint32_t count)
+{
+    const uint32_t index = mAllocator.AllocatePersistent(count);
+    ensure(index != DescriptorAllocator::InvalidIndex);
+    return index;
+}
+
+uint32_t DescriptorHeap::AllocateTransient(uint32_t count)
+{
+    const uint32_t index = mAllocator.AllocateTransient(count);
+    ensure(index != DescriptorAllocator::InvalidIndex);
+    return index;
+}
+
+void DescriptorHeap::Bind(ID3D12GraphicsCommandList* commandList)
+{
+    ID3D12DescriptorHeap* heaps[] = { mHeap };
+    commandList->SetDescriptorHeaps(1, heaps);
+}
+
+// ------------------------------------------------------------------------------------------------
+
+// Compiles the VSMain and PSMain entry points of a shader and creates the pipeline state on an AssetStreamer thread so that
+// startup doesn't wait for the shader compiler. pipelineState is only set on the main thread when the streamer dispatches
+// its completion, until then it stays null and the renderer skips its draws. It also stays null if the shader fails to
+// load or compile, or if the streamer is stopped first. Everything psoDesc points to has to outlive the request.
+void RequestPipelineState(ID3D12Device* device, const char* shaderPath, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& psoDesc, ID3D12PipelineState*& pipelineState)
+{
+    std::shared_ptr<ID3D12PipelineState*> result = std::make_shared<ID3D12PipelineState*>(nullptr);
+
+    // The shader comes from the mounted asset archive or from the working directory when the game runs. Make sure to set it in debugging settings.
+    AssetStreamer::Get().Request(shaderPath, AssetPriority::Critical,
+        [device, shaderPath, psoDesc, result](const Asset& shaderSource)
+        {
+#if defined(_DEBUG)
+            UINT compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#else
+            UINT compileFlags = 0;
+#endif
+
+            ID3DBlob* vertexShader = nullptr;
+            ID3DBlob* pixelShader = nullptr;
+            bool created = SUCCEEDED(D3DCompile(shaderSource.GetData(), shaderSource.GetSize(), shaderPath, nullptr, nullptr, "VSMain", "vs_5_0", compileFlags, 0, &vertexShader, nullptr)) &&
+                           SUCCEEDED(D3DCompile(shaderSource.GetData(), shaderSource.GetSize(), shaderPath, nullptr, nullptr, "PSMain", "ps_5_0", compileFlags, 0, &pixelShader, nullptr));
+
+            // The device is free threaded so the pipeline can be created here as well
+            if (created)
+            {
+                D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = psoDesc;
+                desc.VS = CD3DX12_SHADER_BYTECODE(vertexShader);
+                desc.PS = CD3DX12_SHADER_BYTECODE(pixelShader);
+                created = SUCCEEDED(device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(result.get())));
+            }
+
+            if (vertexShader) vertexShader->Release();
+            if (pixelShader) pixelShader->Release();
+            return created;
+        },
+        [shaderPath, result, &pipelineState](bool loaded)
+        {
+            // Stop drops requests that are still queued when the window is closed, so this isn't fatal
+            if (!loaded)
+            {
+                LOG_WARN(Renderer, "No pipeline for %s, its draws are skipped", shaderPath);
+                return;
+            }
+            pipelineState = *result;
+        });
+}
+
+class TriangleRenderer
+{
+public:
+    TriangleRenderer() = default;
+    ~TriangleRenderer();
+
+    void Initialize(ID3D12Device* device, ID3D12GraphicsCommandList* commandList, float width, float height);
+
+    void Render(ID3D12GraphicsCommandList* commandList, UploadRing& uploadRing);
+
+private:
+
+    struct Vertex
+    {
+        DirectX::XMFLOAT3 position;
+        DirectX::XMFLOAT4 color;
+    };
+
+    CD3DX12_VIEWPORT mViewport;
+    CD3DX12_RECT mScissorRect;
+
+    ID3D12RootSignature* mRootSignature;
+    ID3D12PipelineState* mPipelineState = nullptr;
+    std::array<Vertex, 3> mVertices;
+};
+
+TriangleRenderer::~TriangleRenderer()
+{
+    mRootSignature->Release();
+    if (mPipelineState) mPipelineState->Release();
+}
+
+void TriangleRenderer::Initialize(ID3D12Device* device, ID3D12GraphicsCommandList* commandList, float width, float height)
+{
+    float aspectRatio = width / height;
+    mViewport.TopLeftX = 0.0f;
+    mViewport.TopLeftY = 0.0f;
+    mViewport.Width = width;
+    mViewport.Height = height;
+    mViewport.MinDepth = D3D12_MIN_DEPTH;
+    mViewport.MaxDepth = D3D12_MAX_DEPTH;
+
+    mScissorRect.left = 0;
+    mScissorRect.top = 0;
+    mScissorRect.right= static_cast<uint64_t>(width);
+    mScissorRect.bottom = static_cast<uint64_t>(height);
+
+    // Create a root signature. This data structure describes what resources are bound to the pipeline at each shader stage.
+    // In our case, we don't need anything yet.
+    {
+        D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc;
+        rootSignatureDesc.NumParameters = 0;
+        rootSignatureDesc.pParameters = nullptr;
+        rootSignatureDesc.NumStaticSamplers = 0;
+        rootSignatureDesc.pStaticSamplers = nullptr;
+        rootSignatureDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+        ID3DBlob* signature;
+        ID3DBlob* error;
+        ensure(SUCCEEDED(D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error)));
+        ensure(SUCCEEDED(device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&mRootSignature))));
+    }
+
+    // Create our pipeline. The shader is compiled in the background, see RequestPipelineState.
+    {
+        // Define the layout for the vertex shader input.
+        static const D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        // Create the pipeline state object (PSO). This describes everything required to run this specific shader.
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+        psoDesc.InputLayout = { inputElementDescs, _countof(inputElementDescs) };
+        psoDesc.pRootSignature = mRootSignature;
+        psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+        psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+        psoDesc.DepthStencilState.DepthEnable = FALSE;
+        psoDesc.DepthStencilState.StencilEnable = FALSE;
+        psoDesc.SampleMask = UINT_MAX;
+        psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+        psoDesc.NumRenderTargets = 1;
+        psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+        psoDesc.SampleDesc.Count = 1;
+        RequestPipelineState(device, "data/basic.hlsl", psoDesc, mPipelineState);
+    }
+
+    // The vertices are copied into the upload ring every frame. There are only three of them so that is cheaper than keeping
+    // a buffer around for them.
+    mVertices =
+    {{
+        { { 0.0f, 0.25f * aspectRatio, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+        { { 0.25f, -0.25f * aspectRatio, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
+        { { -0.25f, -0.25f * aspectRatio, 0.0f }, { 0.0f, 0.0f, 1.0f, 1.0f } }
+    }};
+}
+
+void TriangleRenderer::Render(ID3D12GraphicsCommandList* commandList, UploadRing& uploadRing)
+{
+    // The pipeline is still being created in the background
+    if (mPipelineState == nullptr)
+    {
+        return;
+    }
+
+    UploadRing::Allocation vertices;
+    if (!uploadRing.TryAllocate(sizeof(mVertices), vertices))
+    {
+        LOG_WARN(Renderer, "Upload ring is full, dropped the triangle");
+        return;
+    }
+    memcpy(vertices.mCpuAddress, mVertices.data(), sizeof(mVertices));
+
+    commandList->SetGraphicsRootSignature(mRootSignature);
+    commandList->SetPipelineState(mPipelineState);
+    commandList->RSSetViewports(1, &mViewport);
+    commandList->RSSetScissorRects(1, &mScissorRect);
+
+    const D3D12_VERTEX_BUFFER_VIEW vertexBufferView = { vertices.mGpuAddress, sizeof(mVertices), sizeof(Vertex) };
+
+    // This is the actual stuff we are drawing
+    commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+    commandList->DrawInstanced(3, 1, 0, 0);
+}
+
+// ------------------------------------------------------------------------------------------------
+
+class TexturedTriangleRenderer
+{
+public:
+    TexturedTriangleRenderer() = default;
+    ~TexturedTriangleRenderer();
+
+    void Initialize(ID3D12Device* device, ID3D12GraphicsCommandList* commandList, DescriptorHeap& descriptorHeap, float width, float height);
+    void Render(ID3D12GraphicsCommandList* commandList, UploadRing& uploadRing);
+
+private:
+    static constexpr uint32_t TextureWidth = 256;
+    static constexpr uint32_t TextureHeight = 256;
+    static constexpr uint32_t TexturePixelSize = 4;
+
+    struct Vertex
+    {
+        DirectX::XMFLOAT3 position;
+        DirectX::XMFLOAT2 uv;
+    };
+
+    CD3DX12_VIEWPORT mViewport;
+    CD3DX12_RECT mScissorRect;
+
+    ID3D12RootSignature* mRootSignature;
+    ID3D12PipelineState* mPipelineState = nullptr;
+    std::array<Vertex, 3> mVertices;
+
+    DescriptorHeap* mDescriptorHeap = nullptr;
+    uint32_t mSrvIndex = DescriptorAllocator::InvalidIndex;
+    ID3D12Resource* mTexture;
+};
+
+TexturedTriangleRenderer::~TexturedTriangleRenderer()
+{
+    mRootSignature->Release();
+    if (mPipelineState) mPipelineState->Release();
+    mTexture->Release();
+    mDescriptorHeap->FreePersistent(mSrvIndex);
+}
+
+void TexturedTriangleRenderer::Initialize(ID3D12Device* device, ID3D12GraphicsCommandList* commandList, DescriptorHeap& descriptorHeap, float width, float height)
+{
+    float aspectRatio = width / height;
+    mViewport.TopLeftX = 0.0f;
+    mViewport.TopLeftY = 0.0f;
+    mViewport.Width = width;
+    mViewport.Height = height;
+    mViewport.MinDepth = D3D12_MIN_DEPTH;
+    mViewport.MaxDepth = D3D12_MAX_DEPTH;
+
+    mScissorRect.left = 0;
+    mScissorRect.top = 0;
+    mScissorRect.right= static_cast<uint64_t>(width);
+    mScissorRect.bottom = static_cast<uint64_t>(height);
+
+    // Reserve a descriptor for the texture's shader resource view (SRV)
+    mDescriptorHeap = &descriptorHeap;
+    mSrvIndex = descriptorHeap.AllocatePersistent();
+
+    // Create root signature
+    {
+        CD3DX12_DESCRIPTOR_RANGE ranges[1];
+        ranges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);  // 1 SRV at register t0
+
+        CD3DX12_ROOT_PARAMETER rootParameters[1];
+        rootParameters[0].InitAsDescriptorTable(1, &ranges[0], D3D12_SHADER_VISIBILITY_PIXEL);
+
+        D3D12_STATIC_SAMPLER_DESC sampler = {};
+        sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
+        sampler.AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+        sampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+        sampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+        sampler.MipLODBias = 0;
+        sampler.MaxAnisotropy = 0;
+        sampler.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+        sampler.BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+        sampler.MinLOD = 0.0f;
+        sampler.MaxLOD = D3D12_FLOAT32_MAX;
+        sampler.ShaderRegister = 0;  // This matches s0 in the shader
+        sampler.RegisterSpace = 0;
+        sampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+        CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc;
+        rootSignatureDesc.Init((UINT)1, rootParameters, (UINT)1, &sampler, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+
+        ID3DBlob* signature;
+        ID3DBlob* error;
+        ensure(SUCCEEDED(D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error)));
+        ensure(SUCCEEDED(device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&mRootSignature))));
+        
+        signature->Release();
+        if (error) error->Release();
+    }
+
+    // Create our pipeline. The shader is compiled in the background, see RequestPipelineState.
+    {
+        // Define the layout for the vertex shader input.
+        static const D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        // Create the pipeline state object (PSO). This describes everything required to run this specific shader.
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+        psoDesc.InputLayout = { inputElementDescs, _countof(inputElementDescs) };
+        psoDesc.pRootSignature = mRootSignature;
+        psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+        psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+        psoDesc.DepthStencilState.DepthEnable = FALSE;
+        psoDesc.DepthStencilState.StencilEnable = FALSE;
+        psoDesc.SampleMask = UINT_MAX;
+        psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+        psoDesc.NumRenderTargets = 1;
+        psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+        psoDesc.SampleDesc.Count = 1;
+        RequestPipelineState(device, "data/textured.hlsl", psoDesc, mPipelineState);
+    }
+
+    // The vertices are copied into the upload ring every frame
+    mVertices =
+    {{
+        { { 0.0f, 0.25f * aspectRatio, 0.0f }, { 0.5f, 0.0f } },
+        { { 0.25f, -0.25f * aspectRatio, 0.0f }, { 1.0f, 1.0f } },
+        { { -0.25f, -0.25f * aspectRatio, 0.0f }, { 0.0f, 1.0f } }
+    }};
+
+    {
+        // Describe and create a Texture2D.
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        textureDesc.Width = TextureWidth;
+        textureDesc.Height = TextureHeight;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        ensure(SUCCEEDED(device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+                                                         D3D12_HEAP_FLAG_NONE,
+                                                         &textureDesc,
+                                                         D3D12_RESOURCE_STATE_COPY_DEST,
+                                                         nullptr,
+                                                         IID_PPV_ARGS(&mTexture))));
+
+        const UINT64 uploadBufferSize = GetRequiredIntermediateSize(mTexture, 0, 1);
+
+        // Create the GPU upload buffer.
+        ID3D12Resource* textureUploadHeap;
+        ensure(SUCCEEDED(device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+                                                         D3D12_HEAP_FLAG_NONE,
+                                                         &CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize),
+                                                         D3D12_RESOURCE_STATE_GENERIC_READ,
+                                                         nullptr,
+                                                         IID_PPV_ARGS(&textureUploadHeap))));
+
+        std::vector<uint8_t> texture = GenerateTextureData(TextureWidth, TextureHeight, TexturePixelSize);
+
+        D3D12_SUBRESOURCE_DATA textureData = {};
+        textureData.pData = &texture[0];
+        textureData.RowPitch = TextureWidth * TexturePixelSize;
+        textureData.SlicePitch = textureData.RowPitch * TextureHeight;
+
+        // This is a helper function in d3dx12.h that copies data to a default heap (used by the texture) via the upload heap using CopyTextureRegion.
+        UpdateSubresources(commandList, mTexture, textureUploadHeap, 0, 0, 1, &textureData);
+        commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mTexture, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+
+        // Describe and create a SRV for the texture.
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Format = textureDesc.Format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(mTexture, &srvDesc, descriptorHeap.GetCpuHandle(mSrvIndex));
+    }
+}
+
+void TexturedTriangleRenderer::Render(ID3D12GraphicsCommandList* commandList, UploadRing& uploadRing)
+{
+    // The pipeline is still being created in the background
+    if (mPipelineState == nullptr)
+    {
+        return;
+    }
+
+    UploadRing::Allocation vertices;
+    if (!uploadRing.TryAllocate(sizeof(mVertices), vertices))
+    {
+        LOG_WARN(Renderer, "Upload ring is full, dropped the textured triangle");
+        return;
+    }
+    memcpy(vertices.mCpuAddress, mVertices.data(), sizeof(mVertices));
+
+    // The shared descriptor heap is already bound for the frame
+    commandList->SetGraphicsRootSignature(mRootSignature);
+    commandList->SetPipelineState(mPipelineState);
+    commandList->SetGraphicsRootDescriptorTable(0, mDescriptorHeap->GetGpuHandle(mSrvIndex));
+    commandList->RSSetViewports(1, &mViewport);
+    commandList->RSSetScissorRects(1, &mScissorRect);
+
+    const D3D12_VERTEX_BUFFER_VIEW vertexBufferView = { vertices.mGpuAddress, sizeof(mVertices), sizeof(Vertex) };
+
+    // This is the actual stuff we are drawing
+    commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+    commandList->DrawInstanced(3, 1, 0, 0);
+}
+
+// ------------------------------------------------------------------------------------------------
+
+class SpriteRenderer
+{
+public:
+    SpriteRenderer() = default;
+    ~SpriteRenderer();
+
+    void Initialize(ID3D12Device* device, DescriptorHeap& descriptorHeap, float screenWidth, float screenHeight);
+    void Render(ID3D12GraphicsCommandList* commandList, UploadRing& uploadRing, SpriteBatch& batch);
+
+    SpriteImage CreateImage(uint32_t width, uint32_t height, const uint8_t* pixels);
+
+private:
+    uint32_t CreatePage(uint32_t width, uint32_t height);
+    void UploadImages(ID3D12GraphicsCommandList* commandList, UploadRing& uploadRing);
+
+    // Images are packed into shared pages so that sprites from different images still batch into one draw. An image that
+    // is larger than a page gets a page of its own.
+    static constexpr uint32_t PageSize = 1024;
+    static constexpr uint32_t MaxPages = UINT16_MAX;        // Page indices have to fit in a SpriteTexture
+
+    struct Page
+    {
+        ID3D12Resource* mResource = nullptr;
+        uint32_t mSrvIndex = DescriptorAllocator::InvalidIndex;
+        D3D12_RESOURCE_STATES mState = D3D12_RESOURCE_STATE_COPY_DEST;
+        SkylinePacker mPacker;
+        uint32_t mPendingUploads = 0;       // Sprites on the page aren't drawn while some of its images are missing
+    };
+
+    struct PendingUpload
+    {
+        SpriteTexture mPage;
+        AtlasRect mRect;
+        std::vector<uint8_t> mPixels;       // RGBA8
+    };
+
+    ID3D12Device* mDevice = nullptr;
+
+    CD3DX12_VIEWPORT mViewport;
+    CD3DX12_RECT mScissorRect;
+    float mScreenWidth = 0;
+    float mScreenHeight = 0;
+
+    ID3D12RootSignature* mRootSignature = nullptr;
+    std::array<ID3D12PipelineState*, static_cast<size_t>(SpriteBlend::Count)> mPipelineStates = {};
+    DescriptorHeap* mDescriptorHeap = nullptr;
+
+    std::vector<Page> mPages;
+    std::vector<PendingUpload> mPendingUploads;
+
+    std::vector<SpriteDraw> mDraws;
+};
+
+SpriteRenderer::~SpriteRenderer()
+{
+    mRootSignature->Release();
+    for (ID3D12PipelineState* pipelineState : mPipelineStates)
+    {
+        if (pipelineState) pipelineState->Release();
+    }
+    for (Page& page : mPages)
+    {
+        page.mResource->Release();
+        mDescriptorHeap->FreePersistent(page.mSrvIndex);
+    }
+}
+
+void SpriteRenderer::Initialize(ID3D12Device* device, DescriptorHeap& descriptorHeap, float screenWidth, float screenHeight)
+{
+    mDevice = device;
+    mDescriptorHeap = &descriptorHeap;
+    mScreenWidth = screenWidth;
+    mScreenHeight = screenHeight;
+    mViewport = CD3DX12_VIEWPORT(0.0f, 0.0f, screenWidth, screenHeight);
+    mScissorRect = CD3DX12_RECT(0, 0, static_cast<LONG>(screenWidth), static_cast<LONG>(screenHeight));
+
+    // Same layout as the text, a texture for the pixel shader and the screen size for the vertex shader
+    {
+        CD3DX12_DESCRIPTOR_RANGE ranges[1];
+        ranges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
+
+        CD3DX12_ROOT_PARAMETER rootParameters[2];
+        rootParameters[0].InitAsDescriptorTable(1, &ranges[0], D3D12_SHADER_VISIBILITY_PIXEL);
+        rootParameters[1].InitAsConstants(2, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+
+        D3D12_STATIC_SAMPLER_DESC sampler = {};
+        sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
+        sampler.AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+        sampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+        sampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+        sampler.MipLODBias = 0;
+        sampler.MaxAnisotropy = 0;
+        sampler.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+        sampler.BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+        sampler.MinLOD = 0.0f;
+        sampler.MaxLOD = D3D12_FLOAT32_MAX;
+        sampler.ShaderRegister = 0;
+        sampler.RegisterSpace = 0;
+        sampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+        CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc;
+        rootSignatureDesc.Init(_countof(rootParameters), rootParameters, 1, &sampler, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+
+        ID3DBlob* signature;
+        ID3DBlob* error;
+        ensure(SUCCEEDED(D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error)));
+        ensure(SUCCEEDED(device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&mRootSignature))));
+        signature->Release();
+        if (error) error->Release();
+    }
+
+    // One pipeline per blend mode, they only differ in the blend state
+    {
+        static const D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "RECT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 16, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 }
+        };
+
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+        psoDesc.InputLayout = { inputElementDescs, _countof(inputElementDescs) };
+        psoDesc.pRootSignature = mRootSignature;
+        psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+        psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+        psoDesc.DepthStencilState.DepthEnable = FALSE;
+        psoDesc.DepthStencilState.StencilEnable = FALSE;
+        psoDesc.SampleMask = UINT_MAX;
+        psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+        psoDesc.NumRenderTargets = 1;
+        psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+        psoDesc.SampleDesc.Count = 1;
+        RequestPipelineState(device, "data/sprite.hlsl", psoDesc, mPipelineStates[static_cast<size_t>(SpriteBlend::Opaque)]);
+
+        psoDesc.BlendState.RenderTarget[0].BlendEnable = TRUE;
+        psoDesc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
+        psoDesc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+        psoDesc.BlendState.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
+        psoDesc.BlendState.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_ONE;
+        psoDesc.BlendState.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_ZERO;
+        psoDesc.BlendState.RenderTarget[0].BlendOpAlpha = D3D12_BLEND_OP_ADD;
+        psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+        RequestPipelineState(device, "data/sprite.hlsl", psoDesc, mPipelineStates[static_cast<size_t>(SpriteBlend::Alpha)]);
+    }
+}
+
+SpriteImage SpriteRenderer::CreateImage(uint32_t width, uint32_t height, const uint8_t* pixels)
+{
+    SpriteTexture pageIndex = 0;
+    AtlasRect rect;
+    while (pageIndex < mPages.size() && !mPages[pageIndex].mPacker.Allocate(width, height, rect))
+    {
+        ++pageIndex;
+    }
+
+    if (pageIndex == mPages.size())
+    {
+        pageIndex = static_cast<SpriteTexture>(CreatePage(std::max(width, PageSize), std::max(height, PageSize)));
+        ensure(mPages[pageIndex].mPacker.Allocate(width, height, rect));
+    }
+
+    // The pixels are copied to the GPU the next time sprites are rendered, when there is a command list to record it on
+    PendingUpload& upload = mPendingUploads.emplace_back();
+    upload.mPage = pageIndex;
+    upload.mRect = rect;
+    upload.mPixels.assign(pixels, pixels + width * height * 4);
+    ++mPages[pageIndex].mPendingUploads;
+
+    const SkylinePacker& packer = mPages[pageIndex].mPacker;
+    const float pageWidth = static_cast<float>(packer.GetWidth());
+    const float pageHeight = static_cast<float>(packer.GetHeight());
+    return { pageIndex, rect.mX / pageWidth, rect.mY / pageHeight, (rect.mX + rect.mWidth) / pageWidth, (rect.mY + rect.mHeight) / pageHeight };
+}
+
+uint32_t SpriteRenderer::CreatePage(uint32_t width, uint32_t height)
+{
+    ensure(mPages.size() < MaxPages);
+    const uint32_t index = static_cast<uint32_t>(mPages.size());
+
+    Page& page = mPages.emplace_back();
+    page.mPacker.Initialize(width, height);
+    ensure(SUCCEEDED(mDevice->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+                                                      D3D12_HEAP_FLAG_NONE,
+                                                      &CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, width, height, 1, 1),
+                                                      D3D12_RESOURCE_STATE_COPY_DEST,
+                                                      nullptr,
+                                                      IID_PPV_ARGS(&page.mResource))));
+    page.mState = D3D12_RESOURCE_STATE_COPY_DEST;
+
+    D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MipLevels = 1;
+    page.mSrvIndex = mDescriptorHeap->AllocatePersistent();
+    mDevice->CreateShaderResourceView(page.mResource, &srvDesc, mDescriptorHeap->GetCpuHandle(page.mSrvIndex));
+
+    return index;
+}
+
+void SpriteRenderer::UploadImages(ID3D12GraphicsCommandList* commandList, UploadRing& uploadRing)
+{
+    size_t remaining = 0;
+    for (PendingUpload& upload : mPendingUploads)
+    {
+        Page& page = mPages[upload.mPage];
+
+        // Rows of a placed footprint have to be 256 byte aligned
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint = {};
+        footprint.Footprint = { DXGI_FORMAT_R8G8B8A8_UNORM, upload.mRect.mWidth, upload.mRect.mHeight, 1, 0 };
+        footprint.Footprint.RowPitch = (upload.mRect.mWidth * 4 + D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1) & ~(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1);
+
+        // An image that doesn't fit in the ring this frame is tried again next frame
+        UploadRing::Allocation allocation;
+        if (!uploadRing.TryAllocate(static_cast<uint64_t>(footprint.Footprint.RowPitch) * upload.mRect.mHeight, allocation, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT))
+        {
+            mPendingUploads[remaining++] = std::move(upload);
+            continue;
+        }
+
+        for (uint32_t row = 0; row < upload.mRect.mHeight; ++row)
+        {
+            memcpy(static_cast<uint8_t*>(allocation.mCpuAddress) + row * footprint.Footprint.RowPitch, upload.mPixels.data() + row * upload.mRect.mWidth * 4, upload.mRect.mWidth * 4);
+        }
+        footprint.Offset = allocation.mOffset;
+
+        if (page.mState != D3D12_RESOURCE_STATE_COPY_DEST)
+        {
+            commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(page.mResource, page.mState, D3D12_RESOURCE_STATE_COPY_DEST));
+            page.mState = D3D12_RESOURCE_STATE_COPY_DEST;
+        }
+
+        const CD3DX12_TEXTURE_COPY_LOCATION destination(page.mResource, 0);
+        const CD3DX12_TEXTURE_COPY_LOCATION source(allocation.mResource, footprint);
+        commandList->CopyTextureRegion(&destination, upload.mRect.mX, upload.mRect.mY, 0, &source, nullptr);
+        --page.mPendingUploads;
+    }
+    mPendingUploads.resize(remaining);
+
+    for (Page& page : mPages)
+    {
+        if (page.mState != D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE)
+        {
+            commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(page.mResource, page.mState, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+            page.mState = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        }
+    }
+}
+
+void SpriteRenderer::Render(ID3D12GraphicsCommandList* commandList, UploadRing& uploadRing, SpriteBatch& batch)
+{
+    UploadImages(commandList, uploadRing);
+
+    if (batch.IsEmpty())
+    {
+        return;
+    }
+
+    // All sprites of the frame go in one instance buffer, each draw starts at its first instance. Like debug text, the
+    // sprites are dropped for this frame when the frames in flight have used up the ring.
+    const uint32_t spriteCount = batch.GetSpriteCount();
+    UploadRing::Allocation allocation;
+    if (!uploadRing.TryAllocate(spriteCount * sizeof(SpriteInstance), allocation))
+    {
+        LOG_WARN(Renderer, "Upload ring is full, dropped %u sprites", spriteCount);
+        return;
+    }
+
+    mDraws.clear();
+    batch.Build(static_cast<SpriteInstance*>(allocation.mCpuAddress), mDraws);
+
+    const float screenSize[] = { mScreenWidth, mScreenHeight };
+    commandList->SetGraphicsRootSignature(mRootSignature);
+    commandList->SetGraphicsRoot32BitConstants(1, 2, screenSize, 0);
+    commandList->RSSetViewports(1, &mViewport);
+    commandList->RSSetScissorRects(1, &mScissorRect);
+
+    const D3D12_VERTEX_BUFFER_VIEW instanceBufferView = { allocation.mGpuAddress, spriteCount * static_cast<UINT>(sizeof(SpriteInstance)), sizeof(SpriteInstance) };
+    commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+    commandList->IASetVertexBuffers(0, 1, &instanceBufferView);
+
+    // The draws are sorted, so state only changes between runs of different pipelines or textures
+    ID3D12PipelineState* currentPipelineState = nullptr;
+    uint32_t currentTexture = ~0u;
+    for (const SpriteDraw& draw : mDraws)
+    {
+        // Skip sprites whose pipeline is still compiling or whose page is missing some of its images
+        ID3D12PipelineState* pipelineState = mPipelineStates[static_cast<size_t>(draw.mBlend)];
+        if (pipelineState == nullptr || draw.mTexture >= mPages.size() || mPages[draw.mTexture].mPendingUploads > 0)
+        {
+            continue;
+        }
+
+        if (pipelineState != currentPipelineState)
+        {
+            commandList->SetPipelineState(pipelineState);
+            currentPipelineState = pipelineState;
+        }
+        if (draw.mTexture != currentTexture)
+        {
+            commandList->SetGraphicsRootDescriptorTable(0, mDescriptorHeap->GetGpuHandle(mPages[draw.mTexture].mSrvIndex));
+            currentTexture = draw.mTexture;
+        }
+
+        commandList->DrawInstanced(4, draw.mInstanceCount, 0, draw.mFirstInstance);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+
+class TextRenderer
+{
+public:
+    TextRenderer() = default;
+    ~TextRenderer();
+
+    void Initialize(ID3D12Device* device, ID3D12GraphicsCommandList* commandList, DescriptorHeap& descriptorHeap, float screenWidth, float screenHeight);
+    void Render(ID3D12GraphicsCommandList* commandList, UploadRing& uploadRing, RetainedText& retainedText, const GlyphPageArena& debugText);
+
+private:
+    void UploadRetainedText(ID3D12GraphicsCommandList* commandList, UploadRing& uploadRing, RetainedText& retainedText);
+
+    CD3DX12_VIEWPORT mViewport;
+    CD3DX12_RECT mScissorRect;
+
+    ID3D12RootSignature* mRootSignature = nullptr;
+    ID3D12PipelineState* mPipelineState = nullptr;
+    DescriptorHeap* mDescriptorHeap = nullptr;
+    uint32_t mSrvIndex = DescriptorAllocator::InvalidIndex;
+    ID3D12Resource* mFontTexture = nullptr;
+
+    // Retained text lives in a default heap buffer that is only written when a label changes
+    std::vector<RetainedText::SlotRange> mRetainedChanges;
+    ID3D12Resource* mRetainedBuffer = nullptr;
+    D3D12_RESOURCE_STATES mRetainedBufferState = D3D12_RESOURCE_STATE_COPY_DEST;
+
+    float mScreenWidth = 0;
+    float mScreenHeight = 0;
+}; 
+
+TextRenderer::~TextRenderer()
+{
+    mRootSignature->Release();
+    if (mPipelineState) mPipelineState->Release();
+    mFontTexture->Release();
+    mDescriptorHeap->FreePersistent(mSrvIndex);
+    mRetainedBuffer->Release();
+}
+
+void TextRenderer::Initialize(ID3D12Device* device, ID3D12GraphicsCommandList* commandList, DescriptorHeap& descriptorHeap, float screenWidth, float screenHeight)
+{
+    mScreenWidth = screenWidth;
+    mScreenHeight = screenHeight;
+
+    mViewport = CD3DX12_VIEWPORT(0.0f, 0.0f, screenWidth, screenHeight);
+    mScissorRect = CD3DX12_RECT(0, 0, static_cast<LONG>(screenWidth), static_cast<LONG>(screenHeight));
+
+    // Reserve a descriptor for the font texture
+    mDescriptorHeap = &descriptorHeap;
+    mSrvIndex = descriptorHeap.AllocatePersistent();
+
+    // Create root signature
+    {
+        CD3DX12_DESCRIPTOR_RANGE ranges[1];
+        ranges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
+
+        // The screen size goes in root constants so the vertex shader can turn pixel positions into clip space
+        CD3DX12_ROOT_PARAMETER rootParameters[2];
+        rootParameters[0].InitAsDescriptorTable(1, &ranges[0], D3D12_SHADER_VISIBILITY_PIXEL);
+        rootParameters[1].InitAsConstants(2, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+
+        D3D12_STATIC_SAMPLER_DESC sampler = {};
+        sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
+        sampler.AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+        sampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+        sampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+        sampler.MipLODBias = 0;
+        sampler.MaxAnisotropy = 0;
+        sampler.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+        sampler.BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+        sampler.MinLOD = 0.0f;
+        sampler.MaxLOD = D3D12_FLOAT32_MAX;
+        sampler.ShaderRegister = 0;
+        sampler.RegisterSpace = 0;
+        sampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+        CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc;
+        rootSignatureDesc.Init(_countof(rootParameters), rootParameters, 1, &sampler, 
+            D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+
+        ID3DBlob* signature;
+        ID3DBlob* error;
+        ensure(SUCCEEDED(D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error)));
+        ensure(SUCCEEDED(device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&mRootSignature))));
+        signature->Release();
+        if (error) error->Release();
+    }
+
+    // Create pipeline state. The shader is compiled in the background, see RequestPipelineState.
+    {
+        // There is no per vertex data, only a GlyphInstance per glyph
+        static const D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R16G16_SINT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "GLYPH", 0, DXGI_FORMAT_R32_UINT, 0, 4, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 }
+        };
+
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+        psoDesc.InputLayout = { inputElementDescs, _countof(inputElementDescs) };
+        psoDesc.pRootSignature = mRootSignature;
+        psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+        psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+        psoDesc.DepthStencilState.DepthEnable = FALSE;
+        psoDesc.DepthStencilState.StencilEnable = FALSE;
+        psoDesc.SampleMask = UINT_MAX;
+        psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+        psoDesc.NumRenderTargets = 1;
+        psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+        psoDesc.SampleDesc.Count = 1;
+
+        // Enable alpha blending
+        psoDesc.BlendState.RenderTarget[0].BlendEnable = TRUE;
+        psoDesc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
+        psoDesc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+        psoDesc.BlendState.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
+        psoDesc.BlendState.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_ONE;
+        psoDesc.BlendState.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_ZERO;
+        psoDesc.BlendState.RenderTarget[0].BlendOpAlpha = D3D12_BLEND_OP_ADD;
+        psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+        RequestPipelineState(device, "data/text.hlsl", psoDesc, mPipelineState);
+    }
+
+    // Create font texture
+    {
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = Font::SingleChannelAtlas ? DXGI_FORMAT_R8_UNORM : DXGI_FORMAT_R8G8B8A8_UNORM;
+        textureDesc.Width = Font::TextureWidth;
+        textureDesc.Height = Font::TextureHeight;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+
+        ensure(SUCCEEDED(device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+                                                         D3D12_HEAP_FLAG_NONE,
+                                                         &textureDesc,
+                                                         D3D12_RESOURCE_STATE_COPY_DEST,
+                                                         nullptr,
+                                                         IID_PPV_ARGS(&mFontTexture))));
+
+        const UINT64 uploadBufferSize = GetRequiredIntermediateSize(mFontTexture, 0, 1);
+        ID3D12Resource* textureUploadHeap;
+        ensure(SUCCEEDED(device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+                                                         D3D12_HEAP_FLAG_NONE,
+                                                         &CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize),
+                                                         D3D12_RESOURCE_STATE_GENERIC_READ,
+                                                         nullptr,
+                                                         IID_PPV_ARGS(&textureUploadHeap))));
+
+        // The atlas was built by the compiler so this is just a copy into the upload heap
+        D3D12_SUBRESOURCE_DATA textureSubresourceData = {};
+        textureSubresourceData.pData = Font::Atlas.data();
+        textureSubresourceData.RowPitch = Font::TextureWidth * Font::TexturePixelSize;
+        textureSubresourceData.SlicePitch = textureSubresourceData.RowPitch * Font::TextureHeight;
+
+        UpdateSubresources(commandList, mFontTexture, textureUploadHeap, 0, 0, 1, &textureSubresourceData);
+        commandList->ResourceBarrier(1,
+                                     &CD3DX12_RESOURCE_BARRIER::Transition(mFontTexture, 
+                                                                           D3D12_RESOURCE_STATE_COPY_DEST,
+                                                                           D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Format = textureDesc.Format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(mFontTexture, &srvDesc, descriptorHeap.GetCpuHandle(mSrvIndex));
+    }
+
+    // Create the buffer for retained text. It starts out in the copy destination state, ready for the first upload.
+    {
+        ensure(SUCCEEDED(device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+                                                         D3D12_HEAP_FLAG_NONE,
+                                                         &CD3DX12_RESOURCE_DESC::Buffer(RenderBackend::MaxRetainedGlyphs * sizeof(GlyphInstance)),
+                                                         D3D12_RESOURCE_STATE_COPY_DEST,
+                                                         nullptr,
+                                                         IID_PPV_ARGS(&mRetainedBuffer))));
+        mRetainedBufferState = D3D12_RESOURCE_STATE_COPY_DEST;
+    }
+}
+
+void TextRenderer::UploadRetainedText(ID3D12GraphicsCommandList* commandList, UploadRing& uploadRing, RetainedText& retainedText)
+{
+    if (!retainedText.HasChanges())
+    {
+        return;
+    }
+
+    // Lay out the labels that changed into the upload ring and copy them over the old instances. The copies are queued
+    // on the GPU ahead of the draws, so frames that are still in flight keep drawing the old text.
+    // When the frames in flight have used up the ring the changes stay pending and the old text is drawn until next frame.
+    UploadRing::Allocation allocation;
+    if (!uploadRing.TryAllocate(retainedText.GetChangedSlotCount() * sizeof(GlyphInstance), allocation))
+    {
+        LOG_WARN(Renderer, "Upload ring is full, retained text changes wait for the next frame");
+        return;
+    }
+
+    mRetainedChanges.clear();
+    retainedText.FlushChanges(static_cast<GlyphInstance*>(allocation.mCpuAddress), mRetainedChanges);
+
+    if (mRetainedBufferState != D3D12_RESOURCE_STATE_COPY_DEST)
+    {
+        commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mRetainedBuffer, mRetainedBufferState, D3D12_RESOURCE_STATE_COPY_DEST));
+    }
+
+    uint64_t sourceOffset = allocation.mOffset;
+    for (const RetainedText::SlotRange& range : mRetainedChanges)
+    {
+        const uint64_t size = range.mCount * sizeof(GlyphInstance);
+        commandList->CopyBufferRegion(mRetainedBuffer, range.mFirst * sizeof(GlyphInstance), allocation.mResource, sourceOffset, size);
+        sourceOffset += size;
+    }
+
+    commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mRetainedBuffer, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER));
+    mRetainedBufferState = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
+}
+
+void TextRenderer::Render(ID3D12GraphicsCommandList* commandList, UploadRing& uploadRing, RetainedText& retainedText, const GlyphPageArena& debugText)
+{
+    // The pipeline is still being created in the background. This frame's debug text is dropped, retained text keeps its
+    // changes until it can be drawn.
+    if (mPipelineState == nullptr)
+    {
+        return;
+    }
+
+    UploadRetainedText(commandList, uploadRing, retainedText);
+
+    const uint32_t retainedCount = mRetainedBufferState == D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER ? retainedText.GetSlotCount() : 0;
+    if (retainedCount == 0 && debugText.IsEmpty())
+    {
+        return;
+    }
+
+    const float screenSize[] = { mScreenWidth, mScreenHeight };
+    commandList->SetGraphicsRootSignature(mRootSignature);
+    commandList->SetPipelineState(mPipelineState);
+    commandList->SetGraphicsRootDescriptorTable(0, mDescriptorHeap->GetGpuHandle(mSrvIndex));
+    commandList->SetGraphicsRoot32BitConstants(1, 2, screenSize, 0);
+
+    commandList->RSSetViewports(1, &mViewport);
+    commandList->RSSetScissorRects(1, &mScissorRect);
+
+    // Every glyph is a 4 vertex strip that the vertex shader expands from the instance data
+    commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+
+    // Retained text is drawn straight out of its buffer. Unused slots hold hidden glyphs.
+    if (retainedCount > 0)
+    {
+        const D3D12_VERTEX_BUFFER_VIEW retainedBufferView = { mRetainedBuffer->GetGPUVirtualAddress(), retainedCount * static_cast<UINT>(sizeof(GlyphInstance)), sizeof(GlyphInstance) };
+        commandList->IASetVertexBuffers(0, 1, &retainedBufferView);
+        commandList->DrawInstanced(4, retainedCount, 0, 0);
+    }
+
+    // Debug text is already laid out, each page is copied into the ring and drawn on its own
+    for (uint32_t pageIndex = 0; pageIndex < debugText.GetUsedPageCount(); ++pageIndex)
+    {
+        const GlyphPageArena::Page& page = debugText.GetPage(pageIndex);
+        const uint32_t size = page.mCount * static_cast<uint32_t>(sizeof(GlyphInstance));
+
+        // Rather than failing, drop the rest of the text when the frames in flight have used up the ring
+        UploadRing::Allocation allocation;
+        if (!uploadRing.TryAllocate(size, allocation))
+        {
+            LOG_WARN(Renderer, "Upload ring is full, dropped %u glyphs of debug text", debugText.GetGlyphCount() - pageIndex * GlyphPageArena::GlyphsPerPage);
+            break;
+        }
+
+        memcpy(allocation.mCpuAddress, page.mGlyphs.get(), size);
+
+        const D3D12_VERTEX_BUFFER_VIEW instanceBufferView = { allocation.mGpuAddress, size, sizeof(GlyphInstance) };
+        commandList->IASetVertexBuffers(0, 1, &instanceBufferView);
+        commandList->DrawInstanced(4, page.mCount, 0, 0);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+
+class D3D12Backend : public RenderBackend
+{
+public:
+    D3D12Backend() = default;
+    ~D3D12Backend() override;
+
+    void CreateDevice();
+    void CreateCommandQueue();
+    void CreateSwapChain(HWND hwnd, uint32_t width, uint32_t height);
+    void CreateCommandList(uint32_t framesInFlight);
+    void CreateFence();
+
+    void InitializeTriangleRenderer();
+    void AddPasses();
+    void WaitForGpu();
+
+    uint32_t GetWidth() const override { return mWidth; }
+    uint32_t GetHeight() const override { return mHeight; }
+
+    SpriteImage CreateSpriteImage(uint32_t width, uint32_t height, const uint8_t* pixels) override;
+
+    void BeginFrame() override;
+    void Record(const RenderFrame& frame, RenderTimings& timings) override;
+    void Submit() override;
+    void Present() override;
+    void EndFrame() override;
+
+private:
+    ID3D12Device* mDevice;
+    ID3D12CommandQueue* mCommandQueue;
+    IDXGISwapChain3* mSwapChain;
+
+    uint32_t mWidth;
+    uint32_t mHeight;
+
+    ID3D12DescriptorHeap* mRtvHeap;
+    uint32_t mRtvDescriptorSize;
+
+    ID3D12Resource* mRenderTargets[NUM_BACKBUFFERS];
+
+    // The frame is split into passes that are recorded in parallel, each into its own command list. They are submitted
+    // together in pass order. The passes read what to draw from mFrame, which is only set while they are recorded.
+    ID3D12GraphicsCommandList* BeginPass(uint32_t pass);
+
+    std::array<ID3D12GraphicsCommandList*, RenderPassCount> mCommandLists = {};
+    PassRecorder mPassRecorder;
+    const RenderFrame* mFrame = nullptr;
+
+    UploadRing mUploadRing;
+    DescriptorHeap mDescriptorHeap;
+    TexturedTriangleRenderer mTriangleRenderer;
+    SpriteRenderer mSpriteRenderer;
+    TextRenderer mTextRenderer;
+
+    // The CPU records a frame while the GPU is still working on the ones before it. Every frame in flight has its own
+    // command allocator, which can only be reset once the GPU has passed the fence signalled after that frame. The upload
+    // ring and descriptor heap don't need a region per frame, they already release their space by fence value.
+    struct FrameContext
+    {
+        std::array<ID3D12CommandAllocator*, RenderPassCount> mCommandAllocators = {};
+        uint64_t mFenceValue = 0;
+    };
+
+    std::array<FrameContext, D3D12MaxFramesInFlight> mFrames;
+    uint32_t mFramesInFlight = 0;
+    uint32_t mFrameContextIndex = 0;
+
+    uint32_t mFrameIndex;
+    ID3D12Fence* mFence = nullptr;
+    HANDLE mFenceEvent;
+    uint64_t mFenceValue;
+};
+
+D3D12Backend::~D3D12Backend()
+{
+    // Nothing can be released while the GPU may still be using it
+    if (mFence)
+    {
+        WaitForGpu();
+    }
+}
+
+void D3D12Backend::CreateDevice()
+{
+    UINT dxgiFactoryFlags = 0;
+
+#if defined(_DEBUG)
+    {
+        ID3D12Debug* debugController;
+        if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&debugController))))
+        {
+            debugController->EnableDebugLayer();
+            debugController->Release();
+
+            // Enable additional debug layers.
+            dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+        }
+    }
+#endif
+
+    IDXGIFactory4* factory;
+    IDXGIAdapter1* adapter = nullptr;
+    ensure(SUCCEEDED(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&factory))));
+    // Ignore this line. I'm testing in a VM and don't have a GPU so I'm using the warp adapter which is basically a software renderer.
+#if defined(USE_WARP_ADAPTER)
+    ensure(SUCCEEDED(factory->EnumWarpAdapter(IID_PPV_ARGS(&adapter))));
+#endif
+    ensure(SUCCEEDED(D3D12CreateDevice(adapter, D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&mDevice))));
+    factory->Release();
+}
+
+void D3D12Backend::CreateCommandQueue()
+{
+    D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+    queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+    queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+
+    ensure(SUCCEEDED(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue))));
+}
+
+void D3D12Backend::CreateSwapChain(HWND hwnd, uint32_t width, uint32_t height)
+{
+    IDXGIFactory4* factory;
+    ensure(SUCCEEDED(CreateDXGIFactory1(IID_PPV_ARGS(&factory))));
+
+    mWidth = width;
+    mHeight = height;
+
+    DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {};
+    swapChainDesc.BufferCount = NUM_BACKBUFFERS;
+    swapChainDesc.Width = width;
+    swapChainDesc.Height = height;
+    swapChainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+    swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+    swapChainDesc.SampleDesc.Count = 1;
+
+    IDXGISwapChain1* tempSwapChain;
+    ensure(SUCCEEDED(factory->CreateSwapChainForHwnd(mCommandQueue,
+                                                     hwnd,
+                                                     &swapChainDesc,
+                                                     nullptr,
+                                                     nullptr,
+                                                     &tempSwapChain)));
+
+    ensure(SUCCEEDED(tempSwapChain->QueryInterface(IID_PPV_ARGS(&mSwapChain))));
+
+    // Release the temporary swap chain
+    tempSwapChain->Release();
+    factory->Release();
+
+    mFrameIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+    // Create descriptor heaps
+    {
+        // Describe and create a render target view (RTV) descriptor heap.
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.NumDescriptors = NUM_BACKBUFFERS;
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        ensure(SUCCEEDED(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRtvHeap))));
+
+        mRtvDescriptorSize = mDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+    }
+
+    // Create the render target views
+    D3D12_CPU_DESCRIPTOR_HANDLE rtv = mRtvHeap->GetCPUDescriptorHandleForHeapStart();
+    for (size_t i = 0; i < NUM_BACKBUFFERS; i++)
+    {
+        ensure(SUCCEEDED(mSwapChain->GetBuffer(static_cast<uint32_t>(i), __uuidof(ID3D12Resource), (LPVOID*)&mRenderTargets[i])));
+        mDevice->CreateRenderTargetView(mRenderTargets[i], NULL, rtv);
+        rtv.ptr += mRtvDescriptorSize;
+    }
+}
+
+void D3D12Backend::CreateCommandList(uint32_t framesInFlight)
+{
+    // Create a command allocator for every pass of every frame in flight. A pass's command list is recorded with whichever
+    // one belongs to the frame, and allocators are never shared between threads.
+    mFramesInFlight = framesInFlight;
+    for (uint32_t i = 0; i < mFramesInFlight; ++i)
+    {
+        for (ID3D12CommandAllocator*& commandAllocator : mFrames[i].mCommandAllocators)
+        {
+            ensure(SUCCEEDED(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator))));
+        }
+    }
+
+    for (uint32_t pass = 0; pass < RenderPassCount; ++pass)
+    {
+        ensure(SUCCEEDED(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, mFrames[0].mCommandAllocators[pass], nullptr, IID_PPV_ARGS(&mCommandLists[pass]))));
+
+        // The command list is in the recording state when it is created but we have nothing do to at the moment.
+        mCommandLists[pass]->Close();
+    }
+
+    // Room for a few frames of a full text buffer plus uploading every retained glyph at once
+    mUploadRing.Initialize(mDevice, 4 * 1024 * 1024);
+
+    // Every renderer shares this heap. Textures take persistent descriptors, anything made for one frame is transient.
+    mDescriptorHeap.Initialize(mDevice, 4096, 1024);
+}
+
+// A fence is a synchronization primitive that we can use to signal that the GPU is done rendering a frame
+void D3D12Backend::CreateFence()
+{
+    ensure(SUCCEEDED(mDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence))));
+    mFenceValue = 1;
+
+    // This is the event we will listen for
+    mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (mFenceEvent == nullptr)
+    {
+        ensure(SUCCEEDED(HRESULT_FROM_WIN32(GetLastError())));
+    }
+}
+
+void D3D12Backend::InitializeTriangleRenderer()
+{
+    // Setup is recorded on the first pass's command list
+    ID3D12GraphicsCommandList* commandList = mCommandLists[ScenePass];
+    ensure(SUCCEEDED(commandList->Reset(mFrames[0].mCommandAllocators[ScenePass], nullptr)));
+ 
+    mTriangleRenderer.Initialize(mDevice, commandList, mDescriptorHeap, static_cast<float>(mWidth), static_cast<float>(mHeight));
+    mSpriteRenderer.Initialize(mDevice, mDescriptorHeap, static_cast<float>(mWidth), static_cast<float>(mHeight));
+    mTextRenderer.Initialize(mDevice, commandList, mDescriptorHeap, static_cast<float>(mWidth), static_cast<float>(mHeight));
+
+    // Close the command list and execute it to begin the initial GPU setup.
+    ensure(SUCCEEDED(commandList->Close()));
+    ID3D12CommandList* commandLists[] = { commandList };
+    mCommandQueue->ExecuteCommandLists(1, commandLists);
+}
+
+void D3D12Backend::AddPasses()
+{
+    // Passes only share the upload ring, which is thread safe, and each draws with its own renderer
+    mPassRecorder.AddPass("Scene", [this](uint32_t pass)
+    {
+        ID3D12GraphicsCommandList* commandList = BeginPass(pass);
+
+        // Transition our back buffer to be able to be used as a render target since we're rendering to it
+        commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mRenderTargets[mFrameIndex], D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET));
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRtvHeap->GetCPUDescriptorHandleForHeapStart(), mFrameIndex, mRtvDescriptorSize);
+        commandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+
+        mTriangleRenderer.Render(commandList, mUploadRing);
+        ensure(SUCCEEDED(commandList->Close()));
+    });
+
+    mPassRecorder.AddPass("Sprites", [this](uint32_t pass)
+    {
+        ID3D12GraphicsCommandList* commandList = BeginPass(pass);
+        mSpriteRenderer.Render(commandList, mUploadRing, mFrame->mSprites);
+        ensure(SUCCEEDED(commandList->Close()));
+    });
+
+    mPassRecorder.AddPass("Text", [this](uint32_t pass)
+    {
+        ID3D12GraphicsCommandList* commandList = BeginPass(pass);
+        mTextRenderer.Render(commandList, mUploadRing, mFrame->mRetainedText, mFrame->mDebugText);
+
+        // Transition back buffer back to the present state since we are done drawing to it and want it ready for present
+        commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mRenderTargets[mFrameIndex], D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
+        ensure(SUCCEEDED(commandList->Close()));
+    });
+
+    ensure(mPassRecorder.GetPassCount() == RenderPassCount);
+
+    // The main thread records a pass as well
+    mPassRecorder.Start(RenderPassCount - 1);
+}
+
+ID3D12GraphicsCommandList* D3D12Backend::BeginPass(uint32_t pass)
+{
+    // This should only be done after the command list associated with this allocator has finished execution.
+    // BeginFrame waits for that.
+    ID3D12CommandAllocator* commandAllocator = mFrames[mFrameContextIndex].mCommandAllocators[pass];
+    ensure(SUCCEEDED(commandAllocator->Reset()));
+
+    // This sets it back to the recording state so we can set up our pass
+    ID3D12GraphicsCommandList* commandList = mCommandLists[pass];
+    ensure(SUCCEEDED(commandList->Reset(commandAllocator, nullptr)));
+
+    // State doesn't carry over between command lists, so every pass binds the render target and descriptor heap itself
+    CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRtvHeap->GetCPUDescriptorHandleForHeapStart(), mFrameIndex, mRtvDescriptorSize);
+    commandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+    mDescriptorHeap.Bind(commandList);
+
+    return commandList;
+}
+
+SpriteImage D3D12Backend::CreateSpriteImage(uint32_t width, uint32_t height, const uint8_t* pixels)
+{
+    return mSpriteRenderer.CreateImage(width, height, pixels);
+}
+
+void D3D12Backend::Record(const RenderFrame& frame, RenderTimings& timings)
+{
+    mFrame = &frame;
+    mPassRecorder.Execute();
+    mFrame = nullptr;
+
+    for (uint32_t pass = 0; pass < RenderPassCount; ++pass)
+    {
+        timings.mPasses[pass] = mPassRecorder.GetPassTime(pass);
+    }
+}
+
+void D3D12Backend::Submit()
+{
+    // One submission for the whole frame, in pass order no matter which pass finished recording first
+    ID3D12CommandList* commandLists[RenderPassCount];
+    for (uint32_t pass = 0; pass < RenderPassCount; ++pass)
+    {
+        commandLists[pass] = mCommandLists[pass];
+    }
+    mCommandQueue->ExecuteCommandLists(RenderPassCount, commandLists);
+}
+
+void D3D12Backend::Present()
+{
+    ensure(SUCCEEDED(mSwapChain->Present(1, 0)));
+}
+
+void D3D12Backend::BeginFrame()
+{
+    // Only wait if the GPU is still on the frame that last used this context, which is mFramesInFlight frames back
+    const uint64_t fence = mFrames[mFrameContextIndex].mFenceValue;
+    if (mFence->GetCompletedValue() < fence)
+    {
+        ensure(SUCCEEDED(mFence->SetEventOnCompletion(fence, mFenceEvent)));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+    }
+
+    const uint64_t completedFence = mFence->GetCompletedValue();
+    mUploadRing.Retire(completedFence);
+    mDescriptorHeap.Retire(completedFence);
+
+    mFrameIndex = mSwapChain->GetCurrentBackBufferIndex();
+}
+
+void D3D12Backend::EndFrame()
+{
+    // Signal and increment the fence value.
+    const UINT64 fence = mFenceValue;
+    ensure(SUCCEEDED(mCommandQueue->Signal(mFence, fence)));
+    mFenceValue++;
+
+    // Everything this frame used can be reused once the GPU gets to the fence
+    mFrames[mFrameContextIndex].mFenceValue = fence;
+    mUploadRing.EndFrame(fence);
+    mDescriptorHeap.EndFrame(fence);
+
+    mFrameContextIndex = (mFrameContextIndex + 1) % mFramesInFlight;
+}
+
+// Blocks until the GPU has finished everything that was submitted so far
+void D3D12Backend::WaitForGpu()
+{
+    const UINT64 fence = mFenceValue;
+    ensure(SUCCEEDED(mCommandQueue->Signal(mFence, fence)));
+    mFenceValue++;
+
+    // Frames that were still in flight are done as well, so any frame context can be used next
+    mUploadRing.EndFrame(fence);
+    mDescriptorHeap.EndFrame(fence);
+
+    if (mFence->GetCompletedValue() < fence)
+    {
+        ensure(SUCCEEDED(mFence->SetEventOnCompletion(fence, mFenceEvent)));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+    }
+
+    mUploadRing.Retire(fence);
+    mDescriptorHeap.Retire(fence);
+}
+
+std::unique_ptr<RenderBackend> CreateD3D12Backend(Window& window, uint32_t framesInFlight)
+{
+    std::unique_ptr<D3D12Backend> backend = std::make_unique<D3D12Backend>();
+    backend->CreateDevice();
+    backend->CreateCommandQueue();
+    backend->CreateSwapChain(window.GetHandle(), window.GetWidth(), window.GetHeight());
+    backend->CreateCommandList(std::clamp(framesInFlight, 1u, D3D12MaxFramesInFlight));
+    backend->CreateFence();
+
+    backend->InitializeTriangleRenderer();
+    backend->AddPasses();
+
+    // Wait for all the setup work we just did to complete because we are going to re-use the command list
+    backend->WaitForGpu();
+    return backend;
+}
@@ -0,0 +1,133 @@
+#include <DescriptorAllocator.h>
+
+#include <algorithm>
+
+void DescriptorAllocator::Initialize(uint32_t persistentCount, uint32_t transientCount)
+{
+    mPersistentCount = persistentCount;
+    mTransientCount = transientCount;
+
+    mFreeRanges.clear();
+    if (persistentCount > 0)
+    {
+        mFreeRanges.push_back({ 0, persistentCount });
+    }
+    mFreedThisFrame.clear();
+    mPendingFrees.clear();
+    mTransient.Initialize(transientCount);
+}
+
+uint32_t DescriptorAllocator::AllocatePersistent(uint32_t count)
+{
+    if (count == 0)
+    {
+        return InvalidIndex;
+    }
+
+    // First fit keeps the low end of the heap dense
+    for (size_t i = 0; i < mFreeRanges.size(); ++i)
+    {
+        Range& range = mFreeRanges[i];
+        if (range.mCount < count)
+        {
+            continue;
+        }
+
+        const uint32_t index = range.mFirst;
+        range.mFirst += count;
+        range.mCount -= count;
+        if (range.mCount == 0)
+        {
+            mFreeRanges.erase(mFreeRanges.begin() + i);
+        }
+        return index;
+    }
+
+    return InvalidIndex;
+}
+
+void DescriptorAllocator::FreePersistent(uint32_t index, uint32_t count)
+{
+    if (index != InvalidIndex && count > 0)
+    {
+        mFreedThisFrame.push_back({ index, count });
+    }
+}
+
+uint32_t DescriptorAllocator::AllocateTransient(uint32_t count)
+{
+    const uint64_t offset = mTransient.Allocate(count, 1);
+    return offset == FrameRingAllocator::InvalidOffset ? InvalidIndex : mPersistentCount + static_cast<uint32_t>(offset);
+}
+
+void DescriptorAllocator::EndFrame(uint64_t fenceValue)
+{
+    mTransient.EndFrame(fenceValue);
+
+    for (const Range& range : mFreedThisFrame)
+    {
+        mPendingFrees.push_back({ range, fenceValue });
+    }
+    mFreedThisFrame.clear();
+}
+
+void DescriptorAllocator::Retire(uint64_t completedFenceValue)
+{
+    mTransient.Retire(completedFenceValue);
+
+    size_t retired = 0;
+    while (retired < mPendingFrees.size() && mPendingFrees[retired].mFenceValue <= completedFenceValue)
+    {
+        Release(mPendingFrees[retired].mRange);
+        ++retired;
+    }
+    mPendingFrees.erase(mPendingFrees.begin(), mPendingFrees.begin() + retired);
+}
+
+uint32_t DescriptorAllocator::GetFreePersistentCount() const
+{
+    uint32_t count = 0;
+    for (const Range& range : mFreeRanges)
+    {
+        count += range.mCount;
+    }
+    return count;
+}
+
+uint32_t DescriptorAllocator::GetLargestFreePersistentRange() const
+{
+    uint32_t largest = 0;
+    for (const Range& range : mFreeRanges)
+    {
+        largest = std::max(largest, range.mCount);
+    }
+    return largest;
+}
+
+void DescriptorAllocator::Release(const Range& range)
+{
+    auto next = std::lower_bound(mFreeRanges.begin(), mFreeRanges.end(), range.mFirst, [](const Range& free, uint32_t first) { return free.mFirst < first; });
+
+    // Merge with the free ranges on either side if they touch
+    const bool mergeNext = next != mFreeRanges.end() && range.mFirst + range.mCount == next->mFirst;
+    const bool mergePrevious = next != mFreeRanges.begin() && (next - 1)->mFirst + (next - 1)->mCount == range.mFirst;
+
+    if (mergePrevious && mergeNext)
+    {
+        (next - 1)->mCount += range.mCount + next->mCount;
+        mFreeRanges.erase(next);
+    }
+    else if (mergePrevious)
+    {
+        (next - 1)->mCount += range.mCount;
+    }
+    else if (mergeNext)
+    {
+        next->mFirst = range.mFirst;
+        next->mCount += range.mCount;
+    }
+    else
+    {
+        mFreeRanges.insert(next, range);
+    }
+}
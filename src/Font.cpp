@@ -0,0 +1,18 @@
+#include <Font.h>
+
+namespace Font
+{
+    constexpr std::array<uint8_t, AtlasSize> Atlas = BuildAtlas();
+
+    void GetCharacterUVs(char c, float& u1, float& v1, float& u2, float& v2)
+    {
+        uint32_t charIndex = static_cast<uint32_t>(c) - FirstChar;
+        uint32_t gridX = charIndex % CharsPerRow;
+        uint32_t gridY = charIndex / CharsPerRow;
+
+        u1 = static_cast<float>(gridX * CharWidth) / TextureWidth;
+        v1 = static_cast<float>(gridY * CharHeight) / TextureHeight;
+        u2 = static_cast<float>((gridX + 1) * CharWidth) / TextureWidth;
+        v2 = static_cast<float>((gridY + 1) * CharHeight) / TextureHeight;
+    }
+}
@@ -0,0 +1,69 @@
+#include <FrameRingAllocator.h>
+
+#include <algorithm>
+
+void FrameRingAllocator::Initialize(uint64_t capacity)
+{
+    mCapacity = capacity;
+    mHead = 0;
+    mTail = 0;
+    mHighWaterMark = 0;
+    mFirstFrame = 0;
+    mFrameCount = 0;
+}
+
+uint64_t FrameRingAllocator::Allocate(uint64_t size, uint64_t alignment)
+{
+    if (size == 0 || size > mCapacity)
+    {
+        return InvalidOffset;
+    }
+
+    const uint64_t position = mHead % mCapacity;
+    uint64_t offset = (position + alignment - 1) & ~(alignment - 1);
+    if (offset + size > mCapacity)
+    {
+        // Skip the rest of the buffer and start over at the beginning
+        offset = 0;
+    }
+
+    const uint64_t padding = offset >= position ? offset - position : mCapacity - position;
+    if (mHead + padding + size - mTail > mCapacity)
+    {
+        return InvalidOffset;
+    }
+
+    mHead += padding + size;
+    mHighWaterMark = std::max(mHighWaterMark, mHead - mTail);
+    return offset;
+}
+
+void FrameRingAllocator::EndFrame(uint64_t fenceValue)
+{
+    if (mFrameCount > 0 && mFrames[(mFirstFrame + mFrameCount - 1) % MaxFramesInFlight].mEnd == mHead)
+    {
+        // Nothing was allocated since the last frame. Just move its fence forward so there is one less frame to track.
+        mFrames[(mFirstFrame + mFrameCount - 1) % MaxFramesInFlight].mFenceValue = fenceValue;
+        return;
+    }
+
+    if (mFrameCount == MaxFramesInFlight)
+    {
+        // Too many frames in flight to track separately. Merge the two newest, which only delays releasing the older one.
+        mFrames[(mFirstFrame + mFrameCount - 1) % MaxFramesInFlight] = { fenceValue, mHead };
+        return;
+    }
+
+    mFrames[(mFirstFrame + mFrameCount) % MaxFramesInFlight] = { fenceValue, mHead };
+    ++mFrameCount;
+}
+
+void FrameRingAllocator::Retire(uint64_t completedFenceValue)
+{
+    while (mFrameCount > 0 && mFrames[mFirstFrame].mFenceValue <= completedFenceValue)
+    {
+        mTail = mFrames[mFirstFrame].mEnd;
+        mFirstFrame = (mFirstFrame + 1) % MaxFramesInFlight;
+        --mFrameCount;
+    }
+}
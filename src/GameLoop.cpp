@@ -0,0 +1,102 @@
+#include <GameLoop.h>
+#include <Log.h>
+#include <Util.h>
+
+#include <algorithm>
+#include <cmath>
+
+FixedTimestep::FixedTimestep(double stepSeconds, uint32_t maxStepsPerFrame)
+    : mStep(stepSeconds)
+    , mMaxStepsPerFrame(maxStepsPerFrame)
+{
+    ensure(stepSeconds > 0.0 && maxStepsPerFrame > 0);
+}
+
+uint32_t FixedTimestep::Advance(double elapsedSeconds)
+{
+    mAccumulator += std::max(elapsedSeconds, 0.0);
+
+    uint32_t steps = 0;
+    while (mAccumulator >= mStep && steps < mMaxStepsPerFrame)
+    {
+        mAccumulator -= mStep;
+        ++steps;
+    }
+
+    // Only a fraction of a step is kept, so the frames after a hitch run at the normal rate again. A slow machine drops time
+    // every frame, so the warning is only logged when that starts and when it stops rather than every frame.
+    if (mAccumulator >= mStep)
+    {
+        const double dropped = mAccumulator - std::fmod(mAccumulator, mStep);
+        mAccumulator -= dropped;
+        mDroppedTime += dropped;
+        if (mBehindFrames == 0)
+        {
+            LOG_WARN(Application, "Simulation fell behind, dropped %.1f ms", dropped * 1000.0);
+            mBehindDroppedTime = 0.0;
+        }
+        mBehindDroppedTime += dropped;
+        ++mBehindFrames;
+    }
+    else if (mBehindFrames != 0)
+    {
+        LOG_INFO(Application, "Simulation caught up after %u frames, dropped %.1f ms", mBehindFrames, mBehindDroppedTime * 1000.0);
+        mBehindFrames = 0;
+    }
+
+    mStepCount += steps;
+    return steps;
+}
+
+FrameBudget::FrameBudget(double budgetMilliseconds)
+    : mBudget(budgetMilliseconds)
+{
+}
+
+void FrameBudget::EndFrame(const std::array<double, FramePhaseCount>& phaseTimes)
+{
+    mHistory[mFrameCount % HistorySize] = phaseTimes;
+    ++mFrameCount;
+
+    if (phaseTimes[UpdatePhase] + phaseTimes[RenderPhase] > mBudget)
+    {
+        ++mOverBudgetCount;
+    }
+}
+
+double FrameBudget::GetAverage(FramePhase phase) const
+{
+    const uint64_t count = std::min<uint64_t>(mFrameCount, HistorySize);
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
+    double sum = 0.0;
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        sum += mHistory[i][phase];
+    }
+    return sum / count;
+}
+
+double FrameBudget::GetMax(FramePhase phase) const
+{
+    const uint64_t count = std::min<uint64_t>(mFrameCount, HistorySize);
+    double max = 0.0;
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        max = std::max(max, mHistory[i][phase]);
+    }
+    return max;
+}
+
+double FrameBudget::GetAverageFrame() const
+{
+    double sum = 0.0;
+    for (uint32_t phase = 0; phase < FramePhaseCount; ++phase)
+    {
+        sum += GetAverage(static_cast<FramePhase>(phase));
+    }
+    return sum;
+}
@@ -0,0 +1,410 @@
+#include <JobSystem.h>
+#include <Log.h>
+#include <Util.h>
+
+namespace
+{
+    // Index into the thread states of the pool thread this is, or -1 for threads outside the pool
+    thread_local int32_t tThreadIndex = -1;
+
+    // Idle workers look for work this many times before they go to sleep
+    constexpr uint32_t SpinCount = 64;
+}
+
+bool JobSystem::WorkQueue::Push(Job* job)
+{
+    const int64_t bottom = mBottom.load(std::memory_order_relaxed);
+    const int64_t top = mTop.load(std::memory_order_acquire);
+    if (bottom - top >= Capacity)
+    {
+        return false;
+    }
+
+    mJobs[bottom & (Capacity - 1)].store(job, std::memory_order_relaxed);
+
+    // Publishes the job to thieves that read the new bottom
+    mBottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+JobSystem::Job* JobSystem::WorkQueue::Pop()
+{
+    // Every store to bottom is a release, so a thief that reads any of them also sees the jobs pushed before it
+    const int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+    mBottom.store(bottom, std::memory_order_release);
+
+    // Thieves have to see the smaller bottom before top is read, or both could take the last job
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = mTop.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        mBottom.store(bottom + 1, std::memory_order_release);
+        return nullptr;
+    }
+
+    Job* job = mJobs[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        // The last job, race the thieves for it
+        if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            job = nullptr;
+        }
+        mBottom.store(bottom + 1, std::memory_order_release);
+    }
+    return job;
+}
+
+JobSystem::Job* JobSystem::WorkQueue::Steal()
+{
+    int64_t top = mTop.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = mBottom.load(std::memory_order_acquire);
+    if (top >= bottom)
+    {
+        return nullptr;
+    }
+
+    // Read before the job is claimed. If another thread claims it first the value is thrown away.
+    Job* job = mJobs[top & (Capacity - 1)].load(std::memory_order_relaxed);
+    if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+    return job;
+}
+
+JobSystem& JobSystem::Get()
+{
+    static JobSystem jobSystem;
+    return jobSystem;
+}
+
+JobSystem::~JobSystem()
+{
+    Stop();
+}
+
+void JobSystem::Start(uint32_t workerCount)
+{
+    ensure(!mRunning && mThreadStates.empty());
+
+    for (uint32_t i = 0; i <= workerCount; ++i)
+    {
+        mThreadStates.push_back(std::make_unique<ThreadState>());
+    }
+
+    tThreadIndex = 0;
+    mRunning = true;
+    for (uint32_t i = 1; i <= workerCount; ++i)
+    {
+        mThreads.emplace_back(&JobSystem::RunWorker, this, i);
+    }
+
+    LOG_INFO(Jobs, "Started %u job workers", workerCount);
+}
+
+void JobSystem::Stop()
+{
+    if (mThreadStates.empty())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mRunning = false;
+    }
+    mWakeCondition.notify_all();
+
+    for (std::thread& thread : mThreads)
+    {
+        thread.join();
+    }
+    mThreads.clear();
+
+    // Whatever is left in any queue is run here, which may start more jobs
+    while (Job* job = FindJob())
+    {
+        Execute(job);
+    }
+
+    for (std::unique_ptr<ThreadState>& state : mThreadStates)
+    {
+        for (Job* job : state->mFreeJobs)
+        {
+            delete job;
+        }
+        for (Job* job : state->mReturnedJobs)
+        {
+            delete job;
+        }
+    }
+    mThreadStates.clear();
+    tThreadIndex = -1;
+}
+
+void JobSystem::Run(JobFunction function, JobCounter* counter)
+{
+    Job* job = AllocateJob();
+    job->mFunction = std::move(function);
+    job->mCounter = counter;
+    if (counter != nullptr)
+    {
+        AddWork(*counter);
+    }
+    Queue(job);
+}
+
+void JobSystem::Resume(std::coroutine_handle<> coroutine)
+{
+    Job* job = AllocateJob();
+    job->mCoroutine = coroutine;
+    Queue(job);
+}
+
+void JobSystem::AddWork(JobCounter& counter)
+{
+    counter.mState.fetch_add(1, std::memory_order_relaxed);
+}
+
+void JobSystem::FinishWork(JobCounter& counter)
+{
+    const uint64_t previous = counter.mState.fetch_sub(1, std::memory_order_acq_rel);
+    if ((previous & JobCounter::CountMask) != 1 || (previous & JobCounter::WaitersBit) == 0)
+    {
+        // Nothing can be waiting for this, so the counter may be gone from here on
+        return;
+    }
+
+    std::vector<std::coroutine_handle<>> waiters;
+    {
+        std::lock_guard<std::mutex> lock(counter.mWaitersMutex);
+        waiters.swap(counter.mWaiters);
+    }
+
+    // The last access, whoever waits on the counter sees it done after this
+    counter.mState.fetch_and(~JobCounter::WaitersBit, std::memory_order_release);
+
+    for (std::coroutine_handle<> waiter : waiters)
+    {
+        Resume(waiter);
+    }
+}
+
+bool JobSystem::AddWaiter(JobCounter& counter, std::coroutine_handle<> coroutine)
+{
+    std::unique_lock<std::mutex> lock(counter.mWaitersMutex);
+    uint64_t state = counter.mState.load(std::memory_order_acquire);
+    while (true)
+    {
+        if (state == 0)
+        {
+            return false;
+        }
+
+        if ((state & JobCounter::CountMask) == 0)
+        {
+            // The last job is still handing the previous waiters back, which takes no time at all
+            lock.unlock();
+            std::this_thread::yield();
+            lock.lock();
+            state = counter.mState.load(std::memory_order_acquire);
+            continue;
+        }
+
+        // Only set the bit if the count didn't drop to zero in the meantime, otherwise nobody would resume this
+        if (counter.mState.compare_exchange_weak(state, state | JobCounter::WaitersBit, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            counter.mWaiters.push_back(coroutine);
+            return true;
+        }
+    }
+}
+
+void JobSystem::Queue(Job* job)
+{
+    // The counter has to go up before anyone can see the job
+    mQueuedJobs.fetch_add(1);
+    if (tThreadIndex >= 0)
+    {
+        if (!mThreadStates[tThreadIndex]->mQueue.Push(job))
+        {
+            // Full, which only happens when a thread starts thousands of jobs without waiting. Running it now keeps
+            // the order the caller can rely on, which is none.
+            mQueuedJobs.fetch_sub(1);
+            Execute(job);
+            return;
+        }
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(mSharedMutex);
+        mSharedQueue.push_back(job);
+    }
+
+    if (mSleepingWorkers.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mWakeCondition.notify_one();
+    }
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    while (!counter.IsDone())
+    {
+        if (Job* job = FindJob())
+        {
+            Execute(job);
+        }
+        else
+        {
+            // The jobs left are running on other threads
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::RunWorker(uint32_t threadIndex)
+{
+    tThreadIndex = static_cast<int32_t>(threadIndex);
+
+    uint32_t idleCount = 0;
+    while (mRunning.load(std::memory_order_relaxed))
+    {
+        if (Job* job = FindJob())
+        {
+            Execute(job);
+            idleCount = 0;
+            continue;
+        }
+
+        if (++idleCount < SpinCount)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Run increments mQueuedJobs before it reads mSleepingWorkers, and this increments mSleepingWorkers before it
+        // reads mQueuedJobs under the lock, so a job can't be queued without either this seeing it or Run waking someone
+        std::unique_lock<std::mutex> lock(mWakeMutex);
+        mSleepingWorkers.fetch_add(1);
+        mWakeCondition.wait(lock, [this] { return !mRunning || mQueuedJobs.load() > 0; });
+        mSleepingWorkers.fetch_sub(1);
+        idleCount = 0;
+    }
+}
+
+JobSystem::Job* JobSystem::AllocateJob()
+{
+    if (tThreadIndex < 0)
+    {
+        return new Job();
+    }
+
+    ThreadState& state = *mThreadStates[tThreadIndex];
+    if (state.mFreeJobs.empty())
+    {
+        std::lock_guard<std::mutex> lock(state.mReturnedMutex);
+        state.mFreeJobs.swap(state.mReturnedJobs);
+    }
+
+    if (state.mFreeJobs.empty())
+    {
+        Job* job = new Job();
+        job->mOwner = tThreadIndex;
+        return job;
+    }
+
+    Job* job = state.mFreeJobs.back();
+    state.mFreeJobs.pop_back();
+    return job;
+}
+
+void JobSystem::FreeJob(Job* job)
+{
+    // Drop what the function captured now rather than when the job is reused
+    job->mFunction = nullptr;
+    job->mCoroutine = nullptr;
+    job->mCounter = nullptr;
+
+    if (job->mOwner < 0 || static_cast<size_t>(job->mOwner) >= mThreadStates.size())
+    {
+        delete job;
+    }
+    else if (job->mOwner == tThreadIndex)
+    {
+        mThreadStates[job->mOwner]->mFreeJobs.push_back(job);
+    }
+    else
+    {
+        ThreadState& owner = *mThreadStates[job->mOwner];
+        std::lock_guard<std::mutex> lock(owner.mReturnedMutex);
+        owner.mReturnedJobs.push_back(job);
+    }
+}
+
+JobSystem::Job* JobSystem::FindJob()
+{
+    if (mQueuedJobs.load(std::memory_order_relaxed) <= 0)
+    {
+        return nullptr;
+    }
+
+    Job* job = nullptr;
+    const uint32_t stateCount = static_cast<uint32_t>(mThreadStates.size());
+    if (tThreadIndex >= 0)
+    {
+        job = mThreadStates[tThreadIndex]->mQueue.Pop();
+    }
+
+    if (job == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(mSharedMutex);
+        if (!mSharedQueue.empty())
+        {
+            job = mSharedQueue.front();
+            mSharedQueue.pop_front();
+        }
+    }
+
+    // Start with the next thread over so thieves spread out instead of all hitting the first queue
+    const uint32_t first = tThreadIndex >= 0 ? static_cast<uint32_t>(tThreadIndex) + 1 : 0;
+    for (uint32_t i = 0; job == nullptr && i < stateCount; ++i)
+    {
+        const uint32_t victim = (first + i) % stateCount;
+        if (static_cast<int32_t>(victim) != tThreadIndex)
+        {
+            job = mThreadStates[victim]->mQueue.Steal();
+        }
+    }
+
+    if (job != nullptr)
+    {
+        mQueuedJobs.fetch_sub(1);
+    }
+    return job;
+}
+
+void JobSystem::Execute(Job* job)
+{
+    if (job->mCoroutine)
+    {
+        job->mCoroutine.resume();
+    }
+    else
+    {
+        job->mFunction();
+    }
+
+    JobCounter* counter = job->mCounter;
+    FreeJob(job);
+
+    // Last, since the counter can be gone as soon as a waiter sees it done
+    if (counter != nullptr)
+    {
+        FinishWork(*counter);
+    }
+}
@@ -1,44 +1,142 @@
 #include <Log.h>
-#include <Util.h>
 
-#include <cstdarg>
+#include <cstring>
 
-class LogMessage
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <csignal>
+#endif
+
+namespace
 {
-public:
-    LogMessage();
-    void Set(std::string_view file, int line, uint64_t timestamp, uint64_t threadId, std::string_view format, va_list args);
+    // Set while the thread is writing messages out, so a crash in a sink doesn't try to drain the queue again
+    thread_local bool tDraining = false;
+
+    std::atomic<bool> gCrashFlushed{ false };
+
+    // Write out whatever we can before the process goes down. This is best effort: draining locks, formats and writes
+    // files, none of which is safe in a signal handler, so a crash in the wrong place can still lose the messages or hang
+    // for the 200 ms Flush waits for the lock. ensure() drains on the failing thread before it crashes, so its message
+    // and everything logged before it is already out by the time this runs. Only the first crash drains, one inside the
+    // drain itself comes straight back here.
+    void CrashFlush()
+    {
+        if (!tDraining && !gCrashFlushed.exchange(true))
+        {
+            Logger::Get().Flush();
+        }
+    }
+
+    // The previous handler still runs afterwards
+#if defined(_WIN32)
+    LPTOP_LEVEL_EXCEPTION_FILTER gPreviousExceptionFilter = nullptr;
+
+    LONG WINAPI CrashHandler(EXCEPTION_POINTERS* exception)
+    {
+        CrashFlush();
+        return gPreviousExceptionFilter != nullptr ? gPreviousExceptionFilter(exception) : EXCEPTION_CONTINUE_SEARCH;
+    }
 
-    std::string mFile;
-    int mLine;
-    uint64_t mTimestamp;
-    uint64_t mThreadId;
-    std::string mMessage;
-    std::atomic<LogMessage*> mNext;
-    std::atomic<bool> mFree;
-};
+    void InstallCrashHandler()
+    {
+        gPreviousExceptionFilter = SetUnhandledExceptionFilter(CrashHandler);
+    }
+#else
+    void CrashHandler(int signal)
+    {
+        CrashFlush();
+        std::signal(signal, SIG_DFL);
+        std::raise(signal);
+    }
 
-thread_local std::array<LogMessage, 512> Logger::mMessagePool;
-thread_local size_t Logger::mMessagePoolIndex = 0;
+    void InstallCrashHandler()
+    {
+        std::signal(SIGSEGV, CrashHandler);
+        std::signal(SIGABRT, CrashHandler);
+    }
+#endif
+}
+
+thread_local LogRing* Logger::mThreadRing = nullptr;
 
-LogMessage::LogMessage()
+LogRing::LogRing(uint32_t threadIndex)
+    : mWrite(0)
+    , mDropped(0)
+    , mHighWaterMark(0)
+    , mThreadIndex(threadIndex)
+    , mRead(0)
+    , mMessages()
 {
-    mNext.store(nullptr);
-    mFree.store(true);
 }
 
-void LogMessage::Set(std::string_view file, int line, uint64_t timestamp, uint64_t threadId, std::string_view format, va_list args)
+LogMessage* LogRing::TryBeginWrite()
 {
-    mFile = file;
-    mLine = line;
-    mTimestamp = timestamp;
-    mThreadId = threadId;
-    // Temporarily just format the string here. I eventually want to save the args as is and format offline.
-    char buffer[4096];
-    vsnprintf(buffer, sizeof(buffer), format.data(), args);
-    mMessage = buffer;
+    const uint64_t write = mWrite.load(std::memory_order_relaxed);
+    const uint64_t read = mRead.load(std::memory_order_acquire);
+    if (write - read >= Capacity)
+    {
+        return nullptr;
+    }
+
+    return &mMessages[write & (Capacity - 1)];
+}
+
+uint32_t LogRing::EndWrite()
+{
+    const uint64_t write = mWrite.load(std::memory_order_relaxed) + 1;
+    mWrite.store(write, std::memory_order_release);
+
+    const uint32_t used = static_cast<uint32_t>(write - mRead.load(std::memory_order_relaxed));
+    if (used > mHighWaterMark.load(std::memory_order_relaxed))
+    {
+        mHighWaterMark.store(used, std::memory_order_relaxed);
+    }
+
+    return used;
+}
+
+bool LogRing::DropOldest()
+{
+    uint64_t read = mRead.load(std::memory_order_acquire);
+    if (mWrite.load(std::memory_order_relaxed) - read < Capacity)
+    {
+        // The consumer made room in the meantime
+        return false;
+    }
+
+    if (mRead.compare_exchange_strong(read, read + 1, std::memory_order_acq_rel))
+    {
+        CountDropped();
+        return true;
+    }
+
+    return false;
+}
+
+bool LogRing::TryRead(LogMessage& message)
+{
+    while (true)
+    {
+        uint64_t read = mRead.load(std::memory_order_acquire);
+        if (read == mWrite.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        memcpy(&message, &mMessages[read & (Capacity - 1)], sizeof(LogMessage));
+
+        // The producer may have dropped this message to make room while we were copying it when using the overwrite policy.
+        // If the read counter moved underneath us the copy might be torn, so throw it away and try the next one.
+        if (mRead.compare_exchange_strong(read, read + 1, std::memory_order_acq_rel))
+        {
+            return true;
+        }
+    }
 }
 
+// ------------------------------------------------------------------------------------------------
+
 Logger& Logger::Get()
 {
     static Logger logger;
@@ -46,62 +144,329 @@ Logger& Logger::Get()
 }
 
 Logger::Logger()
+    : mSiteCount(0)
+    , mRingCount(0)
+    , mUnregisteredDropped(0)
+    , mOverflowPolicy(LogOverflowPolicy::Drop)
+    , mBlockTimeoutUs(1000)
+    , mFlushInterval(50)
+    , mWakeRequested(false)
+    , mStopRequested(false)
+    , mConsumerSleeping(false)
+{
+    for (auto& site : mSites)
+    {
+        site.store(nullptr);
+    }
+    for (auto& ring : mRings)
+    {
+        ring.store(nullptr);
+    }
+    mHasPending.fill(false);
+}
+
+Logger::~Logger()
 {
-    auto dummy = new LogMessage();
-    dummy->Set("<placeholder>", 0, 0, 0, "<placeholder>", nullptr);
-    dummy->mNext.store(nullptr);
-    mHead.store(dummy);
-    mTail = dummy;
+    Stop();
+}
 
-    auto err = fopen_s(&mFile, "log.txt", "w");
+void Logger::Start(std::chrono::milliseconds flushInterval)
+{
+    if (mThread.joinable())
+    {
+        return;
+    }
+
+    mFlushInterval = flushInterval;
+    mStopRequested = false;
+    mThread = std::thread([this]() { Run(); });
+
+    InstallCrashHandler();
 }
 
-void Logger::Log(std::string_view file, int line, uint64_t timestamp, uint64_t threadId, std::string_view format, ...)
+void Logger::Stop()
 {
-    LogMessage* message = nullptr;
-    while (true)
+    if (mThread.joinable())
     {
-        message = &mMessagePool[mMessagePoolIndex];
-        mMessagePoolIndex = (mMessagePoolIndex + 1) % mMessagePool.size();
-        bool t = true; 
-        if (message->mFree.compare_exchange_strong(t, false))
         {
-            break;
+            std::lock_guard<std::mutex> lock(mWakeMutex);
+            mStopRequested = true;
         }
+        mWakeCondition.notify_one();
+        mThread.join();
     }
 
-    va_list args;
-    va_start(args, format);
-    message->Set(file, line, timestamp, threadId, format, args);
-    va_end(args);
+    // Pick up anything logged while the thread was shutting down
+    ProcessQueue();
+}
 
-    // Enqueue message
-    auto prev = mHead.exchange(message);
-    prev->mNext.store(message);
+void Logger::Wake()
+{
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mWakeRequested = true;
+    }
+    mWakeCondition.notify_one();
 }
 
-void Logger::ProcessQueue()
+bool Logger::HasUnreadMessages() const
 {
-    while (true)
+    const uint32_t count = mRingCount.load() < MaxThreads ? mRingCount.load() : MaxThreads;
+    for (uint32_t i = 0; i < count; ++i)
     {
-        auto tail = mTail;
-        auto next = tail->mNext.load();
-        if (next != nullptr)
+        const LogRing* ring = mRings[i].load(std::memory_order_acquire);
+        if (ring != nullptr && !ring->IsEmpty())
         {
-            tail->mFree.store(true);
-            mTail = next;
+            return true;
+        }
+    }
 
-            char buffer[4096];
-            snprintf(buffer, sizeof(buffer), "%s(%d) ts=%lld %s\n", next->mFile.c_str(), next->mLine, next->mTimestamp, next->mMessage.c_str());
+    return false;
+}
 
-            printf(buffer);
-            fprintf(mFile, buffer);
+void Logger::Run()
+{
+    bool idle = false;
+    std::unique_lock<std::mutex> lock(mWakeMutex);
+    while (!mStopRequested)
+    {
+        const auto wakeRequested = [this]() { return mWakeRequested || mStopRequested; };
+
+        if (idle)
+        {
+            // Nothing was logged since the last pass so sleep until a producer wakes us up. Producers check this flag after
+            // writing a message, so after setting it we have to look at the rings one more time before going to sleep.
+            mConsumerSleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!HasUnreadMessages())
+            {
+                mWakeCondition.wait(lock, wakeRequested);
+            }
+            mConsumerSleeping.store(false, std::memory_order_relaxed);
         }
         else
+        {
+            // Give producers a chance to batch up more messages
+            mWakeCondition.wait_for(lock, mFlushInterval, wakeRequested);
+        }
+
+        mWakeRequested = false;
+        lock.unlock();
+        idle = ProcessQueue() == 0;
+        lock.lock();
+    }
+}
+
+void Logger::SetLevel(LogCategory category, LogLevel minLevel)
+{
+    const uint32_t shift = static_cast<uint32_t>(category) * 8;
+    const uint64_t levels = (0xFFull << static_cast<uint32_t>(minLevel)) & 0xFF;
+
+    uint64_t mask = mFilterMask.load();
+    while (!mFilterMask.compare_exchange_weak(mask, (mask & ~(0xFFull << shift)) | (levels << shift)))
+    {
+    }
+}
+
+void Logger::SetLevel(LogLevel minLevel)
+{
+    const uint64_t levels = (0xFFull << static_cast<uint32_t>(minLevel)) & 0xFF;
+    mFilterMask.store(levels * 0x0101010101010101ull);
+}
+
+uint16_t Logger::RegisterSite(const LogSite& site)
+{
+    uint16_t id = mSiteCount.load();
+    do
+    {
+        if (id >= MaxSites)
+        {
+            return InvalidSiteId;
+        }
+    } while (!mSiteCount.compare_exchange_weak(id, id + 1));
+
+    mSites[id].store(&site, std::memory_order_release);
+    return id;
+}
+
+const LogSite* Logger::GetSite(uint16_t siteId) const
+{
+    return siteId < MaxSites ? mSites[siteId].load(std::memory_order_acquire) : nullptr;
+}
+
+LogRing* Logger::RegisterThread()
+{
+    uint32_t index = mRingCount.load();
+    do
+    {
+        if (index >= MaxThreads)
+        {
+            mUnregisteredDropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    } while (!mRingCount.compare_exchange_weak(index, index + 1));
+
+    // Rings are never freed. A thread that exits may still have messages in flight and the number of threads is small.
+    mThreadRing = new LogRing(index);
+    mRings[index].store(mThreadRing, std::memory_order_release);
+    return mThreadRing;
+}
+
+LogMessage* Logger::AcquireMessage(LogRing& ring)
+{
+    LogMessage* message = ring.TryBeginWrite();
+    if (message != nullptr)
+    {
+        return message;
+    }
+
+    switch (mOverflowPolicy.load(std::memory_order_relaxed))
+    {
+    case LogOverflowPolicy::Drop:
+        break;
+    case LogOverflowPolicy::Block:
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(mBlockTimeoutUs.load(std::memory_order_relaxed));
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::yield();
+            message = ring.TryBeginWrite();
+            if (message != nullptr)
+            {
+                return message;
+            }
+        }
+        break;
+    }
+    case LogOverflowPolicy::OverwriteOldest:
+        // Either we drop the oldest message or the consumer frees a slot for us, so this only loops if we lose the race
+        // to a consumer that is itself being starved. Bound it anyway.
+        for (int attempt = 0; attempt < 4; ++attempt)
+        {
+            ring.DropOldest();
+            message = ring.TryBeginWrite();
+            if (message != nullptr)
+            {
+                return message;
+            }
+        }
+        break;
+    }
+
+    ring.CountDropped();
+    return nullptr;
+}
+
+void Logger::AddSink(std::unique_ptr<LogSink> sink)
+{
+    std::lock_guard<std::timed_mutex> lock(mConsumerMutex);
+    mSinks.push_back(std::move(sink));
+}
+
+void Logger::SetOverflowPolicy(LogOverflowPolicy policy, std::chrono::microseconds blockTimeout)
+{
+    mOverflowPolicy.store(policy);
+    mBlockTimeoutUs.store(blockTimeout.count());
+}
+
+LogStats Logger::GetStats() const
+{
+    LogStats stats = {};
+    stats.mDropped = mUnregisteredDropped.load(std::memory_order_relaxed);
+
+    const uint32_t count = mRingCount.load() < MaxThreads ? mRingCount.load() : MaxThreads;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const LogRing* ring = mRings[i].load(std::memory_order_acquire);
+        if (ring == nullptr)
+        {
+            continue;
+        }
+
+        stats.mDropped += ring->GetDropped();
+        if (ring->GetHighWaterMark() > stats.mHighWaterMark)
+        {
+            stats.mHighWaterMark = ring->GetHighWaterMark();
+        }
+        stats.mThreadCount++;
+    }
+
+    return stats;
+}
+
+size_t Logger::ProcessQueue()
+{
+    std::lock_guard<std::timed_mutex> lock(mConsumerMutex);
+    return ProcessQueueLocked();
+}
+
+void Logger::Flush()
+{
+    if (mConsumerMutex.try_lock_for(std::chrono::milliseconds(200)))
+    {
+        ProcessQueueLocked();
+        mConsumerMutex.unlock();
+    }
+}
+
+size_t Logger::ProcessQueueLocked()
+{
+    tDraining = true;
+    const uint32_t count = mRingCount.load() < MaxThreads ? mRingCount.load() : MaxThreads;
+
+    // Merge the rings by timestamp. Each ring is already in order so we only need to compare the oldest message of each.
+    // Stop after roughly one ring's worth per thread so that a thread that logs nonstop can't keep us here forever.
+    size_t written = 0;
+    size_t budget = static_cast<size_t>(count) * LogRing::Capacity;
+    while (budget-- > 0)
+    {
+        int oldest = -1;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (!mHasPending[i])
+            {
+                LogRing* ring = mRings[i].load(std::memory_order_acquire);
+                mHasPending[i] = ring != nullptr && ring->TryRead(mPending[i]);
+            }
+
+            if (mHasPending[i] && (oldest < 0 || mPending[i].mTimestamp < mPending[oldest].mTimestamp))
+            {
+                oldest = static_cast<int>(i);
+            }
+        }
+
+        if (oldest < 0)
         {
             break;
         }
+
+        Write(mPending[oldest]);
+        mHasPending[oldest] = false;
+        written++;
     }
 
-    fflush(mFile);
+    if (written > 0)
+    {
+        for (auto& sink : mSinks)
+        {
+            sink->Flush();
+        }
+    }
+
+    tDraining = false;
+    return written;
+}
+
+void Logger::Write(const LogMessage& message)
+{
+    const LogSite* site = GetSite(message.mSiteId);
+    if (site == nullptr)
+    {
+        return;
+    }
+
+    for (auto& sink : mSinks)
+    {
+        sink->Write(*site, message);
+    }
 }
@@ -0,0 +1,322 @@
+#include <LogFormat.h>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+    struct LogArg
+    {
+        LogArgType type;
+        union
+        {
+            int64_t i;
+            uint64_t u;
+            double d;
+        };
+        std::string_view s;
+    };
+
+    class LogArgDecoder
+    {
+    public:
+        LogArgDecoder(const LogArgType* signature, size_t argCount, const uint8_t* payload, size_t payloadSize)
+            : mSignature(signature)
+            , mArgCount(argCount)
+            , mArgIndex(0)
+            , mPayload(payload)
+            , mSize(payloadSize)
+            , mOffset(0)
+        {
+        }
+
+        bool Next(LogArg& arg)
+        {
+            if (mArgIndex >= mArgCount)
+            {
+                return false;
+            }
+
+            arg.type = mSignature[mArgIndex];
+            size_t offset = mOffset;
+            switch (arg.type)
+            {
+            case LogArgType::Int:
+            case LogArgType::UInt:
+            case LogArgType::Double:
+            case LogArgType::Pointer:
+                if (offset + sizeof(uint64_t) > mSize)
+                {
+                    return false;
+                }
+                memcpy(&arg.u, mPayload + offset, sizeof(uint64_t));
+                offset += sizeof(uint64_t);
+                break;
+            case LogArgType::String:
+            {
+                uint16_t length;
+                if (offset + sizeof(length) > mSize)
+                {
+                    return false;
+                }
+                memcpy(&length, mPayload + offset, sizeof(length));
+                offset += sizeof(length);
+                if (offset + length > mSize)
+                {
+                    return false;
+                }
+                arg.s = std::string_view(reinterpret_cast<const char*>(mPayload + offset), length);
+                offset += length;
+                break;
+            }
+            default:
+                return false;
+            }
+
+            mOffset = offset;
+            mArgIndex++;
+            return true;
+        }
+
+    private:
+        const LogArgType* mSignature;
+        size_t mArgCount;
+        size_t mArgIndex;
+        const uint8_t* mPayload;
+        size_t mSize;
+        size_t mOffset;
+    };
+
+    class OutputBuffer
+    {
+    public:
+        OutputBuffer(char* buffer, size_t size)
+            : mBuffer(buffer)
+            , mSize(size)
+            , mLength(0)
+        {
+            if (mSize > 0)
+            {
+                mBuffer[0] = '\0';
+            }
+        }
+
+        void Append(std::string_view text)
+        {
+            for (char c : text)
+            {
+                if (mLength + 1 >= mSize)
+                {
+                    break;
+                }
+                mBuffer[mLength++] = c;
+            }
+
+            if (mSize > 0)
+            {
+                mBuffer[mLength] = '\0';
+            }
+        }
+
+        template <typename T>
+        void AppendFormatted(const char* spec, T value)
+        {
+            if (mLength + 1 >= mSize)
+            {
+                return;
+            }
+
+            int written = snprintf(mBuffer + mLength, mSize - mLength, spec, value);
+            if (written > 0)
+            {
+                mLength += static_cast<size_t>(written) < mSize - mLength ? static_cast<size_t>(written) : mSize - mLength - 1;
+            }
+        }
+
+        size_t GetLength() const { return mLength; }
+
+    private:
+        char* mBuffer;
+        size_t mSize;
+        size_t mLength;
+    };
+
+    bool IsConversion(char c)
+    {
+        return strchr("diouxXeEfFgGaAcsp", c) != nullptr;
+    }
+
+    bool IsLengthModifier(char c)
+    {
+        return strchr("hljztLqI", c) != nullptr;
+    }
+}
+
+size_t FormatLogMessage(char* buffer, size_t bufferSize, const char* format, const LogArgType* signature, size_t argCount,
+                        const uint8_t* payload, size_t payloadSize)
+{
+    OutputBuffer out(buffer, bufferSize);
+    LogArgDecoder args(signature, argCount, payload, payloadSize);
+
+    const char* p = format;
+    while (*p != '\0')
+    {
+        const char* literalStart = p;
+        while (*p != '\0' && *p != '%')
+        {
+            ++p;
+        }
+        out.Append(std::string_view(literalStart, p - literalStart));
+
+        if (*p == '\0')
+        {
+            break;
+        }
+
+        if (p[1] == '%')
+        {
+            out.Append("%");
+            p += 2;
+            continue;
+        }
+
+        // Rebuild the conversion specification without its length modifier so that we can substitute our own.
+        // Anything longer than this is not a valid specification anyway.
+        char spec[32];
+        size_t specLength = 0;
+        spec[specLength++] = *p++;
+
+        while (*p != '\0' && !IsConversion(*p) && specLength < sizeof(spec) - 4)
+        {
+            if (*p == '*')
+            {
+                // Width and precision passed as arguments are consumed and baked into the spec
+                LogArg arg = {};
+                int value = args.Next(arg) && (arg.type == LogArgType::Int || arg.type == LogArgType::UInt) ? static_cast<int>(arg.i) : 0;
+                int written = snprintf(spec + specLength, sizeof(spec) - 4 - specLength, "%d", value);
+                if (written > 0)
+                {
+                    specLength = std::min(specLength + static_cast<size_t>(written), sizeof(spec) - 5);
+                }
+            }
+            else if (!IsLengthModifier(*p))
+            {
+                spec[specLength++] = *p;
+            }
+            ++p;
+        }
+
+        if (*p == '\0' || !IsConversion(*p))
+        {
+            out.Append("(bad format)");
+            break;
+        }
+
+        const char conversion = *p++;
+        LogArg arg = {};
+        if (!args.Next(arg))
+        {
+            out.Append("(missing)");
+            continue;
+        }
+
+        switch (conversion)
+        {
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'c':
+        {
+            if (arg.type == LogArgType::String)
+            {
+                out.Append(arg.s);
+                break;
+            }
+
+            const bool isChar = conversion == 'c';
+            if (!isChar)
+            {
+                spec[specLength++] = 'l';
+                spec[specLength++] = 'l';
+            }
+            spec[specLength++] = conversion;
+            spec[specLength] = '\0';
+
+            if (arg.type == LogArgType::Double)
+            {
+                out.AppendFormatted(spec, static_cast<long long>(arg.d));
+            }
+            else if (isChar)
+            {
+                out.AppendFormatted(spec, static_cast<int>(arg.i));
+            }
+            else
+            {
+                out.AppendFormatted(spec, static_cast<long long>(arg.i));
+            }
+            break;
+        }
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+        {
+            spec[specLength++] = conversion;
+            spec[specLength] = '\0';
+
+            switch (arg.type)
+            {
+            case LogArgType::Double:
+                out.AppendFormatted(spec, arg.d);
+                break;
+            case LogArgType::Int:
+                out.AppendFormatted(spec, static_cast<double>(arg.i));
+                break;
+            case LogArgType::UInt:
+            case LogArgType::Pointer:
+                out.AppendFormatted(spec, static_cast<double>(arg.u));
+                break;
+            case LogArgType::String:
+                out.Append(arg.s);
+                break;
+            }
+            break;
+        }
+        case 's':
+        {
+            if (arg.type != LogArgType::String)
+            {
+                out.Append("(bad arg)");
+                break;
+            }
+
+            // Precision and width still apply. The string is not null terminated so copy it out first.
+            char text[512];
+            const size_t length = arg.s.size() < sizeof(text) - 1 ? arg.s.size() : sizeof(text) - 1;
+            memcpy(text, arg.s.data(), length);
+            text[length] = '\0';
+
+            spec[specLength++] = 's';
+            spec[specLength] = '\0';
+            out.AppendFormatted(spec, static_cast<const char*>(text));
+            break;
+        }
+        case 'p':
+        {
+            spec[specLength++] = 'p';
+            spec[specLength] = '\0';
+            out.AppendFormatted(spec, reinterpret_cast<const void*>(static_cast<uintptr_t>(arg.u)));
+            break;
+        }
+        }
+    }
+
+    return out.GetLength();
+}
@@ -0,0 +1,299 @@
+#include <LogSinks.h>
+
+#include <cstring>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr size_t MaxSiteStringLength = 1024;
+}
+
+BinaryLogFileSink::BinaryLogFileSink(const char* path, uint32_t chunkSize, uint32_t chunkCount)
+    : mData(nullptr)
+    , mSize(0)
+    , mHeader(nullptr)
+    , mChunkSize(chunkSize)
+    , mChunkCount(chunkCount < LogFile::MaxChunks ? chunkCount : LogFile::MaxChunks)
+    , mCurrentChunk(0)
+    , mSequence(0)
+    , mSiteSequence(Logger::MaxSites, 0)
+#if defined(_WIN32)
+    , mFileHandle(INVALID_HANDLE_VALUE)
+    , mMappingHandle(nullptr)
+#endif
+{
+    if (!Map(path, LogFile::HeaderSize + static_cast<size_t>(mChunkSize) * mChunkCount))
+    {
+        return;
+    }
+
+    mHeader = reinterpret_cast<LogFile::Header*>(mData);
+    memset(mHeader, 0, sizeof(LogFile::Header));
+    mHeader->mMagic = LogFile::Magic;
+    mHeader->mVersion = LogFile::Version;
+    mHeader->mChunkSize = mChunkSize;
+    mHeader->mChunkCount = mChunkCount;
+    mHeader->mTicksPerSecond = std::chrono::high_resolution_clock::period::den / std::chrono::high_resolution_clock::period::num;
+
+    mSequence = 1;
+    mHeader->mChunks[0].mSequence = mSequence;
+}
+
+BinaryLogFileSink::~BinaryLogFileSink()
+{
+    Unmap();
+}
+
+#if defined(_WIN32)
+
+bool BinaryLogFileSink::Map(const char* path, size_t size)
+{
+    mFileHandle = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (mFileHandle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    // Creating a mapping larger than the file grows the file to that size
+    const uint64_t size64 = static_cast<uint64_t>(size);
+    mMappingHandle = CreateFileMappingA(mFileHandle, nullptr, PAGE_READWRITE, static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64), nullptr);
+    if (mMappingHandle == nullptr)
+    {
+        Unmap();
+        return false;
+    }
+
+    mData = static_cast<uint8_t*>(MapViewOfFile(mMappingHandle, FILE_MAP_WRITE, 0, 0, size));
+    if (mData == nullptr)
+    {
+        Unmap();
+        return false;
+    }
+
+    mSize = size;
+    return true;
+}
+
+void BinaryLogFileSink::Unmap()
+{
+    if (mData != nullptr)
+    {
+        FlushViewOfFile(mData, 0);
+        UnmapViewOfFile(mData);
+        mData = nullptr;
+    }
+
+    if (mMappingHandle != nullptr)
+    {
+        CloseHandle(mMappingHandle);
+        mMappingHandle = nullptr;
+    }
+
+    if (mFileHandle != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(mFileHandle);
+        mFileHandle = INVALID_HANDLE_VALUE;
+    }
+
+    mHeader = nullptr;
+}
+
+#else
+
+bool BinaryLogFileSink::Map(const char* path, size_t size)
+{
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    mData = static_cast<uint8_t*>(data);
+    mSize = size;
+    return true;
+}
+
+void BinaryLogFileSink::Unmap()
+{
+    if (mData != nullptr)
+    {
+        msync(mData, mSize, MS_ASYNC);
+        munmap(mData, mSize);
+        mData = nullptr;
+    }
+
+    mHeader = nullptr;
+}
+
+#endif
+
+uint32_t BinaryLogFileSink::GetSiteRecordSize(const LogSite& site) const
+{
+    const size_t fileLength = strnlen(site.mFile, MaxSiteStringLength);
+    const size_t formatLength = strnlen(site.mFormat, MaxSiteStringLength);
+    return LogFile::AlignRecordSize(sizeof(LogFile::SiteRecord) + site.mArgCount + fileLength + formatLength);
+}
+
+void BinaryLogFileSink::NextChunk()
+{
+    // Move on to the next chunk, overwriting the oldest one once we've wrapped around. The sequence number is cleared
+    // while the chunk is being reset so that a reader never sees a half reset chunk as valid.
+    mCurrentChunk = (mCurrentChunk + 1) % mChunkCount;
+    mSequence++;
+
+    LogFile::ChunkInfo& chunk = mHeader->mChunks[mCurrentChunk];
+    chunk.mSequence = 0;
+    chunk.mUsedBytes = 0;
+    chunk.mFirstTimestamp = 0;
+    chunk.mSequence = mSequence;
+}
+
+uint8_t* BinaryLogFileSink::Append(uint32_t size)
+{
+    LogFile::ChunkInfo& chunk = mHeader->mChunks[mCurrentChunk];
+    uint8_t* destination = mData + LogFile::HeaderSize + static_cast<size_t>(mCurrentChunk) * mChunkSize + chunk.mUsedBytes;
+    chunk.mUsedBytes += size;
+    return destination;
+}
+
+void BinaryLogFileSink::WriteSite(uint16_t siteId, const LogSite& site)
+{
+    const size_t fileLength = strnlen(site.mFile, MaxSiteStringLength);
+    const size_t formatLength = strnlen(site.mFormat, MaxSiteStringLength);
+    const uint32_t size = GetSiteRecordSize(site);
+
+    LogFile::SiteRecord record = {};
+    record.mHeader.mType = LogFile::RecordType::Site;
+    record.mHeader.mSize = static_cast<uint16_t>(size);
+    record.mSiteId = siteId;
+    record.mArgCount = static_cast<uint16_t>(site.mArgCount);
+    record.mLine = static_cast<uint32_t>(site.mLine);
+    record.mFileLength = static_cast<uint16_t>(fileLength);
+    record.mFormatLength = static_cast<uint16_t>(formatLength);
+    record.mLevel = static_cast<uint8_t>(site.mLevel);
+    record.mCategory = static_cast<uint8_t>(site.mCategory);
+
+    uint8_t* p = Append(size);
+    memcpy(p, &record, sizeof(record));
+    p += sizeof(record);
+    memcpy(p, site.mSignature, site.mArgCount);
+    p += site.mArgCount;
+    memcpy(p, site.mFile, fileLength);
+    p += fileLength;
+    memcpy(p, site.mFormat, formatLength);
+
+    mSiteSequence[siteId] = mSequence;
+}
+
+void BinaryLogFileSink::Write(const LogSite& site, const LogMessage& message)
+{
+    if (mHeader == nullptr)
+    {
+        return;
+    }
+
+    const uint32_t size = LogFile::AlignRecordSize(sizeof(LogFile::MessageRecord) + message.mPayloadSize);
+    const uint32_t siteSize = GetSiteRecordSize(site);
+    if (size + siteSize > mChunkSize)
+    {
+        return;
+    }
+
+    // A message that starts a new chunk always needs its site described again, so check the worst case
+    const bool hasSite = mSiteSequence[message.mSiteId] == mSequence;
+    if (mHeader->mChunks[mCurrentChunk].mUsedBytes + size + (hasSite ? 0 : siteSize) > mChunkSize)
+    {
+        NextChunk();
+    }
+
+    LogFile::ChunkInfo& chunk = mHeader->mChunks[mCurrentChunk];
+    if (chunk.mUsedBytes == 0)
+    {
+        chunk.mFirstTimestamp = message.mTimestamp;
+    }
+
+    if (mSiteSequence[message.mSiteId] != mSequence)
+    {
+        WriteSite(message.mSiteId, site);
+    }
+
+    LogFile::MessageRecord record = {};
+    record.mHeader.mType = LogFile::RecordType::Message;
+    record.mHeader.mSize = static_cast<uint16_t>(size);
+    record.mSiteId = message.mSiteId;
+    record.mPayloadSize = message.mPayloadSize;
+    record.mTimestamp = message.mTimestamp;
+    record.mThreadId = message.mThreadId;
+
+    uint8_t* destination = Append(size);
+    memcpy(destination, &record, sizeof(record));
+    memcpy(destination + sizeof(record), message.mPayload.data(), message.mPayloadSize);
+}
+
+void BinaryLogFileSink::Flush()
+{
+    // Nothing to do. The pages belong to the file mapping so the OS writes them back even if we crash.
+}
+
+// ------------------------------------------------------------------------------------------------
+
+ConsoleLogSink::ConsoleLogSink(uint32_t maxLinesPerSecond)
+    : mMaxLinesPerSecond(maxLinesPerSecond)
+    , mLinesThisSecond(0)
+    , mSuppressed(0)
+    , mSecondStart(std::chrono::steady_clock::now())
+{
+}
+
+void ConsoleLogSink::Write(const LogSite& site, const LogMessage& message)
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (now - mSecondStart >= std::chrono::seconds(1))
+    {
+        if (mSuppressed > 0)
+        {
+            printf("(%llu log messages suppressed)\n", static_cast<unsigned long long>(mSuppressed));
+        }
+
+        mSecondStart = now;
+        mLinesThisSecond = 0;
+        mSuppressed = 0;
+    }
+
+    if (mLinesThisSecond >= mMaxLinesPerSecond)
+    {
+        mSuppressed++;
+        return;
+    }
+    mLinesThisSecond++;
+
+    char text[4096];
+    FormatLogMessage(text, sizeof(text), site.mFormat, site.mSignature, site.mArgCount, message.mPayload.data(), message.mPayloadSize);
+    printf("%s(%d) [%s] [%s] tid=%u %s\n", site.mFile, site.mLine, GetLogLevelName(site.mLevel), GetLogCategoryName(site.mCategory),
+           message.mThreadId, text);
+}
+
+void ConsoleLogSink::Flush()
+{
+    fflush(stdout);
+}
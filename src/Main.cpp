@@ -1,7 +1,18 @@
 #include <Application.h>
+#include <AssetStreamer.h>
+#include <JobSystem.h>
+#include <Log.h>
 
 int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine, int nCmdShow)
 {
     Application::Initialize(hInstance, nCmdShow);
     Application::Instance().Run();
+
+    // Abandon any loads that are still in flight. Their callbacks still run, so tasks waiting in LoadAsset are queued on
+    // the job system and finish when it stops.
+    AssetStreamer::Get().Stop();
+    JobSystem::Get().Stop();
+
+    // Make sure everything that was logged makes it to disk before we exit
+    Logger::Get().Stop();
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include <PassRecorder.h>
+
+#include <chrono>
+
+PassRecorder::~PassRecorder()
+{
+    Stop();
+}
+
+void PassRecorder::Start(uint32_t workerCount)
+{
+    if (!mWorkers.empty())
+    {
+        return;
+    }
+
+    mStopRequested = false;
+    for (uint32_t i = 0; i < workerCount; ++i)
+    {
+        mWorkers.emplace_back([this]() { RunWorker(); });
+    }
+}
+
+void PassRecorder::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopRequested = true;
+    }
+    mStartCondition.notify_all();
+
+    for (std::thread& worker : mWorkers)
+    {
+        worker.join();
+    }
+    mWorkers.clear();
+}
+
+uint32_t PassRecorder::AddPass(const char* name, RecordFunction record)
+{
+    mPasses.push_back({ name, std::move(record) });
+    return static_cast<uint32_t>(mPasses.size() - 1);
+}
+
+void PassRecorder::Clear()
+{
+    mPasses.clear();
+}
+
+void PassRecorder::Execute()
+{
+    if (mPasses.empty())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mNextPass = 0;
+        mFinishedWorkers = 0;
+        ++mGeneration;
+    }
+    mStartCondition.notify_all();
+
+    RecordPasses();
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDoneCondition.wait(lock, [this]() { return mFinishedWorkers == mWorkers.size(); });
+}
+
+void PassRecorder::RunWorker()
+{
+    uint64_t generation = 0;
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        mStartCondition.wait(lock, [this, generation]() { return mStopRequested || mGeneration != generation; });
+        if (mStopRequested)
+        {
+            return;
+        }
+        generation = mGeneration;
+
+        lock.unlock();
+        RecordPasses();
+        lock.lock();
+
+        ++mFinishedWorkers;
+        mDoneCondition.notify_one();
+    }
+}
+
+void PassRecorder::RecordPasses()
+{
+    // Passes are taken in order, so the first ones, which are submitted first, are also started first
+    while (true)
+    {
+        uint32_t passIndex;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mNextPass == mPasses.size())
+            {
+                return;
+            }
+            passIndex = mNextPass++;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        mPasses[passIndex].mRecord(passIndex);
+        mPasses[passIndex].mTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
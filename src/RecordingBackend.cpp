@@ -0,0 +1,205 @@
+#include <RecordingBackend.h>
+#include <Log.h>
+#include <Util.h>
+
+#include <algorithm>
+#include <cstring>
+
+RecordingBackend::RecordingBackend(uint32_t width, uint32_t height, uint32_t workerCount)
+    : mWidth(width)
+    , mHeight(height)
+{
+    // The same triangle the D3D12 backend draws in its scene pass
+    const float aspectRatio = static_cast<float>(width) / static_cast<float>(height);
+    mSceneVertices =
+    {{
+        { 0.0f, 0.25f * aspectRatio, 0.0f, 0.5f, 0.0f },
+        { 0.25f, -0.25f * aspectRatio, 0.0f, 1.0f, 1.0f },
+        { -0.25f, -0.25f * aspectRatio, 0.0f, 0.0f, 1.0f }
+    }};
+
+    mRetainedGlyphs.assign(MaxRetainedGlyphs, HiddenGlyph);
+
+    mPassRecorder.AddPass("Scene", [this](uint32_t pass) { RecordScene(mPasses[pass]); });
+    mPassRecorder.AddPass("Sprites", [this](uint32_t pass) { RecordSprites(mPasses[pass], mFrame->mSprites); });
+    mPassRecorder.AddPass("Text", [this](uint32_t pass) { RecordText(mPasses[pass], mFrame->mRetainedText, mFrame->mDebugText); });
+    ensure(mPassRecorder.GetPassCount() == RenderPassCount);
+    mPassRecorder.Start(workerCount);
+}
+
+SpriteImage RecordingBackend::CreateSpriteImage(uint32_t width, uint32_t height, const uint8_t* pixels)
+{
+    // Packed the same way as SpriteRenderer does, so sprites batch into the same draws
+    SpriteTexture pageIndex = 0;
+    AtlasRect rect;
+    while (pageIndex < mPages.size() && !mPages[pageIndex].mPacker.Allocate(width, height, rect))
+    {
+        ++pageIndex;
+    }
+
+    if (pageIndex == mPages.size())
+    {
+        ensure(mPages.size() < MaxPages);
+        Page& page = mPages.emplace_back();
+        page.mPacker.Initialize(std::max(width, PageSize), std::max(height, PageSize));
+        page.mPixels.resize(static_cast<size_t>(page.mPacker.GetWidth()) * page.mPacker.GetHeight() * 4);
+        ensure(page.mPacker.Allocate(width, height, rect));
+    }
+
+    Page& page = mPages[pageIndex];
+    const uint32_t pageWidth = page.mPacker.GetWidth();
+    for (uint32_t row = 0; row < height; ++row)
+    {
+        memcpy(page.mPixels.data() + (static_cast<size_t>(rect.mY + row) * pageWidth + rect.mX) * 4, pixels + static_cast<size_t>(row) * width * 4, width * 4);
+    }
+
+    const float pageWidthF = static_cast<float>(pageWidth);
+    const float pageHeightF = static_cast<float>(page.mPacker.GetHeight());
+    return { pageIndex, rect.mX / pageWidthF, rect.mY / pageHeightF, (rect.mX + rect.mWidth) / pageWidthF, (rect.mY + rect.mHeight) / pageHeightF };
+}
+
+void RecordingBackend::BeginFrame()
+{
+    // The streams of the last frame are dropped but their memory is kept, so a steady frame doesn't allocate
+    for (Pass& pass : mPasses)
+    {
+        pass.mCommands.clear();
+        pass.mData.clear();
+    }
+}
+
+void RecordingBackend::Record(const RenderFrame& frame, RenderTimings& timings)
+{
+    mFrame = &frame;
+    mPassRecorder.Execute();
+    mFrame = nullptr;
+
+    for (uint32_t pass = 0; pass < RenderPassCount; ++pass)
+    {
+        timings.mPasses[pass] = mPassRecorder.GetPassTime(pass);
+    }
+}
+
+void RecordingBackend::Submit()
+{
+    // Nothing runs the commands, they stay around to be looked at until the next frame begins
+}
+
+void RecordingBackend::Present()
+{
+}
+
+void RecordingBackend::EndFrame()
+{
+    ++mFrameCount;
+}
+
+uint64_t RecordingBackend::AllocateData(Pass& pass, uint64_t size)
+{
+    // Aligned like allocations from the upload ring
+    const uint64_t offset = (pass.mData.size() + 15) & ~uint64_t(15);
+    pass.mData.resize(offset + size);
+    return offset;
+}
+
+void RecordingBackend::RecordScene(Pass& pass)
+{
+    RecordedCommand clear = {};
+    clear.mType = RecordedCommand::Type::Clear;
+    clear.mColor = 0x003366;
+    pass.mCommands.push_back(clear);
+
+    const uint64_t offset = AllocateData(pass, sizeof(mSceneVertices));
+    memcpy(pass.mData.data() + offset, mSceneVertices.data(), sizeof(mSceneVertices));
+
+    RecordedCommand draw = {};
+    draw.mType = RecordedCommand::Type::Draw;
+    draw.mPipeline = RecordedPipeline::Textured;
+    draw.mSource = RecordedCommand::Source::PassData;
+    draw.mVertexCount = static_cast<uint32_t>(mSceneVertices.size());
+    draw.mCount = 1;
+    draw.mDataOffset = offset;
+    pass.mCommands.push_back(draw);
+}
+
+void RecordingBackend::RecordSprites(Pass& pass, SpriteBatch& batch)
+{
+    if (batch.IsEmpty())
+    {
+        return;
+    }
+
+    const uint64_t offset = AllocateData(pass, batch.GetSpriteCount() * sizeof(SpriteInstance));
+    mSpriteDraws.clear();
+    batch.Build(reinterpret_cast<SpriteInstance*>(pass.mData.data() + offset), mSpriteDraws);
+
+    for (const SpriteDraw& spriteDraw : mSpriteDraws)
+    {
+        // Sprites on a page that doesn't exist are skipped, like the D3D12 backend does
+        if (spriteDraw.mTexture >= mPages.size())
+        {
+            continue;
+        }
+
+        RecordedCommand draw = {};
+        draw.mType = RecordedCommand::Type::Draw;
+        draw.mPipeline = spriteDraw.mBlend == SpriteBlend::Opaque ? RecordedPipeline::SpriteOpaque : RecordedPipeline::SpriteAlpha;
+        draw.mSource = RecordedCommand::Source::PassData;
+        draw.mTexture = spriteDraw.mTexture;
+        draw.mVertexCount = 4;
+        draw.mCount = spriteDraw.mInstanceCount;
+        draw.mFirst = spriteDraw.mFirstInstance;
+        draw.mDataOffset = offset;
+        pass.mCommands.push_back(draw);
+    }
+}
+
+void RecordingBackend::RecordText(Pass& pass, RetainedText& retainedText, const GlyphPageArena& debugText)
+{
+    // Changed retained text is copied into the pass data first and from there into the retained glyphs, like the upload
+    // through the ring on the GPU
+    if (retainedText.HasChanges())
+    {
+        const uint64_t offset = AllocateData(pass, retainedText.GetChangedSlotCount() * sizeof(GlyphInstance));
+        mRetainedChanges.clear();
+        retainedText.FlushChanges(reinterpret_cast<GlyphInstance*>(pass.mData.data() + offset), mRetainedChanges);
+
+        uint64_t sourceOffset = offset;
+        for (const RetainedText::SlotRange& range : mRetainedChanges)
+        {
+            memcpy(&mRetainedGlyphs[range.mFirst], pass.mData.data() + sourceOffset, range.mCount * sizeof(GlyphInstance));
+
+            RecordedCommand upload = {};
+            upload.mType = RecordedCommand::Type::UploadRetainedText;
+            upload.mCount = range.mCount;
+            upload.mFirst = range.mFirst;
+            upload.mDataOffset = sourceOffset;
+            pass.mCommands.push_back(upload);
+
+            sourceOffset += range.mCount * sizeof(GlyphInstance);
+        }
+    }
+
+    RecordedCommand draw = {};
+    draw.mType = RecordedCommand::Type::Draw;
+    draw.mPipeline = RecordedPipeline::Text;
+    draw.mVertexCount = 4;
+
+    if (retainedText.GetSlotCount() > 0)
+    {
+        draw.mSource = RecordedCommand::Source::RetainedText;
+        draw.mCount = retainedText.GetSlotCount();
+        pass.mCommands.push_back(draw);
+    }
+
+    // Every page of debug text is copied and drawn on its own
+    draw.mSource = RecordedCommand::Source::PassData;
+    for (uint32_t pageIndex = 0; pageIndex < debugText.GetUsedPageCount(); ++pageIndex)
+    {
+        const GlyphPageArena::Page& page = debugText.GetPage(pageIndex);
+        draw.mCount = page.mCount;
+        draw.mDataOffset = AllocateData(pass, page.mCount * sizeof(GlyphInstance));
+        memcpy(pass.mData.data() + draw.mDataOffset, page.mGlyphs.get(), page.mCount * sizeof(GlyphInstance));
+        pass.mCommands.push_back(draw);
+    }
+}
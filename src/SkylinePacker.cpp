@@ -0,0 +1,122 @@
+#include <SkylinePacker.h>
+
+#include <algorithm>
+
+void SkylinePacker::Initialize(uint32_t width, uint32_t height, uint32_t padding)
+{
+    mWidth = width;
+    mHeight = height;
+    mPadding = padding;
+    Reset();
+}
+
+void SkylinePacker::Reset()
+{
+    mSkyline.clear();
+    mSkyline.push_back({ 0, 0, mWidth });
+    mUsedArea = 0;
+}
+
+bool SkylinePacker::Allocate(uint32_t width, uint32_t height, AtlasRect& rect)
+{
+    if (width == 0 || height == 0)
+    {
+        return false;
+    }
+
+    // The padding may hang off the right and bottom edge of the page, it is never sampled there
+    const uint32_t paddedWidth = width + mPadding;
+    const uint32_t paddedHeight = height + mPadding;
+
+    size_t bestIndex = mSkyline.size();
+    uint32_t bestY = 0;
+    uint32_t bestBottom = UINT32_MAX;
+    uint32_t bestSegmentWidth = UINT32_MAX;
+    for (size_t i = 0; i < mSkyline.size(); ++i)
+    {
+        uint32_t y;
+        if (!Fit(i, width, height, y))
+        {
+            continue;
+        }
+
+        // Lowest top edge first, then the narrowest segment to leave the wide ones for wide rectangles
+        const uint32_t bottom = y + paddedHeight;
+        if (bottom < bestBottom || (bottom == bestBottom && mSkyline[i].mWidth < bestSegmentWidth))
+        {
+            bestIndex = i;
+            bestY = y;
+            bestBottom = bottom;
+            bestSegmentWidth = mSkyline[i].mWidth;
+        }
+    }
+
+    if (bestIndex == mSkyline.size())
+    {
+        return false;
+    }
+
+    rect = { mSkyline[bestIndex].mX, bestY, width, height };
+    mUsedArea += static_cast<uint64_t>(paddedWidth) * paddedHeight;
+
+    // Raise the skyline under the new rectangle and cut the segments it covers
+    const Segment raised = { rect.mX, bestY + paddedHeight, std::min(paddedWidth, mWidth - rect.mX) };
+    mSkyline.insert(mSkyline.begin() + bestIndex, raised);
+
+    const uint32_t right = raised.mX + raised.mWidth;
+    size_t next = bestIndex + 1;
+    while (next < mSkyline.size() && mSkyline[next].mX < right)
+    {
+        Segment& segment = mSkyline[next];
+        const uint32_t segmentRight = segment.mX + segment.mWidth;
+        if (segmentRight <= right)
+        {
+            mSkyline.erase(mSkyline.begin() + next);
+            continue;
+        }
+
+        segment.mWidth = segmentRight - right;
+        segment.mX = right;
+        break;
+    }
+
+    // Merge neighbours at the same height so the skyline stays short
+    for (size_t i = 0; i + 1 < mSkyline.size();)
+    {
+        if (mSkyline[i].mY == mSkyline[i + 1].mY)
+        {
+            mSkyline[i].mWidth += mSkyline[i + 1].mWidth;
+            mSkyline.erase(mSkyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    return true;
+}
+
+bool SkylinePacker::Fit(size_t index, uint32_t width, uint32_t height, uint32_t& y) const
+{
+    const uint32_t x = mSkyline[index].mX;
+    if (x + width > mWidth)
+    {
+        return false;
+    }
+
+    // The rectangle rests on the highest segment it spans
+    y = 0;
+    uint32_t remaining = std::min(width + mPadding, mWidth - x);
+    for (size_t i = index; remaining > 0; ++i)
+    {
+        y = std::max(y, mSkyline[i].mY);
+        if (y + height > mHeight)
+        {
+            return false;
+        }
+        remaining -= std::min(remaining, mSkyline[i].mWidth);
+    }
+
+    return true;
+}
@@ -0,0 +1,222 @@
+#include <SoftwareBackend.h>
+#include <Font.h>
+
+namespace
+{
+    // Same as the texture of TexturedTriangleRenderer
+    constexpr uint32_t SceneTextureSize = 256;
+    constexpr uint32_t SceneTexturePixelSize = 4;
+
+    // Corners of the quads the sprite and text shaders expand from SV_VertexID, in triangle strip order
+    constexpr float QuadCorners[4][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 1.0f } };
+
+    void SetColor(RasterVertex& vertex, float r, float g, float b, float a)
+    {
+        vertex.mR = r;
+        vertex.mG = g;
+        vertex.mB = b;
+        vertex.mA = a;
+    }
+
+    // Two triangles with the winding of the strip, the rasterizer doesn't cull
+    void AddQuad(SoftwareRasterizer& rasterizer, const RasterState& state, const RasterVertex (&corners)[4])
+    {
+        rasterizer.AddTriangle(state, corners[0], corners[1], corners[2]);
+        rasterizer.AddTriangle(state, corners[2], corners[1], corners[3]);
+    }
+}
+
+SoftwareBackend::SoftwareBackend(uint32_t width, uint32_t height, uint32_t workerCount)
+    : RecordingBackend(width, height, workerCount)
+{
+    mRasterizer.Initialize(width, height, workerCount);
+
+    mSceneTextureData = GenerateTextureData(SceneTextureSize, SceneTextureSize, SceneTexturePixelSize);
+    mSceneTexture = { mSceneTextureData.data(), SceneTextureSize, SceneTextureSize, SceneTexturePixelSize };
+    mFontTexture = { Font::Atlas.data(), Font::TextureWidth, Font::TextureHeight, Font::TexturePixelSize };
+}
+
+void SoftwareBackend::Submit()
+{
+    // Pages can be added between frames and move when they are, so their textures are looked up again every frame
+    mPageTextures.resize(GetPageCount());
+    for (SpriteTexture texture = 0; texture < mPageTextures.size(); ++texture)
+    {
+        const Page& page = GetPage(texture);
+        mPageTextures[texture] = { page.mPixels.data(), page.mPacker.GetWidth(), page.mPacker.GetHeight(), 4 };
+    }
+
+    // The passes are drawn in the order their command lists are executed in
+    for (uint32_t pass = 0; pass < RenderPassCount; ++pass)
+    {
+        DrawPass(GetPass(static_cast<RenderPass>(pass)));
+    }
+
+    mRasterizer.Rasterize();
+}
+
+void SoftwareBackend::DrawPass(const Pass& pass)
+{
+    for (const RecordedCommand& command : pass.mCommands)
+    {
+        switch (command.mType)
+        {
+        case RecordedCommand::Type::Clear:
+            mRasterizer.Clear(command.mColor);
+            break;
+        case RecordedCommand::Type::UploadRetainedText:
+            // Already applied to the retained glyphs while recording
+            break;
+        case RecordedCommand::Type::Draw:
+            switch (command.mPipeline)
+            {
+            case RecordedPipeline::Color:
+                DrawColorTriangles(pass, command);
+                break;
+            case RecordedPipeline::Textured:
+                DrawTexturedTriangles(pass, command);
+                break;
+            case RecordedPipeline::SpriteOpaque:
+            case RecordedPipeline::SpriteAlpha:
+                DrawSprites(pass, command);
+                break;
+            case RecordedPipeline::Text:
+                if (command.mSource == RecordedCommand::Source::RetainedText)
+                {
+                    DrawGlyphs(GetRetainedGlyphs().data() + command.mFirst, command.mCount);
+                }
+                else
+                {
+                    DrawGlyphs(reinterpret_cast<const GlyphInstance*>(pass.mData.data() + command.mDataOffset), command.mCount);
+                }
+                break;
+            }
+            break;
+        }
+    }
+}
+
+void SoftwareBackend::DrawColorTriangles(const Pass& pass, const RecordedCommand& command)
+{
+    const RasterState state;
+    const ColorVertex* vertices = reinterpret_cast<const ColorVertex*>(pass.mData.data() + command.mDataOffset);
+    for (uint32_t i = 0; i + 2 < command.mVertexCount * command.mCount; i += 3)
+    {
+        RasterVertex corners[3];
+        for (uint32_t corner = 0; corner < 3; ++corner)
+        {
+            const ColorVertex& vertex = vertices[i + corner];
+            corners[corner] = ToPixels(vertex.mX, vertex.mY);
+            SetColor(corners[corner], vertex.mR, vertex.mG, vertex.mB, vertex.mA);
+        }
+        mRasterizer.AddTriangle(state, corners[0], corners[1], corners[2]);
+    }
+}
+
+void SoftwareBackend::DrawTexturedTriangles(const Pass& pass, const RecordedCommand& command)
+{
+    // The static sampler of TexturedTriangleRenderer
+    RasterState state;
+    state.mShader = RasterShader::Texture;
+    state.mFilter = RasterFilter::Point;
+    state.mAddress = RasterAddress::Border;
+    state.mTexture = &mSceneTexture;
+
+    const TexturedVertex* vertices = reinterpret_cast<const TexturedVertex*>(pass.mData.data() + command.mDataOffset);
+    for (uint32_t i = 0; i + 2 < command.mVertexCount * command.mCount; i += 3)
+    {
+        RasterVertex corners[3];
+        for (uint32_t corner = 0; corner < 3; ++corner)
+        {
+            const TexturedVertex& vertex = vertices[i + corner];
+            corners[corner] = ToPixels(vertex.mX, vertex.mY);
+            corners[corner].mU = vertex.mU;
+            corners[corner].mV = vertex.mV;
+        }
+        mRasterizer.AddTriangle(state, corners[0], corners[1], corners[2]);
+    }
+}
+
+void SoftwareBackend::DrawSprites(const Pass& pass, const RecordedCommand& command)
+{
+    RasterState state;
+    state.mShader = RasterShader::TextureTimesColor;
+    state.mFilter = RasterFilter::Point;
+    state.mAddress = RasterAddress::Clamp;
+    state.mAlphaBlend = command.mPipeline == RecordedPipeline::SpriteAlpha;
+    state.mTexture = &mPageTextures[command.mTexture];
+
+    const SpriteInstance* instances = reinterpret_cast<const SpriteInstance*>(pass.mData.data() + command.mDataOffset) + command.mFirst;
+    for (uint32_t i = 0; i < command.mCount; ++i)
+    {
+        const SpriteInstance& instance = instances[i];
+        const float r = (instance.mColor & 0xFF) / 255.0f;
+        const float g = ((instance.mColor >> 8) & 0xFF) / 255.0f;
+        const float b = ((instance.mColor >> 16) & 0xFF) / 255.0f;
+        const float a = (instance.mColor >> 24) / 255.0f;
+
+        RasterVertex corners[4];
+        for (uint32_t corner = 0; corner < 4; ++corner)
+        {
+            const float cornerX = QuadCorners[corner][0];
+            const float cornerY = QuadCorners[corner][1];
+            corners[corner].mX = instance.mX + cornerX * instance.mWidth;
+            corners[corner].mY = instance.mY + cornerY * instance.mHeight;
+            corners[corner].mU = instance.mU0 + (instance.mU1 - instance.mU0) * cornerX;
+            corners[corner].mV = instance.mV0 + (instance.mV1 - instance.mV0) * cornerY;
+            SetColor(corners[corner], r, g, b, a);
+        }
+        AddQuad(mRasterizer, state, corners);
+    }
+}
+
+void SoftwareBackend::DrawGlyphs(const GlyphInstance* glyphs, uint32_t count)
+{
+    RasterState state;
+    state.mShader = RasterShader::Coverage;
+    state.mFilter = RasterFilter::Point;
+    state.mAddress = RasterAddress::Clamp;
+    state.mAlphaBlend = true;
+    state.mTexture = &mFontTexture;
+
+    constexpr float charWidth = static_cast<float>(Font::CharWidth);
+    constexpr float charHeight = static_cast<float>(Font::CharHeight);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        // Hidden slots of the retained text are far off screen and would be dropped by the rasterizer anyway
+        const GlyphInstance& glyph = glyphs[i];
+        if (glyph.mX == HiddenGlyph.mX && glyph.mY == HiddenGlyph.mY)
+        {
+            continue;
+        }
+
+        // The same expansion as the vertex shader in text.hlsl
+        const uint32_t index = glyph.mGlyphAndColor & 0xFF;
+        const float cellX = static_cast<float>(index % Font::CharsPerRow);
+        const float cellY = static_cast<float>(index / Font::CharsPerRow);
+        const float r = ((glyph.mGlyphAndColor >> 8) & 0xFF) / 255.0f;
+        const float g = ((glyph.mGlyphAndColor >> 16) & 0xFF) / 255.0f;
+        const float b = (glyph.mGlyphAndColor >> 24) / 255.0f;
+
+        RasterVertex corners[4];
+        for (uint32_t corner = 0; corner < 4; ++corner)
+        {
+            const float cornerX = QuadCorners[corner][0];
+            const float cornerY = QuadCorners[corner][1];
+            corners[corner].mX = glyph.mX + cornerX * charWidth;
+            corners[corner].mY = glyph.mY + cornerY * charHeight;
+            corners[corner].mU = (cellX + cornerX) * charWidth / Font::TextureWidth;
+            corners[corner].mV = (cellY + cornerY) * charHeight / Font::TextureHeight;
+            SetColor(corners[corner], r, g, b, 1.0f);
+        }
+        AddQuad(mRasterizer, state, corners);
+    }
+}
+
+RasterVertex SoftwareBackend::ToPixels(float x, float y) const
+{
+    RasterVertex vertex = {};
+    vertex.mX = (x + 1.0f) * 0.5f * GetWidth();
+    vertex.mY = (1.0f - y) * 0.5f * GetHeight();
+    return vertex;
+}
@@ -0,0 +1,430 @@
+#include <SoftwareRasterizer.h>
+#include <Log.h>
+#include <Util.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#if !defined(_M_X64) && !defined(__SSE2__)
+#error The software rasterizer needs SSE2
+#endif
+#include <emmintrin.h>
+
+namespace
+{
+    // Same subpixel precision as D3D12. Snapped positions and their differences are exact in a float.
+    constexpr float SubpixelScale = 256.0f;
+
+    float Snap(float value)
+    {
+        return std::round(value * SubpixelScale) / SubpixelScale;
+    }
+
+    // SSE2 has no floor. Truncating rounds up for negative values, so step those down.
+    __m128 Floor(__m128 value)
+    {
+        const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+        return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, value), _mm_set1_ps(1.0f)));
+    }
+
+    // Four pixels, one channel per register
+    struct Color4
+    {
+        __m128 mR;
+        __m128 mG;
+        __m128 mB;
+        __m128 mA;
+    };
+
+    Color4 Unpack(__m128i pixels)
+    {
+        const __m128i mask = _mm_set1_epi32(0xFF);
+        const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+        return { _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(pixels, mask)), scale),
+                 _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 8), mask)), scale),
+                 _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 16), mask)), scale),
+                 _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(pixels, 24)), scale) };
+    }
+
+    // Rounds to the nearest value like the conversion to UNORM on the GPU
+    __m128i PackChannel(__m128 value)
+    {
+        const __m128 clamped = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+        return _mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(255.0f)));
+    }
+
+    __m128i Pack(const Color4& color)
+    {
+        return _mm_or_si128(_mm_or_si128(PackChannel(color.mR), _mm_slli_epi32(PackChannel(color.mG), 8)),
+                            _mm_or_si128(_mm_slli_epi32(PackChannel(color.mB), 16), _mm_slli_epi32(PackChannel(color.mA), 24)));
+    }
+
+    __m128 Lerp(__m128 a, __m128 b, __m128 t)
+    {
+        return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+    }
+
+    Color4 Lerp(const Color4& a, const Color4& b, __m128 t)
+    {
+        return { Lerp(a.mR, b.mR, t), Lerp(a.mG, b.mG, t), Lerp(a.mB, b.mB, t), Lerp(a.mA, b.mA, t) };
+    }
+
+    uint32_t FetchTexel(const RasterTexture& texture, int32_t x, int32_t y, RasterAddress address)
+    {
+        const int32_t width = static_cast<int32_t>(texture.mWidth);
+        const int32_t height = static_cast<int32_t>(texture.mHeight);
+        if (address == RasterAddress::Border)
+        {
+            if (x < 0 || y < 0 || x >= width || y >= height)
+            {
+                return 0;
+            }
+        }
+        else
+        {
+            x = std::clamp(x, 0, width - 1);
+            y = std::clamp(y, 0, height - 1);
+        }
+
+        const size_t index = static_cast<size_t>(y) * texture.mWidth + x;
+        if (texture.mPixelSize == 1)
+        {
+            return texture.mPixels[index] | 0xFF000000;
+        }
+
+        uint32_t texel;
+        memcpy(&texel, texture.mPixels + index * 4, sizeof(texel));
+        return texel;
+    }
+
+    // The coordinates are worked out four at a time, only the texel reads are done one by one
+    Color4 Sample(const RasterState& state, __m128 u, __m128 v)
+    {
+        const RasterTexture& texture = *state.mTexture;
+        const __m128 width = _mm_set1_ps(static_cast<float>(texture.mWidth));
+        const __m128 height = _mm_set1_ps(static_cast<float>(texture.mHeight));
+
+        alignas(16) int32_t x[4];
+        alignas(16) int32_t y[4];
+        if (state.mFilter == RasterFilter::Point)
+        {
+            _mm_store_si128(reinterpret_cast<__m128i*>(x), _mm_cvttps_epi32(Floor(_mm_mul_ps(u, width))));
+            _mm_store_si128(reinterpret_cast<__m128i*>(y), _mm_cvttps_epi32(Floor(_mm_mul_ps(v, height))));
+
+            alignas(16) uint32_t texels[4];
+            for (uint32_t lane = 0; lane < 4; ++lane)
+            {
+                texels[lane] = FetchTexel(texture, x[lane], y[lane], state.mAddress);
+            }
+            return Unpack(_mm_load_si128(reinterpret_cast<const __m128i*>(texels)));
+        }
+
+        // Texel centers are half a texel in, blend the four around the sample point
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 tx = _mm_sub_ps(_mm_mul_ps(u, width), half);
+        const __m128 ty = _mm_sub_ps(_mm_mul_ps(v, height), half);
+        const __m128 x0 = Floor(tx);
+        const __m128 y0 = Floor(ty);
+        _mm_store_si128(reinterpret_cast<__m128i*>(x), _mm_cvttps_epi32(x0));
+        _mm_store_si128(reinterpret_cast<__m128i*>(y), _mm_cvttps_epi32(y0));
+
+        alignas(16) uint32_t texels[4][4];
+        for (uint32_t lane = 0; lane < 4; ++lane)
+        {
+            texels[0][lane] = FetchTexel(texture, x[lane], y[lane], state.mAddress);
+            texels[1][lane] = FetchTexel(texture, x[lane] + 1, y[lane], state.mAddress);
+            texels[2][lane] = FetchTexel(texture, x[lane], y[lane] + 1, state.mAddress);
+            texels[3][lane] = FetchTexel(texture, x[lane] + 1, y[lane] + 1, state.mAddress);
+        }
+
+        const __m128 fx = _mm_sub_ps(tx, x0);
+        const __m128 fy = _mm_sub_ps(ty, y0);
+        const Color4 top = Lerp(Unpack(_mm_load_si128(reinterpret_cast<const __m128i*>(texels[0]))), Unpack(_mm_load_si128(reinterpret_cast<const __m128i*>(texels[1]))), fx);
+        const Color4 bottom = Lerp(Unpack(_mm_load_si128(reinterpret_cast<const __m128i*>(texels[2]))), Unpack(_mm_load_si128(reinterpret_cast<const __m128i*>(texels[3]))), fx);
+        return Lerp(top, bottom, fy);
+    }
+
+    // A pixel exactly on an edge only belongs to the triangle if it is a top or left edge
+    __m128 InsideEdge(__m128 edge, bool topLeft)
+    {
+        return topLeft ? _mm_cmpge_ps(edge, _mm_setzero_ps()) : _mm_cmpgt_ps(edge, _mm_setzero_ps());
+    }
+}
+
+void SoftwareRasterizer::Initialize(uint32_t width, uint32_t height, uint32_t workerCount)
+{
+    mWidth = width;
+    mHeight = height;
+    mTilesX = (width + TileSize - 1) / TileSize;
+    mTilesY = (height + TileSize - 1) / TileSize;
+    mPitch = mTilesX * TileSize;
+    mPixels.assign(static_cast<size_t>(mPitch) * mTilesY * TileSize, 0);
+    mBins.resize(mTilesX * mTilesY);
+
+    // Every thread takes tiles until there are none left, so a pass per thread is enough
+    for (uint32_t i = 0; i <= workerCount; ++i)
+    {
+        mPassRecorder.AddPass("Tiles", [this](uint32_t) { RasterizeTiles(); });
+    }
+    mPassRecorder.Start(workerCount);
+}
+
+void SoftwareRasterizer::Clear(uint32_t color)
+{
+    mClearColor = ((color >> 16) & 0xFF) | (color & 0xFF00) | ((color & 0xFF) << 16) | 0xFF000000;
+    mTriangles.clear();
+    for (std::vector<uint32_t>& bin : mBins)
+    {
+        bin.clear();
+    }
+}
+
+void SoftwareRasterizer::AddTriangle(const RasterState& state, const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2)
+{
+    const RasterVertex* vertices[3] = { &v0, &v1, &v2 };
+    float x[3] = { Snap(v0.mX), Snap(v1.mX), Snap(v2.mX) };
+    float y[3] = { Snap(v0.mY), Snap(v1.mY), Snap(v2.mY) };
+
+    // Twice the signed area. This is exact in a double since the positions are snapped.
+    double area = (static_cast<double>(x[1]) - x[0]) * (static_cast<double>(y[2]) - y[0]) - (static_cast<double>(y[1]) - y[0]) * (static_cast<double>(x[2]) - x[0]);
+    if (area == 0.0)
+    {
+        return;
+    }
+
+    // Nothing the renderer draws is back facing, so there is no culling. Turn every triangle the same way instead, so
+    // that the inside of every edge is where its edge function is positive.
+    if (area < 0.0)
+    {
+        std::swap(vertices[1], vertices[2]);
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        area = -area;
+    }
+
+    // Pixels whose centers fall within the bounds, clipped to the target
+    const int32_t minX = std::max(static_cast<int32_t>(std::ceil(std::min({ x[0], x[1], x[2] }) - 0.5f)), 0);
+    const int32_t minY = std::max(static_cast<int32_t>(std::ceil(std::min({ y[0], y[1], y[2] }) - 0.5f)), 0);
+    const int32_t maxX = std::min(static_cast<int32_t>(std::floor(std::max({ x[0], x[1], x[2] }) - 0.5f)), static_cast<int32_t>(mWidth) - 1);
+    const int32_t maxY = std::min(static_cast<int32_t>(std::floor(std::max({ y[0], y[1], y[2] }) - 0.5f)), static_cast<int32_t>(mHeight) - 1);
+    if (minX > maxX || minY > maxY)
+    {
+        return;
+    }
+
+    const uint32_t triangleIndex = static_cast<uint32_t>(mTriangles.size());
+    Triangle& triangle = mTriangles.emplace_back();
+    triangle.mState = state;
+    triangle.mMinX = minX;
+    triangle.mMinY = minY;
+    triangle.mMaxX = maxX;
+    triangle.mMaxY = maxY;
+
+    // All three edges at once. Edge i goes from vertex i to vertex i + 1, its function is A * x + B * y + C.
+    const __m128 xs = _mm_set_ps(0.0f, x[2], x[1], x[0]);
+    const __m128 ys = _mm_set_ps(0.0f, y[2], y[1], y[0]);
+    const __m128 nextXs = _mm_shuffle_ps(xs, xs, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 nextYs = _mm_shuffle_ps(ys, ys, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 edgeA = _mm_sub_ps(ys, nextYs);
+    const __m128 edgeB = _mm_sub_ps(nextXs, xs);
+    _mm_store_ps(triangle.mX, xs);
+    _mm_store_ps(triangle.mY, ys);
+    _mm_store_ps(triangle.mEdgeA, edgeA);
+    _mm_store_ps(triangle.mEdgeB, edgeB);
+
+    // With y pointing down, left edges go up and top edges are flat and go right
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 topLeft = _mm_or_ps(_mm_cmpgt_ps(edgeA, zero), _mm_and_ps(_mm_cmpeq_ps(edgeA, zero), _mm_cmpgt_ps(edgeB, zero)));
+    triangle.mTopLeftEdges = static_cast<uint32_t>(_mm_movemask_ps(topLeft)) & 7;
+
+    // Attribute gradients, four attributes at a time
+    const float invArea = static_cast<float>(1.0 / area);
+    const __m128 x1 = _mm_set1_ps(x[1] - x[0]);
+    const __m128 y1 = _mm_set1_ps(y[1] - y[0]);
+    const __m128 x2 = _mm_set1_ps(x[2] - x[0]);
+    const __m128 y2 = _mm_set1_ps(y[2] - y[0]);
+    const __m128 scale = _mm_set1_ps(invArea);
+    for (uint32_t group = 0; group < 2; ++group)
+    {
+        __m128 attributes[3];
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            const RasterVertex& vertex = *vertices[i];
+            attributes[i] = group == 0 ? _mm_set_ps(vertex.mG, vertex.mR, vertex.mV, vertex.mU) : _mm_set_ps(0.0f, 0.0f, vertex.mA, vertex.mB);
+        }
+
+        const __m128 d1 = _mm_sub_ps(attributes[1], attributes[0]);
+        const __m128 d2 = _mm_sub_ps(attributes[2], attributes[0]);
+        _mm_store_ps(triangle.mAttributes + group * 4, attributes[0]);
+        _mm_store_ps(triangle.mAttributesDx + group * 4, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(d1, y2), _mm_mul_ps(d2, y1)), scale));
+        _mm_store_ps(triangle.mAttributesDy + group * 4, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(d2, x1), _mm_mul_ps(d1, x2)), scale));
+    }
+
+    for (uint32_t tileY = minY / TileSize; tileY <= maxY / TileSize; ++tileY)
+    {
+        for (uint32_t tileX = minX / TileSize; tileX <= maxX / TileSize; ++tileX)
+        {
+            mBins[tileY * mTilesX + tileX].push_back(triangleIndex);
+        }
+    }
+}
+
+void SoftwareRasterizer::Rasterize()
+{
+    mNextTile = 0;
+    mPassRecorder.Execute();
+}
+
+void SoftwareRasterizer::RasterizeTiles()
+{
+    const uint32_t tileCount = mTilesX * mTilesY;
+    for (uint32_t tileIndex = mNextTile++; tileIndex < tileCount; tileIndex = mNextTile++)
+    {
+        RasterizeTile(tileIndex);
+    }
+}
+
+void SoftwareRasterizer::RasterizeTile(uint32_t tileIndex)
+{
+    const int32_t originX = static_cast<int32_t>((tileIndex % mTilesX) * TileSize);
+    const int32_t originY = static_cast<int32_t>((tileIndex / mTilesX) * TileSize);
+
+    for (int32_t y = originY; y < originY + static_cast<int32_t>(TileSize); ++y)
+    {
+        uint32_t* row = mPixels.data() + static_cast<size_t>(y) * mPitch + originX;
+        std::fill(row, row + TileSize, mClearColor);
+    }
+
+    const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+    for (uint32_t triangleIndex : mBins[tileIndex])
+    {
+        const Triangle& triangle = mTriangles[triangleIndex];
+        const RasterState& state = triangle.mState;
+
+        // The edge functions are evaluated relative to the tile to keep the values small. Every triangle does this the
+        // same way, so the two triangles on either side of an edge get exactly opposite values and only one draws a pixel
+        // that is on it.
+        const __m128 x = _mm_sub_ps(_mm_load_ps(triangle.mX), _mm_set1_ps(static_cast<float>(originX)));
+        const __m128 y = _mm_sub_ps(_mm_load_ps(triangle.mY), _mm_set1_ps(static_cast<float>(originY)));
+        const __m128 nextX = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 0, 2, 1));
+        const __m128 nextY = _mm_shuffle_ps(y, y, _MM_SHUFFLE(3, 0, 2, 1));
+        alignas(16) float edgeC[4];
+        _mm_store_ps(edgeC, _mm_sub_ps(_mm_mul_ps(x, nextY), _mm_mul_ps(y, nextX)));
+
+        const __m128 edgeA0 = _mm_set1_ps(triangle.mEdgeA[0]);
+        const __m128 edgeA1 = _mm_set1_ps(triangle.mEdgeA[1]);
+        const __m128 edgeA2 = _mm_set1_ps(triangle.mEdgeA[2]);
+        const bool topLeft0 = (triangle.mTopLeftEdges & 1) != 0;
+        const bool topLeft1 = (triangle.mTopLeftEdges & 2) != 0;
+        const bool topLeft2 = (triangle.mTopLeftEdges & 4) != 0;
+
+        // Columns are done in aligned groups of four, which can start left of the triangle
+        const int32_t minX = std::max(triangle.mMinX, originX) & ~3;
+        const int32_t maxX = std::min(triangle.mMaxX, originX + static_cast<int32_t>(TileSize) - 1);
+        const int32_t minY = std::max(triangle.mMinY, originY);
+        const int32_t maxY = std::min(triangle.mMaxY, originY + static_cast<int32_t>(TileSize) - 1);
+
+        for (int32_t pixelY = minY; pixelY <= maxY; ++pixelY)
+        {
+            const float localY = static_cast<float>(pixelY - originY) + 0.5f;
+            const __m128 rowEdge0 = _mm_set1_ps(triangle.mEdgeB[0] * localY + edgeC[0]);
+            const __m128 rowEdge1 = _mm_set1_ps(triangle.mEdgeB[1] * localY + edgeC[1]);
+            const __m128 rowEdge2 = _mm_set1_ps(triangle.mEdgeB[2] * localY + edgeC[2]);
+            const __m128 dy = _mm_set1_ps(static_cast<float>(pixelY) + 0.5f - triangle.mY[0]);
+
+            uint32_t* row = mPixels.data() + static_cast<size_t>(pixelY) * mPitch;
+            for (int32_t pixelX = minX; pixelX <= maxX; pixelX += 4)
+            {
+                const __m128 localX = _mm_add_ps(_mm_set1_ps(static_cast<float>(pixelX - originX)), laneOffsets);
+                const __m128 inside = _mm_and_ps(_mm_and_ps(InsideEdge(_mm_add_ps(_mm_mul_ps(edgeA0, localX), rowEdge0), topLeft0),
+                                                            InsideEdge(_mm_add_ps(_mm_mul_ps(edgeA1, localX), rowEdge1), topLeft1)),
+                                                 InsideEdge(_mm_add_ps(_mm_mul_ps(edgeA2, localX), rowEdge2), topLeft2));
+                if (_mm_movemask_ps(inside) == 0)
+                {
+                    continue;
+                }
+
+                const __m128 dx = _mm_sub_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(pixelX)), laneOffsets), _mm_set1_ps(triangle.mX[0]));
+                auto attribute = [&](uint32_t index)
+                {
+                    return _mm_add_ps(_mm_set1_ps(triangle.mAttributes[index]),
+                                      _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.mAttributesDx[index]), dx), _mm_mul_ps(_mm_set1_ps(triangle.mAttributesDy[index]), dy)));
+                };
+
+                Color4 color = {};
+                switch (state.mShader)
+                {
+                case RasterShader::VertexColor:
+                    color = { attribute(2), attribute(3), attribute(4), attribute(5) };
+                    break;
+                case RasterShader::Texture:
+                    color = Sample(state, attribute(0), attribute(1));
+                    break;
+                case RasterShader::TextureTimesColor:
+                    color = Sample(state, attribute(0), attribute(1));
+                    color = { _mm_mul_ps(color.mR, attribute(2)), _mm_mul_ps(color.mG, attribute(3)), _mm_mul_ps(color.mB, attribute(4)), _mm_mul_ps(color.mA, attribute(5)) };
+                    break;
+                case RasterShader::Coverage:
+                    color = { attribute(2), attribute(3), attribute(4), Sample(state, attribute(0), attribute(1)).mR };
+                    break;
+                }
+
+                __m128i* target = reinterpret_cast<__m128i*>(row + pixelX);
+                const __m128i previous = _mm_loadu_si128(target);
+
+                // The alpha of the target is replaced, like the blend states of the sprite and text pipelines
+                if (state.mAlphaBlend)
+                {
+                    const Color4 destination = Unpack(previous);
+                    color.mR = Lerp(destination.mR, color.mR, color.mA);
+                    color.mG = Lerp(destination.mG, color.mG, color.mA);
+                    color.mB = Lerp(destination.mB, color.mB, color.mA);
+                }
+
+                const __m128i mask = _mm_castps_si128(inside);
+                _mm_storeu_si128(target, _mm_or_si128(_mm_and_si128(mask, Pack(color)), _mm_andnot_si128(mask, previous)));
+            }
+        }
+    }
+}
+
+bool SoftwareRasterizer::WriteTga(std::string_view path) const
+{
+    std::ofstream file(std::string(path), std::ios::binary);
+    if (!file)
+    {
+        LOG_WARN(Renderer, "Could not write %s", std::string(path).c_str());
+        return false;
+    }
+
+    // Uncompressed true color with 8 bits of alpha, stored top to bottom
+    uint8_t header[18] = {};
+    header[2] = 2;
+    header[12] = static_cast<uint8_t>(mWidth & 0xFF);
+    header[13] = static_cast<uint8_t>(mWidth >> 8);
+    header[14] = static_cast<uint8_t>(mHeight & 0xFF);
+    header[15] = static_cast<uint8_t>(mHeight >> 8);
+    header[16] = 32;
+    header[17] = 0x28;
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    // TGA wants BGRA
+    std::vector<uint8_t> row(mWidth * 4);
+    for (uint32_t y = 0; y < mHeight; ++y)
+    {
+        for (uint32_t x = 0; x < mWidth; ++x)
+        {
+            const uint32_t pixel = GetPixel(x, y);
+            row[x * 4 + 0] = static_cast<uint8_t>(pixel >> 16);
+            row[x * 4 + 1] = static_cast<uint8_t>(pixel >> 8);
+            row[x * 4 + 2] = static_cast<uint8_t>(pixel);
+            row[x * 4 + 3] = static_cast<uint8_t>(pixel >> 24);
+        }
+        file.write(reinterpret_cast<const char*>(row.data()), row.size());
+    }
+
+    return static_cast<bool>(file);
+}
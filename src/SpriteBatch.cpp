@@ -0,0 +1,88 @@
+#include <SpriteBatch.h>
+
+#include <array>
+
+void SpriteBatch::Add(const Sprite& sprite)
+{
+    mSprites.push_back(sprite);
+}
+
+void SpriteBatch::Clear()
+{
+    mSprites.clear();
+}
+
+void SpriteBatch::Build(SpriteInstance* instances, std::vector<SpriteDraw>& draws)
+{
+    Sort();
+
+    for (uint32_t i = 0; i < mSortEntries.size(); ++i)
+    {
+        const Sprite& sprite = mSprites[static_cast<uint32_t>(mSortEntries[i])];
+
+        // The input layout reads the color as R8G8B8A8_UNORM
+        const uint32_t color = ((sprite.mColor >> 16) & 0xFF) | (sprite.mColor & 0xFF00) | ((sprite.mColor & 0xFF) << 16) | 0xFF000000;
+        instances[i] = { sprite.mX, sprite.mY, sprite.mWidth, sprite.mHeight, sprite.mU0, sprite.mV0, sprite.mU1, sprite.mV1, color };
+
+        const bool sameKey = i > 0 && (mSortEntries[i] >> 32) == (mSortEntries[i - 1] >> 32);
+        if (sameKey)
+        {
+            ++draws.back().mInstanceCount;
+        }
+        else
+        {
+            draws.push_back({ sprite.mBlend, sprite.mTexture, i, 1 });
+        }
+    }
+}
+
+uint32_t SpriteBatch::MakeKey(const Sprite& sprite)
+{
+    return (static_cast<uint32_t>(sprite.mLayer) << 24) | (static_cast<uint32_t>(sprite.mBlend) << 16) | sprite.mTexture;
+}
+
+void SpriteBatch::Sort()
+{
+    const size_t count = mSprites.size();
+    mSortEntries.resize(count);
+    mSortScratch.resize(count);
+    if (count == 0)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        mSortEntries[i] = (static_cast<uint64_t>(MakeKey(mSprites[i])) << 32) | i;
+    }
+
+    // Least significant byte first, one pass per byte of the key. Most frames only use a few layers and textures, so
+    // passes where every entry has the same byte are skipped.
+    for (uint32_t shift = 32; shift < 64; shift += 8)
+    {
+        std::array<uint32_t, 256> offsets = {};
+        for (uint64_t entry : mSortEntries)
+        {
+            ++offsets[(entry >> shift) & 0xFF];
+        }
+
+        if (offsets[(mSortEntries[0] >> shift) & 0xFF] == count)
+        {
+            continue;
+        }
+
+        uint32_t total = 0;
+        for (uint32_t& offset : offsets)
+        {
+            const uint32_t bucketSize = offset;
+            offset = total;
+            total += bucketSize;
+        }
+
+        for (uint64_t entry : mSortEntries)
+        {
+            mSortScratch[offsets[(entry >> shift) & 0xFF]++] = entry;
+        }
+        mSortEntries.swap(mSortScratch);
+    }
+}
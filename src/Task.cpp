@@ -0,0 +1,67 @@
+#include <Task.h>
+#include <Log.h>
+#include <Util.h>
+
+#include <algorithm>
+
+void Task::promise_type::unhandled_exception()
+{
+    // Nothing waits for a task's result, so an exception would be lost along with whatever the task was doing
+    ensure(!"A task threw an exception");
+}
+
+void RunTask(Task task, JobCounter* counter)
+{
+    std::coroutine_handle<Task::promise_type> coroutine = std::exchange(task.mCoroutine, nullptr);
+    coroutine.promise().mCounter = counter;
+    if (counter != nullptr)
+    {
+        JobSystem::Get().AddWork(*counter);
+    }
+    JobSystem::Get().Resume(coroutine);
+}
+
+void TaskFence::Signal(uint64_t value)
+{
+    std::vector<Waiter> ready;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (value <= mCompletedValue.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        mCompletedValue.store(value, std::memory_order_release);
+
+        const auto firstWaiting = std::partition(mWaiters.begin(), mWaiters.end(), [value](const Waiter& waiter) { return waiter.mValue > value; });
+        ready.assign(firstWaiting, mWaiters.end());
+        mWaiters.erase(firstWaiting, mWaiters.end());
+    }
+
+    for (const Waiter& waiter : ready)
+    {
+        JobSystem::Get().Resume(waiter.mCoroutine);
+    }
+}
+
+bool TaskFence::AddWaiter(uint64_t value, std::coroutine_handle<> coroutine)
+{
+    // Checked again under the lock, the fence may have been signaled since await_ready
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mCompletedValue.load(std::memory_order_relaxed) >= value)
+    {
+        return false;
+    }
+
+    mWaiters.push_back({ value, coroutine });
+    return true;
+}
+
+void LoadAsset::await_suspend(std::coroutine_handle<> coroutine)
+{
+    // The completion runs on the main thread in DispatchCompletions, from where the task is handed to the job system
+    AssetStreamer::Get().Request(mPath, mPriority, std::move(mDecode), [this, coroutine](bool loaded)
+    {
+        mLoaded = loaded;
+        JobSystem::Get().Resume(coroutine);
+    });
+}
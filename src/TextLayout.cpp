@@ -0,0 +1,420 @@
+#include <TextLayout.h>
+#include <Font.h>
+
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define TEXT_LAYOUT_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    int16_t ClampToInt16(int32_t value)
+    {
+        return static_cast<int16_t>(std::clamp<int32_t>(value, INT16_MIN, INT16_MAX));
+    }
+
+    // Glyph index for every byte, with characters outside of the font replaced by '?'
+    constexpr std::array<uint8_t, 256> BuildGlyphTable()
+    {
+        std::array<uint8_t, 256> table = {};
+        for (uint32_t c = 0; c < 256; ++c)
+        {
+            const uint32_t glyph = c - Font::FirstChar < Font::NumChars ? c : '?';
+            table[c] = static_cast<uint8_t>(glyph - Font::FirstChar);
+        }
+        return table;
+    }
+
+    constexpr std::array<uint8_t, 256> GlyphTable = BuildGlyphTable();
+
+    void LayoutTextScalar(const char* text, size_t count, int32_t x, int16_t y, uint32_t colorBits, GlyphInstance* instances)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            instances[i].mX = ClampToInt16(x + static_cast<int32_t>(i * Font::CharWidth));
+            instances[i].mY = y;
+            instances[i].mGlyphAndColor = GlyphTable[static_cast<uint8_t>(text[i])] | colorBits;
+        }
+    }
+
+#if defined(TEXT_LAYOUT_SSE2)
+    static_assert(Font::NumChars < 256, "The SSE2 glyph range check compares bytes");
+
+    // Lays out 16 characters per iteration. Returns how many were done, the rest is left for the scalar loop.
+    size_t LayoutTextSSE2(const char* text, size_t count, int32_t x, int16_t y, uint32_t colorBits, GlyphInstance* instances)
+    {
+        const __m128i firstChar = _mm_set1_epi8(static_cast<char>(Font::FirstChar));
+        const __m128i signBit = _mm_set1_epi8(static_cast<char>(0x80));
+        const __m128i numChars = _mm_set1_epi8(static_cast<char>(Font::NumChars ^ 0x80));
+        const __m128i questionMark = _mm_set1_epi8(static_cast<char>('?' - Font::FirstChar));
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i color = _mm_set1_epi32(static_cast<int>(colorBits));
+        const __m128i glyphY = _mm_set1_epi16(y);
+
+        // x of the first four glyphs of a block, the others are 4 glyphs further along each time
+        const __m128i laneX = _mm_setr_epi32(0, Font::CharWidth, 2 * Font::CharWidth, 3 * Font::CharWidth);
+        const __m128i stepX = _mm_set1_epi32(4 * Font::CharWidth);
+
+        const size_t blockCount = count / 16;
+        for (size_t block = 0; block < blockCount; ++block)
+        {
+            // Turn the characters into glyph indices. Bytes outside of the font become '?', the range check is an
+            // unsigned compare done as a signed one by flipping the top bit.
+            const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + block * 16));
+            const __m128i glyphs = _mm_sub_epi8(chars, firstChar);
+            const __m128i inRange = _mm_cmplt_epi8(_mm_xor_si128(glyphs, signBit), numChars);
+            const __m128i indices = _mm_or_si128(_mm_and_si128(inRange, glyphs), _mm_andnot_si128(inRange, questionMark));
+
+            const __m128i indicesLow = _mm_unpacklo_epi8(indices, zero);
+            const __m128i indicesHigh = _mm_unpackhi_epi8(indices, zero);
+            const __m128i glyphWords[4] = {
+                _mm_or_si128(_mm_unpacklo_epi16(indicesLow, zero), color),
+                _mm_or_si128(_mm_unpackhi_epi16(indicesLow, zero), color),
+                _mm_or_si128(_mm_unpacklo_epi16(indicesHigh, zero), color),
+                _mm_or_si128(_mm_unpackhi_epi16(indicesHigh, zero), color),
+            };
+
+            // Positions are computed in 32 bits and saturated to 16 bits when packed, same as ClampToInt16
+            const __m128i x0 = _mm_add_epi32(_mm_set1_epi32(x + static_cast<int32_t>(block * 16 * Font::CharWidth)), laneX);
+            const __m128i x1 = _mm_add_epi32(x0, stepX);
+            const __m128i x2 = _mm_add_epi32(x1, stepX);
+            const __m128i x3 = _mm_add_epi32(x2, stepX);
+            const __m128i xLow = _mm_packs_epi32(x0, x1);
+            const __m128i xHigh = _mm_packs_epi32(x2, x3);
+            const __m128i positionWords[4] = {
+                _mm_unpacklo_epi16(xLow, glyphY),
+                _mm_unpackhi_epi16(xLow, glyphY),
+                _mm_unpacklo_epi16(xHigh, glyphY),
+                _mm_unpackhi_epi16(xHigh, glyphY),
+            };
+
+            // Interleave position and glyph words into two instances per store
+            __m128i* output = reinterpret_cast<__m128i*>(instances + block * 16);
+            for (int i = 0; i < 4; ++i)
+            {
+                _mm_storeu_si128(output + i * 2, _mm_unpacklo_epi32(positionWords[i], glyphWords[i]));
+                _mm_storeu_si128(output + i * 2 + 1, _mm_unpackhi_epi32(positionWords[i], glyphWords[i]));
+            }
+        }
+
+        return blockCount * 16;
+    }
+#endif
+}
+
+size_t LayoutText(std::string_view text, int32_t x, int32_t y, uint32_t color, GlyphInstance* instances, size_t capacity)
+{
+    const size_t count = std::min(text.size(), capacity);
+    const int16_t glyphY = ClampToInt16(y);
+    const uint32_t colorBits = PackGlyph(0, color);
+
+    size_t done = 0;
+#if defined(TEXT_LAYOUT_SSE2)
+    done = LayoutTextSSE2(text.data(), count, x, glyphY, colorBits, instances);
+#endif
+    LayoutTextScalar(text.data() + done, count - done, x + static_cast<int32_t>(done * Font::CharWidth), glyphY, colorBits, instances + done);
+
+    return count;
+}
+
+void ExpandGlyphInstance(const GlyphInstance& instance, float screenWidth, float screenHeight, GlyphVertex (&vertices)[4])
+{
+    const uint32_t packed = instance.mGlyphAndColor;
+    const char c = static_cast<char>((packed & 0xFF) + Font::FirstChar);
+    const uint32_t color = (((packed >> 8) & 0xFF) << 16) | (((packed >> 16) & 0xFF) << 8) | ((packed >> 24) & 0xFF);
+
+    float u1, v1, u2, v2;
+    Font::GetCharacterUVs(c, u1, v1, u2, v2);
+
+    for (uint32_t corner = 0; corner < 4; ++corner)
+    {
+        const uint32_t cornerX = corner & 1;
+        const uint32_t cornerY = corner >> 1;
+        const float pixelX = static_cast<float>(instance.mX + static_cast<int32_t>(cornerX * Font::CharWidth));
+        const float pixelY = static_cast<float>(instance.mY + static_cast<int32_t>(cornerY * Font::CharHeight));
+
+        vertices[corner].mX = (pixelX / screenWidth) * 2.0f - 1.0f;
+        vertices[corner].mY = 1.0f - (pixelY / screenHeight) * 2.0f;
+        vertices[corner].mU = cornerX ? u2 : u1;
+        vertices[corner].mV = cornerY ? v2 : v1;
+        vertices[corner].mColor = color;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+
+void GlyphPageArena::AddText(std::string_view text, int32_t x, int32_t y, uint32_t color)
+{
+    while (!text.empty())
+    {
+        if (mUsedPageCount == 0 || mPages[mUsedPageCount - 1].mCount == GlyphsPerPage)
+        {
+            if (mUsedPageCount == mPages.size())
+            {
+                mPages.emplace_back();
+                mPages.back().mGlyphs = std::make_unique<GlyphInstance[]>(GlyphsPerPage);
+            }
+            mPages[mUsedPageCount].mCount = 0;
+            ++mUsedPageCount;
+        }
+
+        Page& page = mPages[mUsedPageCount - 1];
+        const size_t count = LayoutText(text, x, y, color, page.mGlyphs.get() + page.mCount, GlyphsPerPage - page.mCount);
+        page.mCount += static_cast<uint32_t>(count);
+        mGlyphCount += static_cast<uint32_t>(count);
+
+        text.remove_prefix(count);
+        x += static_cast<int32_t>(count * Font::CharWidth);
+    }
+}
+
+void GlyphPageArena::Reset()
+{
+    for (uint32_t i = 0; i < mUsedPageCount; ++i)
+    {
+        mPages[i].mCount = 0;
+    }
+    mUsedPageCount = 0;
+    mGlyphCount = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+
+void RetainedText::Initialize(uint32_t maxSlots)
+{
+    *this = RetainedText();
+    mMaxSlots = maxSlots;
+}
+
+RetainedText::Handle RetainedText::Create(std::string_view text, int32_t x, int32_t y, uint32_t color)
+{
+    SlotRange slots = {};
+    if (!AllocateSlots(static_cast<uint32_t>(text.size()), slots))
+    {
+        return InvalidHandle;
+    }
+
+    Handle handle;
+    if (!mFreeHandles.empty())
+    {
+        handle = mFreeHandles.back();
+        mFreeHandles.pop_back();
+    }
+    else
+    {
+        handle = static_cast<Handle>(mLabels.size());
+        mLabels.emplace_back();
+    }
+
+    Label& label = mLabels[handle];
+    label.mText = text;
+    label.mX = x;
+    label.mY = y;
+    label.mColor = color;
+    label.mSlots = slots;
+    label.mAlive = true;
+    MarkDirty(handle);
+    return handle;
+}
+
+void RetainedText::Destroy(Handle handle)
+{
+    if (handle >= mLabels.size() || !mLabels[handle].mAlive)
+    {
+        return;
+    }
+
+    // Keep the dirty flag since the handle may still be in mDirtyLabels
+    Label& label = mLabels[handle];
+    FreeSlots(label.mSlots);
+    const bool dirty = label.mDirty;
+    label = Label();
+    label.mDirty = dirty;
+    mFreeHandles.push_back(handle);
+}
+
+void RetainedText::SetText(Handle handle, std::string_view text)
+{
+    if (handle >= mLabels.size() || !mLabels[handle].mAlive || mLabels[handle].mText == text)
+    {
+        return;
+    }
+
+    Label& label = mLabels[handle];
+    if (text.size() > label.mSlots.mCount)
+    {
+        SlotRange slots;
+        if (AllocateSlots(static_cast<uint32_t>(text.size()), slots))
+        {
+            FreeSlots(label.mSlots);
+            label.mSlots = slots;
+        }
+        else
+        {
+            text = text.substr(0, label.mSlots.mCount);
+        }
+    }
+
+    label.mText = text;
+    MarkDirty(handle);
+}
+
+void RetainedText::SetPosition(Handle handle, int32_t x, int32_t y)
+{
+    if (handle >= mLabels.size() || !mLabels[handle].mAlive || (mLabels[handle].mX == x && mLabels[handle].mY == y))
+    {
+        return;
+    }
+
+    mLabels[handle].mX = x;
+    mLabels[handle].mY = y;
+    MarkDirty(handle);
+}
+
+void RetainedText::SetColor(Handle handle, uint32_t color)
+{
+    if (handle >= mLabels.size() || !mLabels[handle].mAlive || mLabels[handle].mColor == color)
+    {
+        return;
+    }
+
+    mLabels[handle].mColor = color;
+    MarkDirty(handle);
+}
+
+uint32_t RetainedText::GetChangedSlotCount() const
+{
+    uint32_t count = 0;
+    for (Handle handle : mDirtyLabels)
+    {
+        count += mLabels[handle].mSlots.mCount;
+    }
+    for (const SlotRange& range : mFreedRanges)
+    {
+        count += range.mCount;
+    }
+
+    return count;
+}
+
+uint32_t RetainedText::FlushChanges(GlyphInstance* instances, std::vector<SlotRange>& changes)
+{
+    // Work out which ranges have to be written, in slot order so that neighbours can be merged into one upload
+    struct Change
+    {
+        SlotRange mSlots;
+        const Label* mLabel;
+    };
+
+    std::vector<Change> pending;
+    pending.reserve(mDirtyLabels.size() + mFreedRanges.size());
+    for (Handle handle : mDirtyLabels)
+    {
+        Label& label = mLabels[handle];
+        label.mDirty = false;
+        if (label.mAlive && label.mSlots.mCount > 0)
+        {
+            pending.push_back({ label.mSlots, &label });
+        }
+    }
+    for (const SlotRange& range : mFreedRanges)
+    {
+        pending.push_back({ range, nullptr });
+    }
+    mDirtyLabels.clear();
+    mFreedRanges.clear();
+
+    std::sort(pending.begin(), pending.end(), [](const Change& a, const Change& b) { return a.mSlots.mFirst < b.mSlots.mFirst; });
+
+    uint32_t written = 0;
+    for (const Change& change : pending)
+    {
+        GlyphInstance* slots = instances + written;
+        size_t glyphCount = 0;
+        if (change.mLabel != nullptr)
+        {
+            glyphCount = LayoutText(change.mLabel->mText, change.mLabel->mX, change.mLabel->mY, change.mLabel->mColor, slots, change.mSlots.mCount);
+        }
+        std::fill(slots + glyphCount, slots + change.mSlots.mCount, HiddenGlyph);
+        written += change.mSlots.mCount;
+
+        if (!changes.empty() && changes.back().mFirst + changes.back().mCount == change.mSlots.mFirst)
+        {
+            changes.back().mCount += change.mSlots.mCount;
+        }
+        else
+        {
+            changes.push_back(change.mSlots);
+        }
+    }
+
+    return written;
+}
+
+bool RetainedText::AllocateSlots(uint32_t length, SlotRange& slots)
+{
+    if (length == 0)
+    {
+        slots = {};
+        return true;
+    }
+
+    uint32_t sizeClass = 0;
+    while ((1u << sizeClass) < std::max(length, MinSlotsPerLabel))
+    {
+        ++sizeClass;
+    }
+    const uint32_t count = 1u << sizeClass;
+
+    std::vector<uint32_t>& freeSlots = mFreeSlots[sizeClass];
+    if (!freeSlots.empty())
+    {
+        slots = { freeSlots.back(), count };
+        freeSlots.pop_back();
+
+        // The range is about to be written by its new owner so there is no need to hide it
+        auto freed = std::find_if(mFreedRanges.begin(), mFreedRanges.end(), [&slots](const SlotRange& range) { return range.mFirst == slots.mFirst; });
+        if (freed != mFreedRanges.end())
+        {
+            mFreedRanges.erase(freed);
+        }
+        return true;
+    }
+
+    if (mMaxSlots - mSlotEnd < count)
+    {
+        return false;
+    }
+
+    slots = { mSlotEnd, count };
+    mSlotEnd += count;
+    return true;
+}
+
+void RetainedText::FreeSlots(const SlotRange& slots)
+{
+    if (slots.mCount == 0)
+    {
+        return;
+    }
+
+    uint32_t sizeClass = 0;
+    while ((1u << sizeClass) < slots.mCount)
+    {
+        ++sizeClass;
+    }
+
+    mFreeSlots[sizeClass].push_back(slots.mFirst);
+    mFreedRanges.push_back(slots);
+}
+
+void RetainedText::MarkDirty(Handle handle)
+{
+    if (!mLabels[handle].mDirty)
+    {
+        mLabels[handle].mDirty = true;
+        mDirtyLabels.push_back(handle);
+    }
+}
@@ -1,23 +1,262 @@
 #include <Util.h>
 
-#include <fstream>
+#include <ios>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 std::string slurp(std::string_view path)
 {
-    constexpr auto read_size = std::size_t(4096);
-    auto stream = std::ifstream(path.data());
-    stream.exceptions(std::ios_base::badbit);
-
-    if (!stream) {
+    MappedFile file;
+    if (!file.Open(path, MappedFile::AccessHint::Sequential))
+    {
         throw std::ios_base::failure("File does not exist");
     }
 
-    auto out = std::string();
-    auto buf = std::string(read_size, '\0');
-    while (stream.read(& buf[0], read_size)) {
-        out.append(buf, 0, stream.gcount());
+    return std::string(file.GetView());
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        mData = other.mData;
+        mSize = other.mSize;
+        mOpen = other.mOpen;
+        mMapped = other.mMapped;
+        mBuffer = std::move(other.mBuffer);
+
+        other.mData = nullptr;
+        other.mSize = 0;
+        other.mOpen = false;
+        other.mMapped = false;
+    }
+
+    return *this;
+}
+
+bool MappedFile::Open(std::string_view path, AccessHint hint)
+{
+    Close();
+    mOpen = Map(path, hint) || Read(path);
+    return mOpen;
+}
+
+#if defined(_WIN32)
+
+void MappedFile::Close()
+{
+    if (mMapped)
+    {
+        UnmapViewOfFile(mData);
     }
 
-    out.append(buf, 0, stream.gcount());
-    return out;
+    mBuffer.reset();
+    mData = nullptr;
+    mSize = 0;
+    mOpen = false;
+    mMapped = false;
 }
+
+bool MappedFile::Map(std::string_view path, AccessHint hint)
+{
+    const DWORD flags = hint == AccessHint::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL;
+    HANDLE file = CreateFileA(std::string(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        // Empty files can't be mapped. Let Read deal with them.
+        CloseHandle(file);
+        return false;
+    }
+
+    // The view keeps the mapping and the file alive so the handles can be closed right away
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+    {
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == nullptr)
+    {
+        return false;
+    }
+
+    mData = static_cast<const uint8_t*>(view);
+    mSize = static_cast<size_t>(size.QuadPart);
+    mMapped = true;
+
+    if (hint == AccessHint::WillNeed)
+    {
+        WIN32_MEMORY_RANGE_ENTRY range = { view, mSize };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+
+    return true;
+}
+
+bool MappedFile::Read(std::string_view path)
+{
+    HANDLE file = CreateFileA(std::string(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    mSize = static_cast<size_t>(size.QuadPart);
+    mBuffer.reset(new uint8_t[mSize > 0 ? mSize : 1]);
+
+    size_t offset = 0;
+    while (offset < mSize)
+    {
+        const DWORD chunk = static_cast<DWORD>(mSize - offset < 0x40000000 ? mSize - offset : 0x40000000);
+        DWORD read = 0;
+        if (!ReadFile(file, mBuffer.get() + offset, chunk, &read, nullptr) || read == 0)
+        {
+            break;
+        }
+        offset += read;
+    }
+
+    CloseHandle(file);
+
+    if (offset != mSize)
+    {
+        mBuffer.reset();
+        mSize = 0;
+        return false;
+    }
+
+    mData = mBuffer.get();
+    return true;
+}
+
+#else
+
+void MappedFile::Close()
+{
+    if (mMapped)
+    {
+        munmap(const_cast<uint8_t*>(mData), mSize);
+    }
+
+    mBuffer.reset();
+    mData = nullptr;
+    mSize = 0;
+    mOpen = false;
+    mMapped = false;
+}
+
+bool MappedFile::Map(std::string_view path, AccessHint hint)
+{
+    int fd = open(std::string(path).c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED)
+    {
+        return false;
+    }
+
+    mData = static_cast<const uint8_t*>(view);
+    mSize = static_cast<size_t>(info.st_size);
+    mMapped = true;
+
+    if (hint == AccessHint::Sequential)
+    {
+        madvise(view, mSize, MADV_SEQUENTIAL);
+    }
+    else if (hint == AccessHint::WillNeed)
+    {
+        madvise(view, mSize, MADV_WILLNEED);
+    }
+
+    return true;
+}
+
+bool MappedFile::Read(std::string_view path)
+{
+    int fd = open(std::string(path).c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    mSize = static_cast<size_t>(info.st_size);
+    mBuffer.reset(new uint8_t[mSize > 0 ? mSize : 1]);
+
+    size_t offset = 0;
+    while (offset < mSize)
+    {
+        const ssize_t result = read(fd, mBuffer.get() + offset, mSize - offset);
+        if (result <= 0)
+        {
+            break;
+        }
+        offset += static_cast<size_t>(result);
+    }
+
+    close(fd);
+
+    if (offset != mSize)
+    {
+        mBuffer.reset();
+        mSize = 0;
+        return false;
+    }
+
+    mData = mBuffer.get();
+    return true;
+}
+
+#endif
@@ -0,0 +1,383 @@
+// Tests of the job system: the work-stealing queue on its own, jobs that don't fit in it, reusing counters, waiting on one
+// from a task while its last job finishes, ParallelFor, and tasks waiting for assets when the streamer stops. Prints every
+// test that ran and returns non-zero if any failed.
+//
+// Most of what these test are races, which a passing run doesn't prove absent. MSVC has no thread sanitizer, so run them
+// under clang's or gcc's as well after changing the job system, e.g. from the repository root:
+//
+//     g++ -std=c++20 -O1 -g -fsanitize=thread -Wno-tsan -Iinclude tests/JobTests/JobTests.cpp src/JobSystem.cpp src/Task.cpp
+//         src/Assets.cpp src/AssetStreamer.cpp src/Log.cpp src/LogFormat.cpp src/LogSinks.cpp src/Util.cpp -o JobTests
+//
+// gcc warns that the sanitizer doesn't understand atomic_thread_fence, which the queue uses; -Wno-tsan silences it.
+//
+// Usage: JobTests
+
+#include <JobSystem.h>
+#include <Log.h>
+#include <Task.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CHECK(condition) Check(condition, #condition, __FILE__, __LINE__)
+
+// Friend of JobSystem, for the parts that aren't public
+class JobSystemTests
+{
+public:
+    using Job = JobSystem::Job;
+    using WorkQueue = JobSystem::WorkQueue;
+};
+
+namespace
+{
+    using Job = JobSystemTests::Job;
+    using WorkQueue = JobSystemTests::WorkQueue;
+
+    // Only checked on the main thread, jobs count their failures in atomics instead
+    uint32_t gFailures = 0;
+
+    void Check(bool condition, const char* text, const char* file, int line)
+    {
+        if (!condition)
+        {
+            fprintf(stderr, "%s(%d): CHECK(%s) failed\n", file, line, text);
+            ++gFailures;
+        }
+    }
+
+    struct Test
+    {
+        const char* mName;
+        void (*mRun)();
+    };
+
+    constexpr uint32_t WorkerCount = 3;
+
+    // Like JobSystem::Wait, but gives up instead of hanging when a bug loses work. The workers run the jobs.
+    bool WaitWithTimeout(const JobCounter& counter)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (!counter.IsDone())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    // ------------------------------------------------------------------------------------------------
+
+    void WorkQueueOrder()
+    {
+        auto queue = std::make_unique<WorkQueue>();
+        std::vector<Job> jobs(WorkQueue::Capacity + 1);
+
+        for (int64_t i = 0; i < WorkQueue::Capacity; ++i)
+        {
+            CHECK(queue->Push(&jobs[i]));
+        }
+        CHECK(!queue->Push(&jobs[WorkQueue::Capacity]));
+
+        // The owner takes the newest job, thieves the oldest
+        CHECK(queue->Pop() == &jobs[WorkQueue::Capacity - 1]);
+        CHECK(queue->Steal() == &jobs[0]);
+        CHECK(queue->Push(&jobs[WorkQueue::Capacity]));
+
+        uint32_t taken = 0;
+        while (Job* job = queue->Steal())
+        {
+            ++taken;
+            if (job == &jobs[WorkQueue::Capacity])
+            {
+                CHECK(taken == WorkQueue::Capacity - 1);
+            }
+        }
+        CHECK(taken == WorkQueue::Capacity - 1);
+        CHECK(queue->Pop() == nullptr);
+        CHECK(queue->Steal() == nullptr);
+    }
+
+    // The owner pushes one or two jobs and pops until the queue is empty while a thief steals all the time, so the two of
+    // them keep racing for the last job. Every job has to be taken exactly once.
+    void WorkQueueStealRace()
+    {
+        constexpr uint32_t RoundCount = 200000;
+
+        auto queue = std::make_unique<WorkQueue>();
+        std::vector<Job> jobs(RoundCount * 2);
+        std::vector<std::atomic<uint32_t>> taken(jobs.size());
+        std::atomic<uint32_t> stolen{ 0 };
+        std::atomic<bool> stop{ false };
+
+        std::thread thief([&]
+        {
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                if (Job* job = queue->Steal())
+                {
+                    taken[job - jobs.data()].fetch_add(1, std::memory_order_relaxed);
+                    stolen.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+
+        size_t pushed = 0;
+        for (uint32_t round = 0; round < RoundCount; ++round)
+        {
+            for (uint32_t i = 0; i <= round % 2; ++i)
+            {
+                CHECK(queue->Push(&jobs[pushed++]));
+            }
+
+            // Lets the thief in on a single core, where the two would otherwise never overlap
+            if (round % 64 == 0)
+            {
+                std::this_thread::yield();
+            }
+
+            while (Job* job = queue->Pop())
+            {
+                taken[job - jobs.data()].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        stop = true;
+        thief.join();
+
+        uint32_t wrong = 0;
+        for (size_t i = 0; i < pushed; ++i)
+        {
+            wrong += taken[i].load() != 1 ? 1 : 0;
+        }
+        CHECK(wrong == 0);
+        CHECK(queue->Pop() == nullptr);
+        CHECK(queue->Steal() == nullptr);
+
+        // Without any steals nothing was tested
+        CHECK(stolen > 0);
+    }
+
+    // Without workers nothing takes jobs out of the calling thread's queue, so the ones that don't fit run in Run
+    void QueueOverflowRunsInline()
+    {
+        constexpr uint32_t ExtraCount = 100;
+
+        JobSystem::Get().Start(0);
+
+        std::atomic<uint32_t> ran{ 0 };
+        JobCounter counter;
+        for (uint32_t i = 0; i < WorkQueue::Capacity + ExtraCount; ++i)
+        {
+            JobSystem::Get().Run([&ran] { ran.fetch_add(1, std::memory_order_relaxed); }, &counter);
+        }
+        CHECK(ran == ExtraCount);
+        CHECK(!counter.IsDone());
+
+        JobSystem::Get().Wait(counter);
+        CHECK(ran == WorkQueue::Capacity + ExtraCount);
+
+        JobSystem::Get().Stop();
+    }
+
+    void CounterReuse()
+    {
+        constexpr uint32_t RoundCount = 2000;
+        constexpr uint32_t JobCount = 16;
+
+        JobSystem::Get().Start(WorkerCount);
+
+        JobCounter counter;
+        std::atomic<uint32_t> ran{ 0 };
+        for (uint32_t round = 0; round < RoundCount; ++round)
+        {
+            for (uint32_t i = 0; i < JobCount; ++i)
+            {
+                JobSystem::Get().Run([&ran] { ran.fetch_add(1, std::memory_order_relaxed); }, &counter);
+            }
+            JobSystem::Get().Wait(counter);
+
+            CHECK(counter.IsDone());
+            CHECK(ran == (round + 1) * JobCount);
+        }
+
+        JobSystem::Get().Stop();
+    }
+
+    Task WaitOnCounter(JobCounter& counter, std::atomic<uint32_t>& resumed, std::atomic<uint32_t>& early)
+    {
+        co_await counter;
+        early.fetch_add(counter.IsDone() ? 0 : 1, std::memory_order_relaxed);
+        resumed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // A task co_awaits a counter while a job on another worker finishes its last piece of work. Whether AddWaiter or the
+    // last FinishWork goes first, the task has to be resumed exactly once and only once the counter is done. The same
+    // counter is used for every round.
+    void WaiterRacesFinishWork()
+    {
+        constexpr uint32_t RoundCount = 20000;
+
+        JobSystem::Get().Start(WorkerCount);
+
+        JobCounter counter;
+        std::atomic<uint32_t> resumed{ 0 };
+        std::atomic<uint32_t> early{ 0 };
+        uint32_t round = 0;
+        for (; round < RoundCount; ++round)
+        {
+            JobCounter done;
+            JobSystem::Get().AddWork(counter);
+            RunTask(WaitOnCounter(counter, resumed, early), &done);
+            JobSystem::Get().Run([&counter] { JobSystem::Get().FinishWork(counter); });
+
+            if (!WaitWithTimeout(done))
+            {
+                fprintf(stderr, "WaiterRacesFinishWork: the task was never resumed in round %u\n", round);
+                break;
+            }
+        }
+        CHECK(round == RoundCount);
+        CHECK(resumed == round);
+        CHECK(early == 0);
+        CHECK(counter.IsDone());
+
+        // A lost task would be resumed by the leftover jobs here, so its round has to finish before its locals go away
+        JobSystem::Get().Stop();
+    }
+
+    void ParallelForCoverage()
+    {
+        struct Case
+        {
+            uint32_t mCount;
+            uint32_t mGrainSize;     // 0 lets ParallelFor pick
+        };
+
+        // A grain size that doesn't divide the count leaves a short range at the end. The last case starts more jobs
+        // than fit in a queue.
+        const Case cases[] =
+        {
+            { 0, 16 }, { 1, 1 }, { 7, 3 }, { 1000, 64 }, { 1000, 1000 }, { 1000, 1001 }, { 12345, 0 }, { 100003, 1 },
+        };
+
+        JobSystem::Get().Start(WorkerCount);
+
+        for (const Case& test : cases)
+        {
+            std::vector<std::atomic<uint32_t>> visits(test.mCount);
+            std::atomic<uint32_t> badRanges{ 0 };
+            auto body = [&](uint32_t begin, uint32_t end)
+            {
+                if (begin >= end || end > test.mCount || (test.mGrainSize != 0 && end - begin > test.mGrainSize))
+                {
+                    badRanges.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    visits[i].fetch_add(1, std::memory_order_relaxed);
+                }
+            };
+
+            if (test.mGrainSize == 0)
+            {
+                JobSystem::Get().ParallelFor(test.mCount, body);
+            }
+            else
+            {
+                JobSystem::Get().ParallelFor(test.mCount, test.mGrainSize, body);
+            }
+
+            uint32_t wrong = 0;
+            for (const std::atomic<uint32_t>& count : visits)
+            {
+                wrong += count.load() != 1 ? 1 : 0;
+            }
+            CHECK(wrong == 0);
+            CHECK(badRanges == 0);
+        }
+
+        JobSystem::Get().Stop();
+    }
+
+    Task LoadMissingAsset(uint32_t index, std::atomic<uint32_t>& resumed, std::atomic<uint32_t>& loaded)
+    {
+        const bool result = co_await LoadAsset("JobTests/missing" + std::to_string(index) + ".bin", AssetPriority::Normal);
+        loaded.fetch_add(result ? 1 : 0, std::memory_order_relaxed);
+        resumed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Stopping the streamer with requests in flight has to resume the tasks waiting for them, or they would leak along
+    // with their counter
+    void StopResumesLoadAsset()
+    {
+        constexpr uint32_t TaskCount = 1000;
+
+        JobSystem::Get().Start(WorkerCount);
+        AssetStreamer::Get().Start(1, 1);
+
+        JobCounter counter;
+        std::atomic<uint32_t> resumed{ 0 };
+        std::atomic<uint32_t> loaded{ 0 };
+        for (uint32_t i = 0; i < TaskCount; ++i)
+        {
+            RunTask(LoadMissingAsset(i, resumed, loaded), &counter);
+        }
+
+        // Every task has to have made its request, nothing dispatches completions before Stop
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (AssetStreamer::Get().GetPendingCount() < TaskCount && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::yield();
+        }
+        CHECK(AssetStreamer::Get().GetPendingCount() == TaskCount);
+        CHECK(resumed == 0);
+
+        AssetStreamer::Get().Stop();
+        CHECK(AssetStreamer::Get().GetPendingCount() == 0);
+        CHECK(WaitWithTimeout(counter));
+        CHECK(resumed == TaskCount);
+        CHECK(loaded == 0);
+
+        JobSystem::Get().Stop();
+    }
+
+    const Test gTests[] =
+    {
+        { "WorkQueue order", WorkQueueOrder },
+        { "WorkQueue steal race", WorkQueueStealRace },
+        { "Queue overflow runs inline", QueueOverflowRunsInline },
+        { "JobCounter reuse", CounterReuse },
+        { "JobCounter waiter races FinishWork", WaiterRacesFinishWork },
+        { "ParallelFor coverage", ParallelForCoverage },
+        { "AssetStreamer Stop resumes LoadAsset", StopResumesLoadAsset },
+    };
+}
+
+int main()
+{
+    // The logger isn't started, this only keeps the message of every Start out of the thread's ring
+    Logger::SetLevel(LogCategory::Jobs, LogLevel::Warn);
+
+    uint32_t failedTests = 0;
+    for (const Test& test : gTests)
+    {
+        const uint32_t failures = gFailures;
+        test.mRun();
+        const bool passed = gFailures == failures;
+        printf("%-40s %s\n", test.mName, passed ? "ok" : "FAILED");
+        failedTests += passed ? 0 : 1;
+    }
+
+    printf("\n%u of %zu tests failed\n", failedTests, sizeof(gTests) / sizeof(gTests[0]));
+    return failedTests == 0 ? 0 : 1;
+}
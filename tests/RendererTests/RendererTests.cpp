@@ -0,0 +1,1189 @@
+// Tests of the parts of the renderer that don't need a GPU. Prints every test that ran and returns non-zero if any failed.
+//
+// Usage: RendererTests
+
+#include <DescriptorAllocator.h>
+#include <Font.h>
+#include <FrameRingAllocator.h>
+#include <SkylinePacker.h>
+#include <SoftwareRasterizer.h>
+#include <SpriteBatch.h>
+#include <TextLayout.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#define CHECK(condition) Check(condition, #condition, __FILE__, __LINE__)
+
+namespace
+{
+    uint32_t gFailures = 0;
+
+    void Check(bool condition, const char* text, const char* file, int line)
+    {
+        if (!condition)
+        {
+            fprintf(stderr, "%s(%d): CHECK(%s) failed\n", file, line, text);
+            ++gFailures;
+        }
+    }
+
+    struct Test
+    {
+        const char* mName;
+        void (*mRun)();
+    };
+
+    // ------------------------------------------------------------------------------------------------
+
+    bool Overlaps(const AtlasRect& a, uint32_t paddingA, const AtlasRect& b, uint32_t paddingB)
+    {
+        return a.mX < b.mX + b.mWidth + paddingB && b.mX < a.mX + a.mWidth + paddingA &&
+               a.mY < b.mY + b.mHeight + paddingB && b.mY < a.mY + a.mHeight + paddingA;
+    }
+
+    // Every rectangle is inside the page and no rectangle overlaps another one or the padding to its right and below
+    void CheckPacking(const SkylinePacker& packer, const std::vector<AtlasRect>& rects, uint32_t padding)
+    {
+        for (size_t i = 0; i < rects.size(); ++i)
+        {
+            CHECK(rects[i].mX + rects[i].mWidth <= packer.GetWidth());
+            CHECK(rects[i].mY + rects[i].mHeight <= packer.GetHeight());
+            for (size_t j = i + 1; j < rects.size(); ++j)
+            {
+                CHECK(!Overlaps(rects[i], padding, rects[j], 0));
+                CHECK(!Overlaps(rects[i], 0, rects[j], padding));
+            }
+        }
+    }
+
+    void SkylinePackerRandomRects()
+    {
+        for (uint32_t padding : { 0u, 1u, 4u })
+        {
+            std::mt19937 random(padding);
+            std::uniform_int_distribution<uint32_t> size(1, 48);
+
+            SkylinePacker packer;
+            packer.Initialize(512, 512, padding);
+            std::vector<AtlasRect> rects;
+            uint32_t failures = 0;
+            while (failures < 32)
+            {
+                AtlasRect rect;
+                const uint32_t width = size(random);
+                const uint32_t height = size(random);
+                if (packer.Allocate(width, height, rect))
+                {
+                    CHECK(rect.mWidth == width && rect.mHeight == height);
+                    rects.push_back(rect);
+                }
+                else
+                {
+                    ++failures;
+                }
+            }
+
+            CheckPacking(packer, rects, padding);
+            CHECK(packer.GetOccupancy() > 0.7f && packer.GetOccupancy() <= 1.0f);
+        }
+    }
+
+    void SkylinePackerPadding()
+    {
+        SkylinePacker packer;
+        packer.Initialize(64, 64, 2);
+
+        // Side by side along the bottom with the padding in between
+        AtlasRect first;
+        AtlasRect second;
+        CHECK(packer.Allocate(10, 10, first));
+        CHECK(packer.Allocate(10, 10, second));
+        CHECK(first.mX == 0 && first.mY == 0);
+        CHECK(second.mX == 12 && second.mY == 0);
+
+        // A rectangle as wide as the page goes above them, past the padding below them. Padding may hang off the edge.
+        AtlasRect wide;
+        CHECK(packer.Allocate(64, 10, wide));
+        CHECK(wide.mX == 0 && wide.mY == 12);
+    }
+
+    void SkylinePackerFull()
+    {
+        SkylinePacker packer;
+        packer.Initialize(32, 32, 0);
+
+        AtlasRect rect;
+        CHECK(!packer.Allocate(33, 1, rect));
+        CHECK(!packer.Allocate(1, 33, rect));
+        CHECK(!packer.Allocate(0, 1, rect));
+
+        std::vector<AtlasRect> rects;
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            CHECK(packer.Allocate(16, 16, rect));
+            rects.push_back(rect);
+        }
+        CheckPacking(packer, rects, 0);
+        CHECK(packer.GetOccupancy() == 1.0f);
+        CHECK(!packer.Allocate(1, 1, rect));
+
+        // A page with a gap left takes what fits in it and nothing bigger
+        packer.Reset();
+        CHECK(packer.Allocate(32, 24, rect));
+        CHECK(!packer.Allocate(8, 9, rect));
+        CHECK(packer.Allocate(32, 8, rect));
+        CHECK(rect.mY == 24);
+        CHECK(!packer.Allocate(1, 1, rect));
+
+        // Reset makes the whole page available again
+        packer.Reset();
+        CHECK(packer.GetOccupancy() == 0.0f);
+        CHECK(packer.Allocate(32, 32, rect));
+    }
+
+    // ------------------------------------------------------------------------------------------------
+
+    // A full heap of four ranges of 10, 0 to 40
+    void AllocateFourRanges(DescriptorAllocator& allocator, uint32_t (&ranges)[4])
+    {
+        allocator.Initialize(40, 0);
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            ranges[i] = allocator.AllocatePersistent(10);
+            CHECK(ranges[i] == i * 10);
+        }
+        CHECK(allocator.GetFreePersistentCount() == 0);
+    }
+
+    void FreeNow(DescriptorAllocator& allocator, uint32_t index, uint64_t& fenceValue)
+    {
+        allocator.FreePersistent(index, 10);
+        allocator.EndFrame(++fenceValue);
+        allocator.Retire(fenceValue);
+    }
+
+    void DescriptorAllocatorMerge()
+    {
+        DescriptorAllocator allocator;
+        uint32_t ranges[4];
+        uint64_t fenceValue = 0;
+
+        // Apart, nothing to merge
+        AllocateFourRanges(allocator, ranges);
+        FreeNow(allocator, ranges[0], fenceValue);
+        FreeNow(allocator, ranges[2], fenceValue);
+        CHECK(allocator.GetFreePersistentCount() == 20);
+        CHECK(allocator.GetLargestFreePersistentRange() == 10);
+        CHECK(allocator.AllocatePersistent(11) == DescriptorAllocator::InvalidIndex);
+
+        // With the free range before it
+        AllocateFourRanges(allocator, ranges);
+        FreeNow(allocator, ranges[0], fenceValue);
+        FreeNow(allocator, ranges[1], fenceValue);
+        CHECK(allocator.GetLargestFreePersistentRange() == 20);
+        CHECK(allocator.AllocatePersistent(20) == 0);
+
+        // With the free range after it
+        AllocateFourRanges(allocator, ranges);
+        FreeNow(allocator, ranges[3], fenceValue);
+        FreeNow(allocator, ranges[2], fenceValue);
+        CHECK(allocator.GetLargestFreePersistentRange() == 20);
+        CHECK(allocator.AllocatePersistent(20) == 20);
+
+        // With both, then the last range merges with everything before it
+        AllocateFourRanges(allocator, ranges);
+        FreeNow(allocator, ranges[0], fenceValue);
+        FreeNow(allocator, ranges[2], fenceValue);
+        FreeNow(allocator, ranges[1], fenceValue);
+        CHECK(allocator.GetLargestFreePersistentRange() == 30);
+        FreeNow(allocator, ranges[3], fenceValue);
+        CHECK(allocator.GetLargestFreePersistentRange() == 40);
+        CHECK(allocator.AllocatePersistent(40) == 0);
+
+        // Several frees retired by the same fence merge the same way
+        AllocateFourRanges(allocator, ranges);
+        for (uint32_t i : { 3u, 0u, 2u, 1u })
+        {
+            allocator.FreePersistent(ranges[i], 10);
+        }
+        allocator.EndFrame(++fenceValue);
+        allocator.Retire(fenceValue);
+        CHECK(allocator.GetLargestFreePersistentRange() == 40);
+    }
+
+    void DescriptorAllocatorDeferredFree()
+    {
+        DescriptorAllocator allocator;
+        allocator.Initialize(10, 0);
+        const uint32_t index = allocator.AllocatePersistent(10);
+        CHECK(index == 0);
+
+        // Freed during the frame, the GPU may still use it until the frame's fence has passed
+        allocator.FreePersistent(index, 10);
+        allocator.Retire(100);
+        CHECK(allocator.AllocatePersistent(1) == DescriptorAllocator::InvalidIndex);
+
+        allocator.EndFrame(5);
+        allocator.Retire(4);
+        CHECK(allocator.GetFreePersistentCount() == 0);
+        CHECK(allocator.AllocatePersistent(1) == DescriptorAllocator::InvalidIndex);
+
+        allocator.Retire(5);
+        CHECK(allocator.GetFreePersistentCount() == 10);
+        CHECK(allocator.AllocatePersistent(10) == 0);
+
+        // Frees of different frames come back one fence at a time
+        allocator.FreePersistent(0, 4);
+        allocator.EndFrame(6);
+        allocator.FreePersistent(4, 6);
+        allocator.EndFrame(7);
+        allocator.Retire(6);
+        CHECK(allocator.GetFreePersistentCount() == 4);
+        allocator.Retire(7);
+        CHECK(allocator.GetLargestFreePersistentRange() == 10);
+    }
+
+    void DescriptorAllocatorTransientWrap()
+    {
+        // Transient indices come after the persistent ones
+        DescriptorAllocator allocator;
+        allocator.Initialize(16, 10);
+        CHECK(allocator.GetDescriptorCount() == 26);
+
+        CHECK(allocator.AllocateTransient(6) == 16);
+        allocator.EndFrame(1);
+
+        // 6 more don't fit behind the first frame, and wrapping would run into it while it is in flight
+        CHECK(allocator.AllocateTransient(6) == DescriptorAllocator::InvalidIndex);
+        allocator.Retire(1);
+        CHECK(allocator.AllocateTransient(6) == 16);
+
+        // The 4 skipped at the end stay allocated until the frame that wrapped is retired
+        CHECK(allocator.AllocateTransient(1) == DescriptorAllocator::InvalidIndex);
+        allocator.EndFrame(2);
+        allocator.Retire(2);
+        CHECK(allocator.AllocateTransient(4) == 22);
+        CHECK(allocator.AllocateTransient(11) == DescriptorAllocator::InvalidIndex);
+
+        // Persistent descriptors never come out of the transient region
+        CHECK(allocator.AllocatePersistent(16) == 0);
+        CHECK(allocator.AllocatePersistent(1) == DescriptorAllocator::InvalidIndex);
+    }
+
+    void FrameRingAllocatorFrames()
+    {
+        FrameRingAllocator ring;
+        ring.Initialize(256);
+        CHECK(ring.Allocate(100, 16) == 0);
+        CHECK(ring.Allocate(10, 64) == 128);
+        ring.EndFrame(1);
+        CHECK(ring.Allocate(100, 16) == 144);
+        ring.EndFrame(2);
+
+        // Aligned to 256 it would end past the buffer, so it wraps and the 12 bytes left at the end are skipped
+        CHECK(ring.Allocate(50, 16) == FrameRingAllocator::InvalidOffset);
+        ring.Retire(1);
+        CHECK(ring.Allocate(50, 16) == 0);
+        CHECK(ring.GetUsed() == 106 + 12 + 50);
+        CHECK(ring.GetHighWaterMark() == 244);
+
+        // A frame without allocations only moves the fence of the one before it, so fence 3 only retires frame 2
+        ring.EndFrame(3);
+        ring.EndFrame(4);
+        ring.Retire(3);
+        CHECK(ring.GetUsed() == 12 + 50);
+        ring.Retire(4);
+        CHECK(ring.GetUsed() == 0);
+
+        // More frames than it can track are merged, so the older ones are released late but never early
+        for (uint64_t frame = 0; frame < FrameRingAllocator::MaxFramesInFlight + 2; ++frame)
+        {
+            CHECK(ring.Allocate(8, 1) != FrameRingAllocator::InvalidOffset);
+            ring.EndFrame(10 + frame);
+        }
+        ring.Retire(10);
+        CHECK(ring.GetUsed() == 8 * (FrameRingAllocator::MaxFramesInFlight + 1));
+        ring.Retire(10 + FrameRingAllocator::MaxFramesInFlight + 1);
+        CHECK(ring.GetUsed() == 0);
+    }
+
+    // ------------------------------------------------------------------------------------------------
+
+    // One character at a time, the way LayoutText worked before it did 16 at once
+    size_t LayoutTextReference(std::string_view text, int32_t x, int32_t y, uint32_t color, GlyphInstance* instances, size_t capacity)
+    {
+        const auto clampToInt16 = [](int32_t value) { return static_cast<int16_t>(std::clamp<int32_t>(value, INT16_MIN, INT16_MAX)); };
+        const size_t count = std::min(text.size(), capacity);
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint8_t glyph = static_cast<uint8_t>(text[i]);
+            if (static_cast<uint32_t>(glyph) - Font::FirstChar >= Font::NumChars)
+            {
+                glyph = '?';
+            }
+
+            instances[i].mX = clampToInt16(x + static_cast<int32_t>(i * Font::CharWidth));
+            instances[i].mY = clampToInt16(y);
+            instances[i].mGlyphAndColor = PackGlyph(static_cast<uint8_t>(glyph - Font::FirstChar), color);
+        }
+        return count;
+    }
+
+    bool SameInstances(const GlyphInstance* a, const GlyphInstance* b, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (a[i].mX != b[i].mX || a[i].mY != b[i].mY || a[i].mGlyphAndColor != b[i].mGlyphAndColor)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void GlyphInstancePacking()
+    {
+        // Glyph in the low byte, then red, green and blue
+        CHECK(PackGlyph(0x41, 0x123456) == 0x56341241u);
+        CHECK(PackGlyph(0xFF, 0xFFFFFF) == 0xFFFFFFFFu);
+        CHECK(PackGlyph(0, 0) == 0);
+
+        // Every glyph and channel comes back out of the expansion unchanged
+        for (uint32_t glyph = 0; glyph < Font::NumChars; ++glyph)
+        {
+            const uint32_t color = (glyph * 0x010203u + 0x805A11u) & 0xFFFFFF;
+            const GlyphInstance instance = { 0, 0, PackGlyph(static_cast<uint8_t>(glyph), color) };
+            GlyphVertex vertices[4];
+            ExpandGlyphInstance(instance, 256.0f, 256.0f, vertices);
+
+            float u1, v1, u2, v2;
+            Font::GetCharacterUVs(static_cast<char>(glyph + Font::FirstChar), u1, v1, u2, v2);
+            CHECK(vertices[0].mColor == color && vertices[3].mColor == color);
+            CHECK(vertices[0].mU == u1 && vertices[0].mV == v1 && vertices[3].mU == u2 && vertices[3].mV == v2);
+        }
+
+        // Positions are signed, a glyph partly off the top left of the screen stays there
+        const GlyphInstance offScreen = { -5, -12, PackGlyph('A', TextColorWhite) };
+        GlyphVertex vertices[4];
+        ExpandGlyphInstance(offScreen, 200.0f, 100.0f, vertices);
+        CHECK(vertices[0].mX == -5.0f / 200.0f * 2.0f - 1.0f);
+        CHECK(vertices[0].mY == 1.0f - -12.0f / 100.0f * 2.0f);
+        CHECK(vertices[3].mX == 3.0f / 200.0f * 2.0f - 1.0f);
+        CHECK(vertices[3].mY == 1.0f - 4.0f / 100.0f * 2.0f);
+
+        // Hidden slots are far enough off screen that no corner of them is visible
+        ExpandGlyphInstance(HiddenGlyph, 4096.0f, 4096.0f, vertices);
+        for (const GlyphVertex& vertex : vertices)
+        {
+            CHECK(vertex.mX < -1.0f && vertex.mY > 1.0f);
+        }
+    }
+
+    void GlyphInstanceExpansion()
+    {
+        // 'A' is glyph 65, in column 1 and row 2 of the 32 glyph wide atlas
+        const GlyphInstance instance = { 16, 32, PackGlyph('A' - Font::FirstChar, 0xFF8000) };
+        GlyphVertex vertices[4];
+        ExpandGlyphInstance(instance, 64.0f, 128.0f, vertices);
+
+        // Triangle strip order: top left, top right, bottom left, bottom right
+        const float left = 16.0f / 64.0f * 2.0f - 1.0f;
+        const float right = 24.0f / 64.0f * 2.0f - 1.0f;
+        const float top = 1.0f - 32.0f / 128.0f * 2.0f;
+        const float bottom = 1.0f - 48.0f / 128.0f * 2.0f;
+        const float expectedX[4] = { left, right, left, right };
+        const float expectedY[4] = { top, top, bottom, bottom };
+        const float u1 = 8.0f / Font::TextureWidth;
+        const float u2 = 16.0f / Font::TextureWidth;
+        const float v1 = 32.0f / Font::TextureHeight;
+        const float v2 = 48.0f / Font::TextureHeight;
+        const float expectedU[4] = { u1, u2, u1, u2 };
+        const float expectedV[4] = { v1, v1, v2, v2 };
+        for (uint32_t corner = 0; corner < 4; ++corner)
+        {
+            CHECK(vertices[corner].mX == expectedX[corner]);
+            CHECK(vertices[corner].mY == expectedY[corner]);
+            CHECK(vertices[corner].mU == expectedU[corner]);
+            CHECK(vertices[corner].mV == expectedV[corner]);
+            CHECK(vertices[corner].mColor == 0xFF8000);
+        }
+    }
+
+    void LayoutTextMatchesReference()
+    {
+        // Mostly printable with some bytes outside of the font, which become '?'
+        std::mt19937 random(11);
+        std::uniform_int_distribution<int> byte(0, 255);
+        std::string text(1000, ' ');
+        for (char& c : text)
+        {
+            const int value = byte(random);
+            c = static_cast<char>(value % 5 == 0 ? value : ' ' + value % 95);
+        }
+
+        std::vector<GlyphInstance> expected(text.size() + 1);
+        std::vector<GlyphInstance> instances(text.size() + 1);
+
+        // Every length around the 16 character blocks, and positions that saturate in either direction
+        const int32_t positions[][2] = { { 0, 0 }, { -100, 7 }, { INT16_MAX - 40, -3 }, { INT16_MIN - 20, 100000 } };
+        std::vector<size_t> lengths;
+        for (size_t length = 0; length <= 50; ++length)
+        {
+            lengths.push_back(length);
+        }
+        lengths.insert(lengths.end(), { 255, 256, 257, 999, 1000 });
+
+        uint32_t mismatches = 0;
+        for (const auto& position : positions)
+        {
+            for (size_t length : lengths)
+            {
+                const std::string_view view(text.data(), length);
+                const GlyphInstance guard = { 1, 2, 3 };
+                expected.assign(expected.size(), guard);
+                instances.assign(instances.size(), guard);
+
+                const size_t expectedCount = LayoutTextReference(view, position[0], position[1], 0x336699, expected.data(), text.size());
+                const size_t count = LayoutText(view, position[0], position[1], 0x336699, instances.data(), text.size());
+                mismatches += count == expectedCount && count == length && SameInstances(expected.data(), instances.data(), instances.size()) ? 0 : 1;
+            }
+        }
+        CHECK(mismatches == 0);
+
+        // Stops at the capacity, in and out of a block
+        const size_t capacities[] = { 0, 5, 16, 17, 40 };
+        for (size_t capacity : capacities)
+        {
+            const GlyphInstance guard = { 1, 2, 3 };
+            instances.assign(instances.size(), guard);
+            CHECK(LayoutText(text, 10, 10, TextColorWhite, instances.data(), capacity) == capacity);
+            CHECK(SameInstances(&instances[capacity], &guard, 1));
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------------
+
+    std::vector<RetainedText::SlotRange> Flush(RetainedText& text, std::vector<GlyphInstance>& instances)
+    {
+        std::vector<RetainedText::SlotRange> changes;
+        instances.assign(text.GetChangedSlotCount(), GlyphInstance{ 1, 2, 3 });
+        const uint32_t written = text.FlushChanges(instances.data(), changes);
+        CHECK(written <= instances.size());
+        instances.resize(written);
+        CHECK(!text.HasChanges());
+        return changes;
+    }
+
+    bool IsRange(const RetainedText::SlotRange& range, uint32_t first, uint32_t count)
+    {
+        return range.mFirst == first && range.mCount == count;
+    }
+
+    void RetainedTextChanges()
+    {
+        RetainedText text;
+        text.Initialize(1024);
+        std::vector<GlyphInstance> instances;
+
+        // New labels get power of two slot ranges of at least 8, and neighbouring ranges go up as one
+        const RetainedText::Handle score = text.Create("Score 0", 0, 0, TextColorWhite);
+        const RetainedText::Handle best = text.Create("Best score 1000", 0, 16, TextColorWhite);
+        const RetainedText::Handle lives = text.Create("Lives 3", 0, 32, TextColorWhite);
+        CHECK(text.HasChanges());
+        std::vector<RetainedText::SlotRange> changes = Flush(text, instances);
+        CHECK(changes.size() == 1 && IsRange(changes[0], 0, 32));
+        CHECK(text.GetSlotCount() == 32);
+        CHECK(instances.size() == 32);
+        CHECK(instances[8].mX == 0 && instances[8].mY == 16);
+        CHECK(SameInstances(&instances[7], &HiddenGlyph, 1));
+
+        // Setting what a label already has isn't a change
+        text.SetText(score, "Score 0");
+        text.SetPosition(best, 0, 16);
+        text.SetColor(lives, TextColorWhite);
+        CHECK(!text.HasChanges());
+        CHECK(text.GetChangedSlotCount() == 0);
+        CHECK(Flush(text, instances).empty());
+
+        // Changing a label only uploads its own range
+        text.SetText(best, "Best score 1010");
+        changes = Flush(text, instances);
+        CHECK(changes.size() == 1 && IsRange(changes[0], 8, 16));
+        CHECK(instances.size() == 16);
+        CHECK((instances[13].mGlyphAndColor & 0xFF) == '1' - Font::FirstChar);
+
+        text.SetPosition(lives, 4, 40);
+        changes = Flush(text, instances);
+        CHECK(changes.size() == 1 && IsRange(changes[0], 24, 8));
+        CHECK(instances[0].mX == 4 && instances[0].mY == 40 && instances[1].mX == 4 + static_cast<int32_t>(Font::CharWidth));
+
+        // Ranges that aren't next to each other stay apart, and every change of a label in one flush is written once
+        text.SetColor(score, 0xFF0000);
+        text.SetText(score, "Score 1");
+        text.SetColor(lives, 0x00FF00);
+        CHECK(text.GetChangedSlotCount() == 16);
+        changes = Flush(text, instances);
+        CHECK(changes.size() == 2 && IsRange(changes[0], 0, 8) && IsRange(changes[1], 24, 8));
+        CHECK(instances.size() == 16);
+        CHECK(instances[0].mGlyphAndColor == PackGlyph('S' - Font::FirstChar, 0xFF0000));
+    }
+
+    void RetainedTextSlotReuse()
+    {
+        RetainedText text;
+        text.Initialize(64);
+        std::vector<GlyphInstance> instances;
+
+        const RetainedText::Handle first = text.Create("0123456789", 0, 0, TextColorWhite);
+        const RetainedText::Handle second = text.Create("abc", 0, 16, TextColorWhite);
+        Flush(text, instances);
+        CHECK(text.GetSlotCount() == 24);
+
+        // Shorter text keeps the label's slots and hides the ones it no longer needs
+        text.SetText(first, "01234");
+        std::vector<RetainedText::SlotRange> changes = Flush(text, instances);
+        CHECK(changes.size() == 1 && IsRange(changes[0], 0, 16));
+        CHECK(!SameInstances(&instances[4], &HiddenGlyph, 1));
+        uint32_t hidden = 0;
+        for (uint32_t i = 5; i < 16; ++i)
+        {
+            hidden += SameInstances(&instances[i], &HiddenGlyph, 1) ? 1 : 0;
+        }
+        CHECK(hidden == 11);
+
+        // A removed label's slots are hidden
+        text.Destroy(second);
+        CHECK(text.HasChanges());
+        changes = Flush(text, instances);
+        CHECK(changes.size() == 1 && IsRange(changes[0], 16, 8));
+        CHECK(instances.size() == 8);
+        hidden = 0;
+        for (const GlyphInstance& instance : instances)
+        {
+            hidden += SameInstances(&instance, &HiddenGlyph, 1) ? 1 : 0;
+        }
+        CHECK(hidden == 8);
+
+        // and reused by the next label of the same size, which then writes them instead of hiding them
+        const RetainedText::Handle third = text.Create("xyz", 0, 32, TextColorWhite);
+        CHECK(text.GetSlotCount() == 24);
+        text.Destroy(first);
+        const RetainedText::Handle fourth = text.Create("0123456789ab", 0, 48, TextColorWhite);
+        changes = Flush(text, instances);
+        CHECK(changes.size() == 1 && IsRange(changes[0], 0, 24));
+        CHECK(text.GetSlotCount() == 24);
+        CHECK(instances[16].mY == 32 && instances[0].mY == 48);
+
+        // Growing past the label's slots moves it and hides the old ones. Here the new range comes right after the old
+        // one, so both go up together.
+        text.SetText(third, "a longer label");
+        changes = Flush(text, instances);
+        CHECK(changes.size() == 1 && IsRange(changes[0], 16, 24));
+        CHECK(text.GetSlotCount() == 40);
+        CHECK(SameInstances(&instances[0], &HiddenGlyph, 1));
+        CHECK(instances[8].mY == 32);
+
+        // Text that doesn't fit anywhere is cut off at the length of the label's slots
+        text.SetText(fourth, std::string(100, 'x'));
+        changes = Flush(text, instances);
+        CHECK(changes.size() == 1 && IsRange(changes[0], 0, 16));
+        CHECK(!SameInstances(&instances[15], &HiddenGlyph, 1));
+        CHECK(text.Create(std::string(64, 'x'), 0, 0, TextColorWhite) == RetainedText::InvalidHandle);
+    }
+
+    // ------------------------------------------------------------------------------------------------
+
+    // Sprites remember where they were added in mX, so the instances can be traced back to them
+    void CheckSpriteBatch(SpriteBatch& batch, const std::vector<Sprite>& sprites)
+    {
+        for (const Sprite& sprite : sprites)
+        {
+            batch.Add(sprite);
+        }
+
+        std::vector<SpriteInstance> instances(sprites.size());
+        std::vector<SpriteDraw> draws;
+        batch.Build(instances.data(), draws);
+
+        // What the sort has to match: stable by layer, then blend mode, then texture
+        const auto key = [](const Sprite& sprite) { return std::make_tuple(sprite.mLayer, sprite.mBlend, sprite.mTexture); };
+        std::vector<Sprite> expected = sprites;
+        std::stable_sort(expected.begin(), expected.end(), [&key](const Sprite& a, const Sprite& b) { return key(a) < key(b); });
+
+        uint32_t wrongOrder = 0;
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            wrongOrder += instances[i].mX == expected[i].mX ? 0 : 1;
+        }
+        CHECK(wrongOrder == 0);
+
+        // One draw per key, covering the instances in order, and within a draw the sprites in the order they were added
+        std::set<std::tuple<uint8_t, SpriteBlend, SpriteTexture>> keys;
+        for (const Sprite& sprite : sprites)
+        {
+            keys.insert(key(sprite));
+        }
+        CHECK(draws.size() == keys.size());
+
+        uint32_t next = 0;
+        uint32_t wrongDraws = 0;
+        for (const SpriteDraw& draw : draws)
+        {
+            wrongDraws += draw.mFirstInstance == next && draw.mInstanceCount > 0 ? 0 : 1;
+            const Sprite& first = sprites[static_cast<uint32_t>(instances[draw.mFirstInstance].mX)];
+            for (uint32_t i = draw.mFirstInstance; i < draw.mFirstInstance + draw.mInstanceCount; ++i)
+            {
+                const Sprite& sprite = sprites[static_cast<uint32_t>(instances[i].mX)];
+                wrongDraws += key(sprite) == key(first) && sprite.mBlend == draw.mBlend && sprite.mTexture == draw.mTexture ? 0 : 1;
+                wrongDraws += i == draw.mFirstInstance || instances[i].mX > instances[i - 1].mX ? 0 : 1;
+            }
+            next += draw.mInstanceCount;
+        }
+        CHECK(wrongDraws == 0);
+        CHECK(next == sprites.size());
+
+        batch.Clear();
+        CHECK(batch.IsEmpty());
+    }
+
+    void SpriteBatchSort()
+    {
+        std::mt19937 random(16);
+        SpriteBatch batch;
+
+        // Keys interleaved at random, with textures past 255 so both texture bytes are sorted on
+        for (uint32_t spriteCount : { 1u, 7u, 1000u, 20000u })
+        {
+            std::vector<Sprite> sprites(spriteCount);
+            for (uint32_t i = 0; i < spriteCount; ++i)
+            {
+                sprites[i].mX = static_cast<float>(i);
+                sprites[i].mLayer = static_cast<uint8_t>(random() % 4);
+                sprites[i].mBlend = random() % 3 == 0 ? SpriteBlend::Opaque : SpriteBlend::Alpha;
+                sprites[i].mTexture = static_cast<SpriteTexture>(random() % 2 == 0 ? random() % 4 : 250 + random() % 20);
+            }
+            CheckSpriteBatch(batch, sprites);
+        }
+
+        // Two keys taking turns, drawn as two runs
+        std::vector<Sprite> alternating(10);
+        for (uint32_t i = 0; i < alternating.size(); ++i)
+        {
+            alternating[i].mX = static_cast<float>(i);
+            alternating[i].mTexture = static_cast<SpriteTexture>(i % 2);
+        }
+        CheckSpriteBatch(batch, alternating);
+
+        // One texture on every layer and blend mode, which is still a draw per layer and blend mode
+        std::vector<Sprite> sharedTexture(24);
+        for (uint32_t i = 0; i < sharedTexture.size(); ++i)
+        {
+            sharedTexture[i].mX = static_cast<float>(i);
+            sharedTexture[i].mLayer = static_cast<uint8_t>(i % 3);
+            sharedTexture[i].mBlend = i % 2 == 0 ? SpriteBlend::Opaque : SpriteBlend::Alpha;
+            sharedTexture[i].mTexture = 5;
+        }
+        CheckSpriteBatch(batch, sharedTexture);
+
+        // Every sprite with the same key skips every pass and stays in order
+        std::vector<Sprite> same(100);
+        for (uint32_t i = 0; i < same.size(); ++i)
+        {
+            same[i].mX = static_cast<float>(i);
+            same[i].mLayer = 3;
+            same[i].mTexture = 300;
+        }
+        CheckSpriteBatch(batch, same);
+    }
+
+    // ------------------------------------------------------------------------------------------------
+
+    // The rasterizer scenes are small enough to check by hand, the reference hashes then catch any other pixel that
+    // changes. If a hash no longer matches, the frame is written out as a TGA so it can be looked at, and the hash printed
+    // so it can be updated when the change was intended.
+    constexpr uint32_t RasterSize = 64;
+    constexpr uint32_t RasterClearColor = 0x202020;
+    constexpr uint32_t RasterClearPixel = 0xFF202020;
+
+    using RasterScene = std::function<void(SoftwareRasterizer& rasterizer)>;
+
+    uint32_t ToPixel(uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+    {
+        return r | (g << 8) | (b << 16) | (a << 24);
+    }
+
+    uint32_t Channel(uint32_t pixel, uint32_t channel)
+    {
+        return (pixel >> (channel * 8)) & 0xFF;
+    }
+
+    // FNV-1a over the visible pixels, like HashAssetPath
+    uint64_t HashPixels(const SoftwareRasterizer& rasterizer)
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (uint32_t y = 0; y < rasterizer.GetHeight(); ++y)
+        {
+            for (uint32_t x = 0; x < rasterizer.GetWidth(); ++x)
+            {
+                const uint32_t pixel = rasterizer.GetPixel(x, y);
+                for (uint32_t channel = 0; channel < 4; ++channel)
+                {
+                    hash ^= Channel(pixel, channel);
+                    hash *= 0x100000001b3ull;
+                }
+            }
+        }
+        return hash;
+    }
+
+    // Draws the scene on the calling thread, and once more with workers drawing the tiles in parallel, which has to give
+    // the same frame
+    void DrawScene(SoftwareRasterizer& rasterizer, const RasterScene& scene, uint32_t clearColor = RasterClearColor)
+    {
+        rasterizer.Initialize(RasterSize, RasterSize, 0);
+        rasterizer.Clear(clearColor);
+        scene(rasterizer);
+        rasterizer.Rasterize();
+
+        SoftwareRasterizer parallel;
+        parallel.Initialize(RasterSize, RasterSize, 3);
+        parallel.Clear(clearColor);
+        scene(parallel);
+        parallel.Rasterize();
+
+        uint32_t different = 0;
+        for (uint32_t y = 0; y < RasterSize; ++y)
+        {
+            for (uint32_t x = 0; x < RasterSize; ++x)
+            {
+                different += rasterizer.GetPixel(x, y) == parallel.GetPixel(x, y) ? 0 : 1;
+            }
+        }
+        CHECK(different == 0);
+    }
+
+    void CheckReferenceHash(const SoftwareRasterizer& rasterizer, uint64_t referenceHash, const char* imageName)
+    {
+        const uint64_t hash = HashPixels(rasterizer);
+        CHECK(hash == referenceHash);
+        if (hash != referenceHash)
+        {
+            const std::string path = std::string(imageName) + ".tga";
+            fprintf(stderr, "%s is 0x%016llxull, written to %s\n", imageName, static_cast<unsigned long long>(hash), path.c_str());
+            rasterizer.WriteTga(path);
+        }
+    }
+
+    // Twice the signed area of a, b, p. Zero when p is on the line through a and b.
+    double EdgeFunction(const RasterVertex& a, const RasterVertex& b, double x, double y)
+    {
+        return (static_cast<double>(b.mX) - a.mX) * (y - a.mY) - (static_cast<double>(b.mY) - a.mY) * (x - a.mX);
+    }
+
+    // Texture coordinates run from 0, 0 at the top left corner to 1, 1 at the bottom right one
+    void AddQuad(SoftwareRasterizer& rasterizer, const RasterState& state, float left, float top, float right, float bottom,
+                 float r = 1.0f, float g = 1.0f, float b = 1.0f, float a = 1.0f)
+    {
+        const RasterVertex topLeft = { left, top, 0.0f, 0.0f, r, g, b, a };
+        const RasterVertex topRight = { right, top, 1.0f, 0.0f, r, g, b, a };
+        const RasterVertex bottomLeft = { left, bottom, 0.0f, 1.0f, r, g, b, a };
+        const RasterVertex bottomRight = { right, bottom, 1.0f, 1.0f, r, g, b, a };
+        rasterizer.AddTriangle(state, topLeft, topRight, bottomLeft);
+        rasterizer.AddTriangle(state, bottomLeft, topRight, bottomRight);
+    }
+
+    void SoftwareRasterizerVertexColors()
+    {
+        const RasterVertex vertices[3] =
+        {
+            { 4.0f, 4.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f },
+            { 60.0f, 12.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f },
+            { 16.0f, 58.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f },
+        };
+
+        SoftwareRasterizer rasterizer;
+        DrawScene(rasterizer, [&vertices](SoftwareRasterizer& target) { target.AddTriangle(RasterState(), vertices[0], vertices[1], vertices[2]); });
+
+        // Inside, every channel is the barycentric blend of the vertex colors, outside is the clear color. Pixel centers
+        // right on an edge are left to the fill rule test.
+        const double area = EdgeFunction(vertices[0], vertices[1], vertices[2].mX, vertices[2].mY);
+        uint32_t wrongInside = 0;
+        uint32_t wrongOutside = 0;
+        uint32_t inside = 0;
+        for (uint32_t y = 0; y < RasterSize; ++y)
+        {
+            for (uint32_t x = 0; x < RasterSize; ++x)
+            {
+                const double weights[3] = { EdgeFunction(vertices[1], vertices[2], x + 0.5, y + 0.5) / area,
+                                            EdgeFunction(vertices[2], vertices[0], x + 0.5, y + 0.5) / area,
+                                            EdgeFunction(vertices[0], vertices[1], x + 0.5, y + 0.5) / area };
+                const uint32_t pixel = rasterizer.GetPixel(x, y);
+                if (weights[0] > 0.0 && weights[1] > 0.0 && weights[2] > 0.0)
+                {
+                    ++inside;
+                    for (uint32_t channel = 0; channel < 3; ++channel)
+                    {
+                        const int32_t expected = static_cast<int32_t>(std::lround(weights[channel] * 255.0));
+                        wrongInside += std::abs(static_cast<int32_t>(Channel(pixel, channel)) - expected) <= 1 ? 0 : 1;
+                    }
+                    wrongInside += Channel(pixel, 3) == 255 ? 0 : 1;
+                }
+                else if (weights[0] < 0.0 || weights[1] < 0.0 || weights[2] < 0.0)
+                {
+                    wrongOutside += pixel == RasterClearPixel ? 0 : 1;
+                }
+            }
+        }
+        CHECK(inside > 1000);
+        CHECK(wrongInside == 0);
+        CHECK(wrongOutside == 0);
+
+        CheckReferenceHash(rasterizer, 0x0205045aa6bdafd5ull, "VertexColors");
+    }
+
+    // 4x4 texels, all different
+    const std::array<uint32_t, 16> gPointTexels = []
+    {
+        std::array<uint32_t, 16> texels = {};
+        for (uint32_t i = 0; i < texels.size(); ++i)
+        {
+            texels[i] = ToPixel(i * 16, 255 - i * 16, (i * 37) & 0xFF, 255);
+        }
+        return texels;
+    }();
+
+    void SoftwareRasterizerPointSampling()
+    {
+        const RasterTexture texture = { reinterpret_cast<const uint8_t*>(gPointTexels.data()), 4, 4, 4 };
+        RasterState state;
+        state.mShader = RasterShader::Texture;
+        state.mFilter = RasterFilter::Point;
+        state.mTexture = &texture;
+
+        // Each texel covers 8x8 pixels. The quad crosses the tile edges at 32.
+        SoftwareRasterizer rasterizer;
+        DrawScene(rasterizer, [&state](SoftwareRasterizer& target) { AddQuad(target, state, 8.0f, 12.0f, 40.0f, 44.0f); });
+
+        uint32_t wrongPixels = 0;
+        for (uint32_t y = 0; y < RasterSize; ++y)
+        {
+            for (uint32_t x = 0; x < RasterSize; ++x)
+            {
+                const bool inside = x >= 8 && x < 40 && y >= 12 && y < 44;
+                const uint32_t expected = inside ? gPointTexels[(y - 12) / 8 * 4 + (x - 8) / 8] : RasterClearPixel;
+                wrongPixels += rasterizer.GetPixel(x, y) == expected ? 0 : 1;
+            }
+        }
+        CHECK(wrongPixels == 0);
+
+        CheckReferenceHash(rasterizer, 0xa5fe1111df1bf325ull, "PointSampling");
+    }
+
+    void SoftwareRasterizerLinearSampling()
+    {
+        // Black and white on top, red and blue below
+        const uint32_t texels[4] = { ToPixel(0, 0, 0, 255), ToPixel(255, 255, 255, 255), ToPixel(255, 0, 0, 255), ToPixel(0, 0, 255, 255) };
+        const RasterTexture texture = { reinterpret_cast<const uint8_t*>(texels), 2, 2, 4 };
+        RasterState state;
+        state.mShader = RasterShader::Texture;
+        state.mFilter = RasterFilter::Linear;
+        state.mAddress = RasterAddress::Clamp;
+        state.mTexture = &texture;
+
+        SoftwareRasterizer rasterizer;
+        DrawScene(rasterizer, [&state](SoftwareRasterizer& target) { AddQuad(target, state, 8.0f, 8.0f, 40.0f, 40.0f); });
+
+        // Up to half a texel from the edges the clamped neighbours are the same texel, so the corners are exact
+        uint32_t wrongCorners = 0;
+        for (uint32_t y = 0; y < 8; ++y)
+        {
+            for (uint32_t x = 0; x < 8; ++x)
+            {
+                wrongCorners += rasterizer.GetPixel(8 + x, 8 + y) == texels[0] ? 0 : 1;
+                wrongCorners += rasterizer.GetPixel(32 + x, 8 + y) == texels[1] ? 0 : 1;
+                wrongCorners += rasterizer.GetPixel(8 + x, 32 + y) == texels[2] ? 0 : 1;
+                wrongCorners += rasterizer.GetPixel(32 + x, 32 + y) == texels[3] ? 0 : 1;
+            }
+        }
+        CHECK(wrongCorners == 0);
+
+        // In between, the top row ramps from black to white and the center is close to the average of all four
+        uint32_t wrongRamp = 0;
+        for (uint32_t x = 9; x < 40; ++x)
+        {
+            const uint32_t pixel = rasterizer.GetPixel(x, 8);
+            const uint32_t previous = rasterizer.GetPixel(x - 1, 8);
+            wrongRamp += Channel(pixel, 0) >= Channel(previous, 0) && Channel(pixel, 0) == Channel(pixel, 1) && Channel(pixel, 0) == Channel(pixel, 2) ? 0 : 1;
+        }
+        CHECK(wrongRamp == 0);
+        CHECK(Channel(rasterizer.GetPixel(24, 8), 0) > 100 && Channel(rasterizer.GetPixel(24, 8), 0) < 155);
+
+        const uint32_t center = rasterizer.GetPixel(24, 24);
+        CHECK(std::abs(static_cast<int32_t>(Channel(center, 0)) - 128) <= 8);
+        CHECK(std::abs(static_cast<int32_t>(Channel(center, 1)) - 64) <= 8);
+        CHECK(std::abs(static_cast<int32_t>(Channel(center, 2)) - 128) <= 8);
+        CHECK(rasterizer.GetPixel(7, 7) == RasterClearPixel && rasterizer.GetPixel(40, 40) == RasterClearPixel);
+
+        CheckReferenceHash(rasterizer, 0x91f5665a612b51c9ull, "LinearSampling");
+    }
+
+    void SoftwareRasterizerCoverage()
+    {
+        // A single channel texture like the font atlas, with every coverage from 0 to 252 in steps of 4
+        std::array<uint8_t, 64> coverage = {};
+        for (uint32_t i = 0; i < coverage.size(); ++i)
+        {
+            coverage[i] = static_cast<uint8_t>((i % 8) * 32 + (i / 8) * 4);
+        }
+        const RasterTexture texture = { coverage.data(), 8, 8, 1 };
+
+        // The text pipeline's state, blended over a colored target
+        RasterState state;
+        state.mShader = RasterShader::Coverage;
+        state.mFilter = RasterFilter::Point;
+        state.mAddress = RasterAddress::Clamp;
+        state.mAlphaBlend = true;
+        state.mTexture = &texture;
+
+        const float color[3] = { 1.0f, 0.5f, 0.25f };
+        const uint32_t clearColor = 0x402010;
+        SoftwareRasterizer rasterizer;
+        DrawScene(rasterizer, [&state, &color](SoftwareRasterizer& target) { AddQuad(target, state, 16.0f, 16.0f, 48.0f, 48.0f, color[0], color[1], color[2]); },
+                  clearColor);
+
+        // Each texel covers 4x4 pixels. The color is blended by the coverage and the target's alpha replaced by it.
+        const uint32_t clear[3] = { 0x40, 0x20, 0x10 };
+        uint32_t wrongPixels = 0;
+        for (uint32_t y = 0; y < RasterSize; ++y)
+        {
+            for (uint32_t x = 0; x < RasterSize; ++x)
+            {
+                const uint32_t pixel = rasterizer.GetPixel(x, y);
+                if (x < 16 || x >= 48 || y < 16 || y >= 48)
+                {
+                    wrongPixels += pixel == ToPixel(clear[0], clear[1], clear[2], 255) ? 0 : 1;
+                    continue;
+                }
+
+                const uint32_t texel = coverage[(y - 16) / 4 * 8 + (x - 16) / 4];
+                const double alpha = texel / 255.0;
+                for (uint32_t channel = 0; channel < 3; ++channel)
+                {
+                    const double destination = clear[channel] / 255.0;
+                    const int32_t expected = static_cast<int32_t>(std::lround((destination + (color[channel] - destination) * alpha) * 255.0));
+                    wrongPixels += std::abs(static_cast<int32_t>(Channel(pixel, channel)) - expected) <= 1 ? 0 : 1;
+                }
+                wrongPixels += Channel(pixel, 3) == texel ? 0 : 1;
+            }
+        }
+        CHECK(wrongPixels == 0);
+
+        CheckReferenceHash(rasterizer, 0x96396acf8c6e7225ull, "Coverage");
+    }
+
+    using RasterTriangle = std::array<RasterVertex, 3>;
+
+    // How many of the triangles draw each pixel. Each triangle is drawn into a frame of its own, across all four tiles.
+    std::vector<uint32_t> CountCoverage(const std::vector<RasterTriangle>& triangles)
+    {
+        SoftwareRasterizer rasterizer;
+        rasterizer.Initialize(RasterSize, RasterSize, 0);
+
+        std::vector<uint32_t> counts(RasterSize * RasterSize, 0);
+        for (const RasterTriangle& triangle : triangles)
+        {
+            rasterizer.Clear(0);
+            rasterizer.AddTriangle(RasterState(), triangle[0], triangle[1], triangle[2]);
+            rasterizer.Rasterize();
+            for (uint32_t i = 0; i < counts.size(); ++i)
+            {
+                counts[i] += rasterizer.GetPixel(i % RasterSize, i / RasterSize) == ToPixel(0, 0, 0, 255) ? 0 : 1;
+            }
+        }
+        return counts;
+    }
+
+    RasterVertex WhiteVertex(float x, float y)
+    {
+        return { x, y, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+    }
+
+    // Triangles sharing an edge draw every pixel on it exactly once. The outer edges of the square run through pixel
+    // centers too, so the top and left rows are drawn and the bottom and right ones aren't.
+    void SoftwareRasterizerSharedEdges()
+    {
+        for (bool otherDiagonal : { false, true })
+        {
+            const RasterVertex topLeft = WhiteVertex(4.5f, 4.5f);
+            const RasterVertex topRight = WhiteVertex(36.5f, 4.5f);
+            const RasterVertex bottomLeft = WhiteVertex(4.5f, 36.5f);
+            const RasterVertex bottomRight = WhiteVertex(36.5f, 36.5f);
+            const std::vector<RasterTriangle> triangles = otherDiagonal
+                ? std::vector<RasterTriangle>{ { topLeft, topRight, bottomLeft }, { bottomLeft, topRight, bottomRight } }
+                : std::vector<RasterTriangle>{ { topLeft, topRight, bottomRight }, { topLeft, bottomRight, bottomLeft } };
+
+            const std::vector<uint32_t> counts = CountCoverage(triangles);
+            uint32_t wrongPixels = 0;
+            for (uint32_t i = 0; i < counts.size(); ++i)
+            {
+                const uint32_t x = i % RasterSize;
+                const uint32_t y = i / RasterSize;
+                wrongPixels += counts[i] == (x >= 4 && x < 36 && y >= 4 && y < 36 ? 1u : 0u) ? 0 : 1;
+            }
+            CHECK(wrongPixels == 0);
+        }
+
+        // A fan around a pixel center, with every spoke running through pixel centers and across the tile edges
+        const RasterVertex center = WhiteVertex(32.5f, 32.5f);
+        const int32_t offsets[][2] = { { 20, 0 }, { 17, 10 }, { 10, 17 }, { 0, 20 }, { -10, 17 }, { -17, 10 },
+                                       { -20, 0 }, { -17, -10 }, { -10, -17 }, { 0, -20 }, { 10, -17 }, { 17, -10 } };
+        std::vector<RasterVertex> outline;
+        for (const auto& offset : offsets)
+        {
+            outline.push_back(WhiteVertex(center.mX + offset[0], center.mY + offset[1]));
+        }
+        std::vector<RasterTriangle> fan;
+        for (size_t i = 0; i < outline.size(); ++i)
+        {
+            fan.push_back({ center, outline[i], outline[(i + 1) % outline.size()] });
+        }
+
+        // Inside the outline every pixel is drawn once, outside none are. Centers on the outline can go either way.
+        const std::vector<uint32_t> counts = CountCoverage(fan);
+        uint32_t wrongPixels = 0;
+        for (uint32_t i = 0; i < counts.size(); ++i)
+        {
+            bool inside = true;
+            bool outside = false;
+            for (size_t edge = 0; edge < outline.size(); ++edge)
+            {
+                const double distance = EdgeFunction(outline[edge], outline[(edge + 1) % outline.size()], i % RasterSize + 0.5, i / RasterSize + 0.5);
+                inside = inside && distance > 0.0;
+                outside = outside || distance < 0.0;
+            }
+            wrongPixels += counts[i] <= 1 ? 0 : 1;
+            wrongPixels += !inside || counts[i] == 1 ? 0 : 1;
+            wrongPixels += !outside || counts[i] == 0 ? 0 : 1;
+        }
+        CHECK(wrongPixels == 0);
+
+        // The two halves of the square in different colors, for the reference hash
+        SoftwareRasterizer rasterizer;
+        DrawScene(rasterizer, [](SoftwareRasterizer& target)
+        {
+            const RasterVertex red[3] = { { 4.5f, 4.5f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f }, { 36.5f, 4.5f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f }, { 4.5f, 36.5f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f } };
+            const RasterVertex green[3] = { { 4.5f, 36.5f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f }, { 36.5f, 4.5f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f }, { 36.5f, 36.5f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f } };
+            target.AddTriangle(RasterState(), red[0], red[1], red[2]);
+            target.AddTriangle(RasterState(), green[0], green[1], green[2]);
+        });
+        CheckReferenceHash(rasterizer, 0xe7ce51361afe5c85ull, "SharedEdges");
+    }
+
+    // A grid of triangles with the inner vertices moved off the pixel grid, so the shared edges cross pixels at every
+    // angle. Together they draw every pixel of the square exactly once.
+    void SoftwareRasterizerMeshWatertight()
+    {
+        constexpr uint32_t GridSize = 7;
+        std::mt19937 random(22);
+        std::uniform_real_distribution<float> jitter(-3.0f, 3.0f);
+
+        RasterVertex grid[GridSize][GridSize];
+        for (uint32_t row = 0; row < GridSize; ++row)
+        {
+            for (uint32_t column = 0; column < GridSize; ++column)
+            {
+                float x = 2.5f + column * 59.0f / (GridSize - 1);
+                float y = 2.5f + row * 59.0f / (GridSize - 1);
+                if (row > 0 && row < GridSize - 1 && column > 0 && column < GridSize - 1)
+                {
+                    x += jitter(random);
+                    y += jitter(random);
+                }
+                grid[row][column] = WhiteVertex(x, y);
+            }
+        }
+
+        std::vector<RasterTriangle> triangles;
+        for (uint32_t row = 0; row + 1 < GridSize; ++row)
+        {
+            for (uint32_t column = 0; column + 1 < GridSize; ++column)
+            {
+                // Alternate the diagonal so edges go both ways
+                const RasterVertex& a = grid[row][column];
+                const RasterVertex& b = grid[row][column + 1];
+                const RasterVertex& c = grid[row + 1][column];
+                const RasterVertex& d = grid[row + 1][column + 1];
+                if ((row + column) % 2 == 0)
+                {
+                    triangles.push_back({ a, b, d });
+                    triangles.push_back({ a, d, c });
+                }
+                else
+                {
+                    triangles.push_back({ a, b, c });
+                    triangles.push_back({ c, b, d });
+                }
+            }
+        }
+
+        const std::vector<uint32_t> counts = CountCoverage(triangles);
+        uint32_t wrongPixels = 0;
+        for (uint32_t i = 0; i < counts.size(); ++i)
+        {
+            const uint32_t x = i % RasterSize;
+            const uint32_t y = i / RasterSize;
+            wrongPixels += counts[i] == (x >= 2 && x < 61 && y >= 2 && y < 61 ? 1u : 0u) ? 0 : 1;
+        }
+        CHECK(wrongPixels == 0);
+    }
+
+    const Test gTests[] =
+    {
+        { "SkylinePacker random rects", SkylinePackerRandomRects },
+        { "SkylinePacker padding", SkylinePackerPadding },
+        { "SkylinePacker full", SkylinePackerFull },
+        { "DescriptorAllocator merge", DescriptorAllocatorMerge },
+        { "DescriptorAllocator deferred free", DescriptorAllocatorDeferredFree },
+        { "DescriptorAllocator transient wrap", DescriptorAllocatorTransientWrap },
+        { "FrameRingAllocator frames", FrameRingAllocatorFrames },
+        { "GlyphInstance packing", GlyphInstancePacking },
+        { "GlyphInstance expansion", GlyphInstanceExpansion },
+        { "LayoutText matches reference", LayoutTextMatchesReference },
+        { "RetainedText changes", RetainedTextChanges },
+        { "RetainedText slot reuse", RetainedTextSlotReuse },
+        { "SpriteBatch sort", SpriteBatchSort },
+        { "SoftwareRasterizer vertex colors", SoftwareRasterizerVertexColors },
+        { "SoftwareRasterizer point sampling", SoftwareRasterizerPointSampling },
+        { "SoftwareRasterizer linear sampling", SoftwareRasterizerLinearSampling },
+        { "SoftwareRasterizer coverage", SoftwareRasterizerCoverage },
+        { "SoftwareRasterizer shared edges", SoftwareRasterizerSharedEdges },
+        { "SoftwareRasterizer mesh watertight", SoftwareRasterizerMeshWatertight },
+    };
+}
+
+int main()
+{
+    uint32_t failedTests = 0;
+    for (const Test& test : gTests)
+    {
+        const uint32_t failures = gFailures;
+        test.mRun();
+        const bool passed = gFailures == failures;
+        printf("%-40s %s\n", test.mName, passed ? "ok" : "FAILED");
+        failedTests += passed ? 0 : 1;
+    }
+
+    printf("\n%u of %zu tests failed\n", failedTests, sizeof(gTests) / sizeof(gTests[0]));
+    return failedTests == 0 ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+// Packs a directory of assets into a single archive that the game can memory map at startup.
+//
+// Usage: AssetPacker <directory> <output.pak> [--page-align]
+//    --page-align  Start every asset on a 4 KB page instead of a 16 byte boundary
+//
+// Assets are stored under their path relative to the parent of <directory>, so packing "data" stores "data/basic.hlsl"
+// which is the same path the game asks for.
+
+#include <Assets.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Input
+    {
+        std::string mName;
+        std::filesystem::path mPath;
+        uint64_t mHash = 0;
+        uint64_t mSize = 0;
+    };
+
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    bool WritePadding(FILE* file, uint64_t& offset, uint64_t alignment)
+    {
+        static const char zeros[4096] = {};
+        const uint64_t padding = AlignUp(offset, alignment) - offset;
+        offset += padding;
+        return fwrite(zeros, 1, static_cast<size_t>(padding), file) == padding;
+    }
+
+    bool CopyAsset(FILE* output, const std::filesystem::path& path, uint64_t size)
+    {
+        MappedFile input;
+        if (!input.Open(path.string(), MappedFile::AccessHint::Sequential) || input.GetSize() != size)
+        {
+            return false;
+        }
+
+        return fwrite(input.GetData(), 1, input.GetSize(), output) == input.GetSize();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <directory> <output.pak> [--page-align]\n", argv[0]);
+        return 1;
+    }
+
+    uint32_t alignment = 16;
+    for (int i = 3; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--page-align") == 0)
+        {
+            alignment = 4096;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::path root = std::filesystem::absolute(argv[1], error);
+    if (error || !std::filesystem::is_directory(root, error))
+    {
+        fprintf(stderr, "%s is not a directory\n", argv[1]);
+        return 1;
+    }
+
+    // "data/" has an empty file name and "data/." one of ".", either way its parent would be "data" itself and the
+    // names would lose their "data/" prefix
+    root = root.lexically_normal();
+    if (!root.has_filename())
+    {
+        root = root.parent_path();
+    }
+
+    std::vector<Input> inputs;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(root, error))
+    {
+        if (!entry.is_regular_file())
+        {
+            continue;
+        }
+
+        Input input;
+        input.mPath = entry.path();
+        input.mName = entry.path().lexically_relative(root.parent_path()).generic_string();
+        input.mHash = HashAssetPath(input.mName);
+        input.mSize = entry.file_size();
+        inputs.push_back(std::move(input));
+    }
+
+    if (error)
+    {
+        fprintf(stderr, "Could not list %s: %s\n", argv[1], error.message().c_str());
+        return 1;
+    }
+
+    // Paths with the same hash end up next to each other, the game compares the names to tell them apart
+    std::sort(inputs.begin(), inputs.end(), [](const Input& a, const Input& b)
+    {
+        return a.mHash != b.mHash ? a.mHash < b.mHash : a.mName < b.mName;
+    });
+
+    // Lay out the header, index and names, then the blobs
+    AssetPack::Header header = {};
+    header.mMagic = AssetPack::Magic;
+    header.mVersion = AssetPack::Version;
+    header.mEntryCount = static_cast<uint32_t>(inputs.size());
+    header.mAlignment = alignment;
+    header.mIndexOffset = sizeof(AssetPack::Header);
+    header.mNamesOffset = header.mIndexOffset + inputs.size() * sizeof(AssetPack::Entry);
+
+    std::string names;
+    std::vector<AssetPack::Entry> entries(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        entries[i].mHash = inputs[i].mHash;
+        entries[i].mSize = inputs[i].mSize;
+        entries[i].mNameOffset = static_cast<uint32_t>(names.size());
+        entries[i].mNameLength = static_cast<uint32_t>(inputs[i].mName.size());
+        names += inputs[i].mName;
+    }
+
+    uint64_t offset = header.mNamesOffset + names.size();
+    for (AssetPack::Entry& entry : entries)
+    {
+        offset = AlignUp(offset, alignment);
+        entry.mOffset = offset;
+        offset += entry.mSize;
+    }
+
+    FILE* output = fopen(argv[2], "wb");
+    if (output == nullptr)
+    {
+        fprintf(stderr, "Could not create %s\n", argv[2]);
+        return 1;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, output) == 1;
+    written = written && fwrite(entries.data(), sizeof(AssetPack::Entry), entries.size(), output) == entries.size();
+    written = written && fwrite(names.data(), 1, names.size(), output) == names.size();
+
+    offset = header.mNamesOffset + names.size();
+    for (size_t i = 0; written && i < inputs.size(); ++i)
+    {
+        written = WritePadding(output, offset, alignment) && CopyAsset(output, inputs[i].mPath, inputs[i].mSize);
+        offset += inputs[i].mSize;
+    }
+
+    written = fclose(output) == 0 && written;
+    if (!written)
+    {
+        fprintf(stderr, "Failed to write %s\n", argv[2]);
+        std::filesystem::remove(argv[2], error);
+        return 1;
+    }
+
+    printf("Packed %zu assets into %s (%llu bytes)\n", inputs.size(), argv[2], static_cast<unsigned long long>(offset));
+    return 0;
+}
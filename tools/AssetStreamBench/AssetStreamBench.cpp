@@ -0,0 +1,354 @@
+// Measures the throughput and latency of the asset streamer. Writes a number of synthetic assets to a temporary
+// directory, requests all of them at once with priorities going round from Critical to Low, and calls
+// DispatchCompletions in a loop on the main thread like the game does once per frame until every request has completed.
+//
+// The latency of an asset is the time from its request to its completion callback, so it includes the wait in the
+// queues behind the other requests. The files were just written, so they are read from the OS cache rather than the
+// disk.
+//
+// Usage: AssetStreamBench [--assets <count>] [--size <KB>] [--io <threads>] [--decode <threads>] [--repeat <count>] [--pack]
+//    --assets  Number of assets. Default 1000.
+//    --size    Size of every asset in KB. Default 64.
+//    --io      I/O threads of the streamer. Default 2.
+//    --decode  Decode threads of the streamer. Default 0, which lets the streamer pick.
+//    --repeat  Runs, the one with the best throughput is reported. Default 5.
+//    --pack    Pack the assets into an archive and mount it, like the game does with data.pak, instead of loading loose files
+
+#include <AssetStreamer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Settings
+    {
+        uint32_t mAssetCount = 1000;
+        uint32_t mAssetSize = 64 * 1024;
+        uint32_t mIOThreads = 2;
+        uint32_t mDecodeThreads = 0;
+        uint32_t mRepeatCount = 5;
+        bool mPack = false;
+    };
+
+    constexpr uint32_t PriorityCount = 4;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Request
+    {
+        std::string mPath;
+        AssetPriority mPriority;
+        Clock::time_point mStart;
+        double mLatency = 0.0;
+        bool mLoaded = false;
+    };
+
+    struct Run
+    {
+        double mTotal = 0.0;
+        double mFirst = 0.0;
+        std::vector<Request> mRequests;
+    };
+
+    void PrintUsage()
+    {
+        fprintf(stderr, "Usage: AssetStreamBench [--assets <count>] [--size <KB>] [--io <threads>] [--decode <threads>] [--repeat <count>] [--pack]\n");
+    }
+
+    // Deterministic contents so the decode step can check what it read
+    uint8_t GetAssetByte(uint32_t asset, size_t offset)
+    {
+        return static_cast<uint8_t>(asset * 31 + offset * 7);
+    }
+
+    bool WriteAssets(const Settings& settings, const std::filesystem::path& directory, std::vector<std::string>& paths)
+    {
+        std::vector<uint8_t> contents(settings.mAssetSize);
+        for (uint32_t asset = 0; asset < settings.mAssetCount; ++asset)
+        {
+            for (size_t offset = 0; offset < contents.size(); ++offset)
+            {
+                contents[offset] = GetAssetByte(asset, offset);
+            }
+
+            const std::string path = (directory / ("asset" + std::to_string(asset) + ".bin")).generic_string();
+            FILE* file = fopen(path.c_str(), "wb");
+            const bool written = file != nullptr && fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+            if (file == nullptr || fclose(file) != 0 || !written)
+            {
+                fprintf(stderr, "Could not write %s\n", path.c_str());
+                return false;
+            }
+            paths.push_back(path);
+        }
+        return true;
+    }
+
+    // The same layout the AssetPacker writes, with the loose files' paths as the names
+    bool WriteArchive(const std::vector<std::string>& paths, const std::string& archivePath)
+    {
+        struct Input
+        {
+            uint32_t mIndex;
+            uint64_t mHash;
+        };
+
+        std::vector<Input> inputs;
+        for (uint32_t i = 0; i < paths.size(); ++i)
+        {
+            inputs.push_back({ i, HashAssetPath(paths[i]) });
+        }
+        std::sort(inputs.begin(), inputs.end(), [](const Input& a, const Input& b) { return a.mHash < b.mHash; });
+
+        constexpr uint32_t Alignment = 16;
+        AssetPack::Header header = {};
+        header.mMagic = AssetPack::Magic;
+        header.mVersion = AssetPack::Version;
+        header.mEntryCount = static_cast<uint32_t>(inputs.size());
+        header.mAlignment = Alignment;
+        header.mIndexOffset = sizeof(AssetPack::Header);
+        header.mNamesOffset = header.mIndexOffset + inputs.size() * sizeof(AssetPack::Entry);
+
+        std::string names;
+        std::vector<AssetPack::Entry> entries(inputs.size());
+        std::vector<MappedFile> files(inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            const std::string& path = paths[inputs[i].mIndex];
+            if (!files[i].Open(path, MappedFile::AccessHint::Sequential))
+            {
+                return false;
+            }
+
+            entries[i].mHash = inputs[i].mHash;
+            entries[i].mSize = files[i].GetSize();
+            entries[i].mNameOffset = static_cast<uint32_t>(names.size());
+            entries[i].mNameLength = static_cast<uint32_t>(path.size());
+            names += path;
+        }
+
+        uint64_t offset = header.mNamesOffset + names.size();
+        for (AssetPack::Entry& entry : entries)
+        {
+            offset = (offset + Alignment - 1) & ~static_cast<uint64_t>(Alignment - 1);
+            entry.mOffset = offset;
+            offset += entry.mSize;
+        }
+
+        FILE* output = fopen(archivePath.c_str(), "wb");
+        if (output == nullptr)
+        {
+            return false;
+        }
+
+        static const char zeros[Alignment] = {};
+        bool written = fwrite(&header, sizeof(header), 1, output) == 1;
+        written = written && fwrite(entries.data(), sizeof(AssetPack::Entry), entries.size(), output) == entries.size();
+        written = written && fwrite(names.data(), 1, names.size(), output) == names.size();
+        offset = header.mNamesOffset + names.size();
+        for (size_t i = 0; written && i < entries.size(); ++i)
+        {
+            const size_t padding = static_cast<size_t>(entries[i].mOffset - offset);
+            written = fwrite(zeros, 1, padding, output) == padding && fwrite(files[i].GetData(), 1, files[i].GetSize(), output) == files[i].GetSize();
+            offset = entries[i].mOffset + entries[i].mSize;
+        }
+        return fclose(output) == 0 && written;
+    }
+
+    Run Measure(const Settings& settings, const std::vector<std::string>& paths)
+    {
+        Run run;
+        run.mRequests.resize(paths.size());
+
+        AssetStreamer::Get().Start(settings.mIOThreads, settings.mDecodeThreads);
+
+        uint32_t completed = 0;
+        const Clock::time_point start = Clock::now();
+        for (uint32_t i = 0; i < paths.size(); ++i)
+        {
+            Request& request = run.mRequests[i];
+            request.mPath = paths[i];
+            request.mPriority = static_cast<AssetPriority>(i % PriorityCount);
+            request.mStart = Clock::now();
+
+            // Checking the contents stands in for decoding the asset
+            auto decode = [i](const Asset& asset)
+            {
+                const uint8_t* data = asset.GetData();
+                for (size_t offset = 0; offset < asset.GetSize(); offset += 64)
+                {
+                    if (data[offset] != GetAssetByte(i, offset))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            auto complete = [&request, &completed](bool loaded)
+            {
+                request.mLatency = std::chrono::duration<double, std::milli>(Clock::now() - request.mStart).count();
+                request.mLoaded = loaded;
+                ++completed;
+            };
+
+            AssetStreamer::Get().Request(request.mPath, request.mPriority, decode, complete);
+        }
+
+        while (completed < paths.size())
+        {
+            if (AssetStreamer::Get().DispatchCompletions() > 0 && run.mFirst == 0.0)
+            {
+                run.mFirst = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            }
+            std::this_thread::yield();
+        }
+        run.mTotal = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        AssetStreamer::Get().Stop();
+        return run;
+    }
+
+    double GetPercentile(std::vector<double>& values, double percentile)
+    {
+        if (values.empty())
+        {
+            return 0.0;
+        }
+
+        std::sort(values.begin(), values.end());
+        const size_t index = static_cast<size_t>(percentile * (values.size() - 1) + 0.5);
+        return values[index];
+    }
+
+    void PrintLatency(const char* name, std::vector<double> latencies)
+    {
+        const double p50 = GetPercentile(latencies, 0.5);
+        const double p99 = GetPercentile(latencies, 0.99);
+        printf("%-10s %8zu %9.3f %9.3f %9.3f\n", name, latencies.size(), p50, p99, latencies.empty() ? 0.0 : latencies.back());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Settings settings;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* option = argv[i];
+        if (strcmp(option, "--pack") == 0)
+        {
+            settings.mPack = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        const int value = atoi(argv[++i]);
+        if (strcmp(option, "--assets") == 0)
+        {
+            settings.mAssetCount = static_cast<uint32_t>(std::max(value, 1));
+        }
+        else if (strcmp(option, "--size") == 0)
+        {
+            settings.mAssetSize = static_cast<uint32_t>(std::max(value, 1)) * 1024;
+        }
+        else if (strcmp(option, "--io") == 0)
+        {
+            settings.mIOThreads = static_cast<uint32_t>(std::max(value, 1));
+        }
+        else if (strcmp(option, "--decode") == 0)
+        {
+            settings.mDecodeThreads = static_cast<uint32_t>(std::max(value, 0));
+        }
+        else if (strcmp(option, "--repeat") == 0)
+        {
+            settings.mRepeatCount = static_cast<uint32_t>(std::max(value, 1));
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    std::error_code error;
+    const std::filesystem::path directory = std::filesystem::temp_directory_path(error) / "AssetStreamBench";
+    std::filesystem::remove_all(directory, error);
+    if (!std::filesystem::create_directories(directory, error))
+    {
+        fprintf(stderr, "Could not create %s\n", directory.string().c_str());
+        return 1;
+    }
+
+    std::vector<std::string> paths;
+    bool ready = WriteAssets(settings, directory, paths);
+    if (ready && settings.mPack)
+    {
+        const std::string archivePath = (directory / "assets.pak").string();
+        ready = WriteArchive(paths, archivePath) && AssetManager::Get().Mount(archivePath);
+        if (!ready)
+        {
+            fprintf(stderr, "Could not pack the assets into %s\n", archivePath.c_str());
+        }
+    }
+
+    Run best;
+    for (uint32_t run = 0; ready && run < settings.mRepeatCount; ++run)
+    {
+        Run result = Measure(settings, paths);
+        if (run == 0 || result.mTotal < best.mTotal)
+        {
+            best = std::move(result);
+        }
+    }
+
+    // Mounting nothing closes the archive, which has to happen before its file can be removed
+    AssetManager::Get().Mount(std::string());
+    std::filesystem::remove_all(directory, error);
+    if (!ready)
+    {
+        return 1;
+    }
+
+    const size_t failed = std::count_if(best.mRequests.begin(), best.mRequests.end(), [](const Request& request) { return !request.mLoaded; });
+    if (failed != 0)
+    {
+        fprintf(stderr, "%zu of %u assets failed to load\n", failed, settings.mAssetCount);
+        return 1;
+    }
+
+    const double megabytes = static_cast<double>(settings.mAssetCount) * settings.mAssetSize / (1024.0 * 1024.0);
+    printf("%u assets of %u KB from %s, best of %u runs\n\n", settings.mAssetCount, settings.mAssetSize / 1024,
+           settings.mPack ? "an archive" : "loose files", settings.mRepeatCount);
+    printf("total %.3f ms, first completion %.3f ms, %.1f assets/s, %.1f MB/s\n\n", best.mTotal, best.mFirst,
+           settings.mAssetCount * 1000.0 / best.mTotal, megabytes * 1000.0 / best.mTotal);
+
+    const char* const priorityNames[PriorityCount] = { "Critical", "High", "Normal", "Low" };
+    std::vector<double> all;
+    std::vector<double> byPriority[PriorityCount];
+    for (const Request& request : best.mRequests)
+    {
+        all.push_back(request.mLatency);
+        byPriority[static_cast<uint32_t>(request.mPriority)].push_back(request.mLatency);
+    }
+
+    printf("latency      assets    p50 ms    p99 ms    max ms\n");
+    for (uint32_t priority = 0; priority < PriorityCount; ++priority)
+    {
+        PrintLatency(priorityNames[priority], byPriority[priority]);
+    }
+    PrintLatency("all", all);
+    return 0;
+}
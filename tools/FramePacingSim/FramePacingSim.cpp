@@ -0,0 +1,184 @@
+// Simulates how CPU and GPU frames overlap for 1 to 3 frames in flight, without a GPU. Use it to see what the
+// framesInFlight setting of CreateD3D12Backend does to frame rate and latency for a given CPU and GPU cost.
+//
+// Usage: FramePacingSim --cpu <ms> --gpu <ms> [--refresh <hz>] [--jitter <fraction>] [--frames <count>] [--buffers <count>]
+//    --cpu      CPU time to simulate and record a frame
+//    --gpu      GPU time to render a frame
+//    --refresh  Display refresh rate, frames are shown on the next vblank. 0 presents immediately. Default 60.
+//    --jitter   Every CPU and GPU time is scaled by a random factor in [1 - jitter, 1 + jitter]. Default 0.
+//    --frames   Number of frames to simulate. Default 10000.
+//    --buffers  Number of swap chain buffers. Default 3, same as the renderer.
+//
+// The model follows the renderer's frame loop:
+//  - Frame k starts on the CPU once frame k - 1 is recorded and the GPU has finished frame k - framesInFlight, which
+//    is when its command allocator can be reused.
+//  - The GPU renders frames in order, and only once the back buffer it draws to is no longer on screen.
+//  - A finished frame is shown at the next vblank after the previous one.
+// Latency is measured from the start of the CPU frame, where input would be read, until the frame is on screen.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+    struct Settings
+    {
+        double mCpuTime = 0.0;
+        double mGpuTime = 0.0;
+        double mRefreshRate = 60.0;
+        double mJitter = 0.0;
+        uint32_t mFrameCount = 10000;
+        uint32_t mBufferCount = 3;
+    };
+
+    struct Result
+    {
+        double mFramesPerSecond = 0.0;
+        double mAverageLatency = 0.0;
+        double mWorstLatency = 0.0;
+        double mCpuBusy = 0.0;          // Fraction of the time the CPU was recording frames
+        double mGpuBusy = 0.0;
+    };
+
+    Result Simulate(const Settings& settings, uint32_t framesInFlight)
+    {
+        const uint32_t count = settings.mFrameCount;
+        const double period = settings.mRefreshRate > 0.0 ? 1000.0 / settings.mRefreshRate : 0.0;
+
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<double> jitter(1.0 - settings.mJitter, 1.0 + settings.mJitter);
+
+        std::vector<double> cpuStart(count), cpuEnd(count), gpuEnd(count), shown(count);
+        double cpuBusy = 0.0;
+        double gpuBusy = 0.0;
+        for (uint32_t k = 0; k < count; ++k)
+        {
+            double start = k > 0 ? cpuEnd[k - 1] : 0.0;
+            if (k >= framesInFlight)
+            {
+                start = std::max(start, gpuEnd[k - framesInFlight]);
+            }
+
+            const double cpuTime = settings.mCpuTime * jitter(random);
+            cpuStart[k] = start;
+            cpuEnd[k] = start + cpuTime;
+            cpuBusy += cpuTime;
+
+            // The back buffer of frame k was last used by frame k - buffers and is free once the frame after that is shown
+            double gpuStart = std::max(cpuEnd[k], k > 0 ? gpuEnd[k - 1] : 0.0);
+            if (k + 1 >= settings.mBufferCount)
+            {
+                gpuStart = std::max(gpuStart, shown[k + 1 - settings.mBufferCount]);
+            }
+
+            const double gpuTime = settings.mGpuTime * jitter(random);
+            gpuEnd[k] = gpuStart + gpuTime;
+            gpuBusy += gpuTime;
+
+            double present = gpuEnd[k];
+            if (period > 0.0)
+            {
+                present = std::ceil(present / period) * period;
+                if (k > 0)
+                {
+                    present = std::max(present, shown[k - 1] + period);
+                }
+            }
+            shown[k] = present;
+        }
+
+        // Skip the first frames so the pipeline is full before measuring
+        const uint32_t first = std::min(count - 1, 2 * settings.mBufferCount);
+        Result result;
+        double latencySum = 0.0;
+        for (uint32_t k = first; k < count; ++k)
+        {
+            const double latency = shown[k] - cpuStart[k];
+            latencySum += latency;
+            result.mWorstLatency = std::max(result.mWorstLatency, latency);
+        }
+
+        const double elapsed = shown[count - 1] - shown[first];
+        result.mFramesPerSecond = elapsed > 0.0 ? (count - 1 - first) * 1000.0 / elapsed : 0.0;
+        result.mAverageLatency = latencySum / (count - first);
+        result.mCpuBusy = cpuBusy / shown[count - 1];
+        result.mGpuBusy = gpuBusy / shown[count - 1];
+        return result;
+    }
+
+    void PrintUsage()
+    {
+        fprintf(stderr, "Usage: FramePacingSim --cpu <ms> --gpu <ms> [--refresh <hz>] [--jitter <fraction>] [--frames <count>] [--buffers <count>]\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Settings settings;
+    bool hasCpu = false;
+    bool hasGpu = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        const char* value = argv[++i];
+        if (strcmp(argv[i - 1], "--cpu") == 0)
+        {
+            settings.mCpuTime = atof(value);
+            hasCpu = true;
+        }
+        else if (strcmp(argv[i - 1], "--gpu") == 0)
+        {
+            settings.mGpuTime = atof(value);
+            hasGpu = true;
+        }
+        else if (strcmp(argv[i - 1], "--refresh") == 0)
+        {
+            settings.mRefreshRate = atof(value);
+        }
+        else if (strcmp(argv[i - 1], "--jitter") == 0)
+        {
+            settings.mJitter = std::clamp(atof(value), 0.0, 1.0);
+        }
+        else if (strcmp(argv[i - 1], "--frames") == 0)
+        {
+            settings.mFrameCount = static_cast<uint32_t>(std::max(atoi(value), 16));
+        }
+        else if (strcmp(argv[i - 1], "--buffers") == 0)
+        {
+            settings.mBufferCount = static_cast<uint32_t>(std::clamp(atoi(value), 2, 16));
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (!hasCpu || !hasGpu || settings.mCpuTime <= 0.0 || settings.mGpuTime <= 0.0)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    printf("cpu %.2f ms, gpu %.2f ms, refresh %.0f hz, jitter %.0f%%, %u buffers\n\n",
+           settings.mCpuTime, settings.mGpuTime, settings.mRefreshRate, settings.mJitter * 100.0, settings.mBufferCount);
+    printf("in flight      fps   latency avg   latency max   cpu busy   gpu busy\n");
+    for (uint32_t framesInFlight = 1; framesInFlight <= 3; ++framesInFlight)
+    {
+        const Result result = Simulate(settings, framesInFlight);
+        printf("%9u %8.1f %10.2f ms %10.2f ms %9.0f%% %9.0f%%\n",
+               framesInFlight, result.mFramesPerSecond, result.mAverageLatency, result.mWorstLatency, result.mCpuBusy * 100.0, result.mGpuBusy * 100.0);
+    }
+
+    return 0;
+}
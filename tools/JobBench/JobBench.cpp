@@ -0,0 +1,221 @@
+// Measures how the job system scales from 1 to N threads on a few synthetic workloads:
+//    parallel-for  A ParallelFor over items that each do a bit of floating point math, like a simulation update
+//    tiny-jobs     Many jobs that do nearly nothing, so the time is all scheduling overhead
+//    tree          Jobs that start two more jobs and wait for them until a given depth, which needs stealing and nested waits
+//    task-tree     The same tree with tasks that co_await their children, so waiting never nests on a thread's stack
+//
+// Usage: JobBench [--threads <count>] [--repeat <count>] [--items <count>]
+//    --threads  Most threads to measure with, the calling thread included. Default is the number of hardware threads.
+//    --repeat   Runs of every workload per thread count, the fastest one is reported. Default 5.
+//    --items    Items of the parallel-for workload and jobs of the tiny-jobs one. Default 1000000.
+//
+// Times are in milliseconds, speedup is against one thread.
+
+#include <JobSystem.h>
+#include <LogSinks.h>
+#include <Task.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Settings
+    {
+        uint32_t mMaxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        uint32_t mRepeatCount = 5;
+        uint32_t mItemCount = 1000000;
+    };
+
+    struct Workload
+    {
+        const char* mName;
+        std::function<void(const Settings& settings)> mRun;
+    };
+
+    constexpr uint32_t TreeDepth = 16;
+
+    void PrintUsage()
+    {
+        fprintf(stderr, "Usage: JobBench [--threads <count>] [--repeat <count>] [--items <count>]\n");
+    }
+
+    // Enough math per item that the loop isn't memory bound
+    std::vector<float> gValues;
+
+    void ParallelForWorkload(const Settings& settings)
+    {
+        gValues.resize(settings.mItemCount);
+        JobSystem::Get().ParallelFor(settings.mItemCount, 1024, [](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                float value = static_cast<float>(i);
+                for (uint32_t iteration = 0; iteration < 16; ++iteration)
+                {
+                    value = std::sqrt(value * value + 1.0f) * 0.5f + std::sin(value);
+                }
+                gValues[i] = value;
+            }
+        });
+    }
+
+    void TinyJobsWorkload(const Settings& settings)
+    {
+        std::atomic<uint32_t> sum{ 0 };
+        JobCounter counter;
+        for (uint32_t i = 0; i < settings.mItemCount; ++i)
+        {
+            JobSystem::Get().Run([&sum] { sum.fetch_add(1, std::memory_order_relaxed); }, &counter);
+        }
+        JobSystem::Get().Wait(counter);
+
+        if (sum != settings.mItemCount)
+        {
+            fprintf(stderr, "tiny-jobs ran %u of %u jobs\n", sum.load(), settings.mItemCount);
+            exit(1);
+        }
+    }
+
+    uint32_t Tree(uint32_t depth)
+    {
+        if (depth == 0)
+        {
+            return 1;
+        }
+
+        uint32_t left = 0;
+        uint32_t right = 0;
+        JobCounter counter;
+        JobSystem::Get().Run([&left, depth] { left = Tree(depth - 1); }, &counter);
+        JobSystem::Get().Run([&right, depth] { right = Tree(depth - 1); }, &counter);
+        JobSystem::Get().Wait(counter);
+        return left + right + 1;
+    }
+
+    void TreeWorkload(const Settings&)
+    {
+        const uint32_t nodes = Tree(TreeDepth);
+        if (nodes != (2u << TreeDepth) - 1)
+        {
+            fprintf(stderr, "tree visited %u nodes\n", nodes);
+            exit(1);
+        }
+    }
+
+    Task TaskTree(uint32_t depth, uint32_t& nodes)
+    {
+        if (depth == 0)
+        {
+            nodes = 1;
+            co_return;
+        }
+
+        uint32_t left = 0;
+        uint32_t right = 0;
+        JobCounter counter;
+        RunTask(TaskTree(depth - 1, left), &counter);
+        RunTask(TaskTree(depth - 1, right), &counter);
+        co_await counter;
+        nodes = left + right + 1;
+    }
+
+    void TaskTreeWorkload(const Settings&)
+    {
+        uint32_t nodes = 0;
+        JobCounter counter;
+        RunTask(TaskTree(TreeDepth, nodes), &counter);
+        JobSystem::Get().Wait(counter);
+
+        if (nodes != (2u << TreeDepth) - 1)
+        {
+            fprintf(stderr, "task-tree visited %u nodes\n", nodes);
+            exit(1);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Settings settings;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        const char* option = argv[i];
+        const uint32_t value = static_cast<uint32_t>(std::max(atoi(argv[++i]), 1));
+        if (strcmp(option, "--threads") == 0)
+        {
+            settings.mMaxThreads = value;
+        }
+        else if (strcmp(option, "--repeat") == 0)
+        {
+            settings.mRepeatCount = value;
+        }
+        else if (strcmp(option, "--items") == 0)
+        {
+            settings.mItemCount = value;
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    Logger::Get().AddSink(std::make_unique<ConsoleLogSink>());
+    Logger::Get().SetLevel(LogCategory::Jobs, LogLevel::Warn);
+    Logger::Get().Start();
+
+    const Workload workloads[] =
+    {
+        { "parallel-for", ParallelForWorkload },
+        { "tiny-jobs", TinyJobsWorkload },
+        { "tree", TreeWorkload },
+        { "task-tree", TaskTreeWorkload },
+    };
+
+    printf("%u items, tree depth %u, best of %u runs\n\n", settings.mItemCount, TreeDepth, settings.mRepeatCount);
+    printf("workload      threads        ms   speedup\n");
+    for (const Workload& workload : workloads)
+    {
+        double singleThreadTime = 0.0;
+        for (uint32_t threads = 1; threads <= settings.mMaxThreads; ++threads)
+        {
+            JobSystem::Get().Start(threads - 1);
+
+            double best = 0.0;
+            for (uint32_t run = 0; run < settings.mRepeatCount; ++run)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                workload.mRun(settings);
+                const double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                best = run == 0 ? time : std::min(best, time);
+            }
+
+            JobSystem::Get().Stop();
+
+            if (threads == 1)
+            {
+                singleThreadTime = best;
+            }
+            printf("%-12s %8u %9.3f %9.2f\n", workload.mName, threads, best, singleThreadTime / best);
+        }
+        printf("\n");
+    }
+
+    Logger::Get().Stop();
+    return 0;
+}
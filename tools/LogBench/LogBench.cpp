@@ -0,0 +1,242 @@
+// Measures what a LOG_INFO costs the thread that logs it, against formatting the message with vsnprintf into a stack
+// buffer and copying it into a std::string, which is what the logger used to do on the calling thread.
+//
+// Every message kind is logged in batches that fit in the thread's ring. The ring is drained between batches, outside of
+// the timed part, so no message is dropped and the time is only that of the call. Draining formats the messages, which
+// is also timed, to show the work that moved to the logger thread.
+//
+// Usage: LogBench [--calls <count>] [--repeat <count>]
+//    --calls   Messages of every kind per run. Default 1000000.
+//    --repeat  Runs of every message kind, the fastest one is reported. Default 5.
+//
+// Times are in nanoseconds per message.
+
+#include <Log.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+
+namespace
+{
+    struct Settings
+    {
+        uint32_t mCallCount = 1000000;
+        uint32_t mRepeatCount = 5;
+    };
+
+    // Allocations made by the timed loops, to show that logging doesn't touch the heap
+    std::atomic<uint64_t> gAllocationCount{ 0 };
+
+    // Below the wake threshold so the batch doesn't wake the logger thread, which isn't running anyway
+    constexpr uint32_t BatchSize = Logger::WakeThreshold - 1;
+
+    void PrintUsage()
+    {
+        fprintf(stderr, "Usage: LogBench [--calls <count>] [--repeat <count>]\n");
+    }
+
+    // Formats every message like the console sink does and throws the text away
+    class FormatSink : public LogSink
+    {
+    public:
+        void Write(const LogSite& site, const LogMessage& message) override
+        {
+            char text[1024];
+            mLength += FormatLogMessage(text, sizeof(text), site.mFormat, site.mSignature, site.mArgCount, message.mPayload.data(), message.mPayloadSize);
+        }
+
+        size_t mLength = 0;
+    };
+
+    // The old path, a message per call out of a thread local pool whose strings keep their capacity
+    struct FormattedMessage
+    {
+        uint64_t mTimestamp;
+        std::string mMessage;
+    };
+
+    std::array<FormattedMessage, LogRing::Capacity> gFormattedMessages;
+    size_t gFormattedIndex = 0;
+
+#if defined(_MSC_VER)
+    __declspec(noinline)
+#else
+    __attribute__((noinline))
+#endif
+    void FormatNow(uint64_t timestamp, const char* format, ...)
+    {
+        FormattedMessage& message = gFormattedMessages[gFormattedIndex];
+        gFormattedIndex = (gFormattedIndex + 1) % gFormattedMessages.size();
+
+        va_list args;
+        va_start(args, format);
+        char buffer[4096];
+        vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+
+        message.mTimestamp = timestamp;
+        message.mMessage = buffer;
+    }
+
+    uint64_t Now()
+    {
+        return std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    }
+
+    struct Result
+    {
+        double mCall;
+        double mDrain;
+        uint64_t mAllocations;
+    };
+
+    // Runs log(i) for every call in batches and returns the best per call time over the runs. The first run only warms
+    // up, it registers the call site and the thread's ring and grows the strings of the old path.
+    template <typename Function>
+    Result Measure(const Settings& settings, const Function& log)
+    {
+        Result best = {};
+        for (uint32_t run = 0; run <= settings.mRepeatCount; ++run)
+        {
+            Result result = {};
+            for (uint32_t begin = 0; begin < settings.mCallCount; begin += BatchSize)
+            {
+                const uint32_t end = std::min(begin + BatchSize, settings.mCallCount);
+                const uint64_t allocations = gAllocationCount.load(std::memory_order_relaxed);
+                const auto start = std::chrono::steady_clock::now();
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    log(i);
+                }
+                const auto logged = std::chrono::steady_clock::now();
+                result.mAllocations += gAllocationCount.load(std::memory_order_relaxed) - allocations;
+
+                Logger::Get().ProcessQueue();
+                result.mCall += std::chrono::duration<double, std::nano>(logged - start).count();
+                result.mDrain += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - logged).count();
+            }
+
+            result.mCall /= settings.mCallCount;
+            result.mDrain /= settings.mCallCount;
+            if (run == 1 || (run > 1 && result.mCall < best.mCall))
+            {
+                best = result;
+            }
+        }
+        return best;
+    }
+
+    struct Scenario
+    {
+        const char* mName;
+        Result (*mLogged)(const Settings& settings);
+        Result (*mFormatted)(const Settings& settings);
+    };
+
+    const char* const gNames[] = { "bird", "pipe", "background", "ground" };
+
+    const Scenario gScenarios[] =
+    {
+        {
+            "no args",
+            [](const Settings& settings) { return Measure(settings, [](uint32_t) { LOG_INFO(General, "Frame started"); }); },
+            [](const Settings& settings) { return Measure(settings, [](uint32_t) { FormatNow(Now(), "Frame started"); }); },
+        },
+        {
+            "2 ints",
+            [](const Settings& settings) { return Measure(settings, [](uint32_t i) { LOG_INFO(General, "Frame %u took %d us", i, static_cast<int>(i & 0xFFFF)); }); },
+            [](const Settings& settings) { return Measure(settings, [](uint32_t i) { FormatNow(Now(), "Frame %u took %d us", i, static_cast<int>(i & 0xFFFF)); }); },
+        },
+        {
+            "3 doubles",
+            [](const Settings& settings) { return Measure(settings, [](uint32_t i) { LOG_INFO(General, "Bird at %.2f, %.2f moving %.3f", i * 0.5, i * 0.25, i * 0.125); }); },
+            [](const Settings& settings) { return Measure(settings, [](uint32_t i) { FormatNow(Now(), "Bird at %.2f, %.2f moving %.3f", i * 0.5, i * 0.25, i * 0.125); }); },
+        },
+        {
+            "string + int",
+            [](const Settings& settings) { return Measure(settings, [](uint32_t i) { LOG_INFO(General, "Loaded %s in %u us", gNames[i & 3], i); }); },
+            [](const Settings& settings) { return Measure(settings, [](uint32_t i) { FormatNow(Now(), "Loaded %s in %u us", gNames[i & 3], i); }); },
+        },
+    };
+}
+
+void* operator new(size_t size)
+{
+    gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = malloc(size != 0 ? size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    free(memory);
+}
+
+int main(int argc, char** argv)
+{
+    Settings settings;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        const char* option = argv[i];
+        const uint32_t value = static_cast<uint32_t>(std::max(atoi(argv[++i]), 1));
+        if (strcmp(option, "--calls") == 0)
+        {
+            settings.mCallCount = value;
+        }
+        else if (strcmp(option, "--repeat") == 0)
+        {
+            settings.mRepeatCount = value;
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    // The logger thread isn't started, the batches are drained by hand between the timed loops
+    Logger::Get().AddSink(std::make_unique<FormatSink>());
+    Logger::SetLevel(LogLevel::Info);
+
+    printf("%u calls, best of %u runs, ns per message\n\n", settings.mCallCount, settings.mRepeatCount);
+    printf("message        LOG_INFO   drain   allocs   vsnprintf   allocs   speedup\n");
+    for (const Scenario& scenario : gScenarios)
+    {
+        const Result logged = scenario.mLogged(settings);
+        const Result formatted = scenario.mFormatted(settings);
+        printf("%-12s %10.1f %7.1f %8llu %11.1f %8llu %9.2f\n", scenario.mName, logged.mCall, logged.mDrain,
+               static_cast<unsigned long long>(logged.mAllocations), formatted.mCall,
+               static_cast<unsigned long long>(formatted.mAllocations), formatted.mCall / logged.mCall);
+    }
+
+    const LogStats stats = Logger::Get().GetStats();
+    if (stats.mDropped != 0)
+    {
+        fprintf(stderr, "%llu messages were dropped, the batches don't fit in the ring\n", static_cast<unsigned long long>(stats.mDropped));
+        return 1;
+    }
+    return 0;
+}
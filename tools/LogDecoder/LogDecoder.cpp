@@ -0,0 +1,269 @@
+// Turns binary log files written by BinaryLogFileSink back into text.
+//
+// Usage: LogDecoder <log.bin> [--level <name>] [--category <name>] [--thread <id>] [--file <text>] [--grep <text>]
+//    --level     Only show messages at or above this level (Trace, Debug, Info, Warn, Error)
+//    --category  Only show messages from this category
+//    --thread    Only show messages logged by this thread
+//    --file      Only show messages whose source file contains this text
+//    --grep      Only show messages whose formatted text contains this text
+
+#include <Log.h>
+#include <LogFile.h>
+#include <LogFormat.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <strings.h>
+#endif
+
+namespace
+{
+    struct Site
+    {
+        bool mValid = false;
+        uint32_t mLine = 0;
+        LogLevel mLevel = LogLevel::Info;
+        LogCategory mCategory = LogCategory::General;
+        std::string mFile;
+        std::string mFormat;
+        std::vector<LogArgType> mSignature;
+    };
+
+    struct Filter
+    {
+        LogLevel mLevel = LogLevel::Trace;
+        int mCategory = -1;
+        int64_t mThread = -1;
+        const char* mFile = nullptr;
+        const char* mText = nullptr;
+    };
+
+    template <typename GetName>
+    int FindByName(const char* name, int count, GetName getName)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+#if defined(_WIN32)
+            if (_stricmp(name, getName(i)) == 0)
+#else
+            if (strcasecmp(name, getName(i)) == 0)
+#endif
+            {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    bool ReadFile(const char* path, std::vector<uint8_t>& data)
+    {
+        FILE* file = fopen(path, "rb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        fseek(file, 0, SEEK_END);
+        const long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+
+        data.resize(size > 0 ? static_cast<size_t>(size) : 0);
+        const size_t read = fread(data.data(), 1, data.size(), file);
+        fclose(file);
+        return read == data.size();
+    }
+
+    void DecodeChunk(const uint8_t* chunk, uint32_t usedBytes, uint64_t ticksPerSecond, uint64_t baseTimestamp,
+                     std::vector<Site>& sites, const Filter& filter)
+    {
+        uint32_t offset = 0;
+        while (offset + sizeof(LogFile::RecordHeader) <= usedBytes)
+        {
+            LogFile::RecordHeader header;
+            memcpy(&header, chunk + offset, sizeof(header));
+            if (header.mSize < sizeof(header) || offset + header.mSize > usedBytes)
+            {
+                fprintf(stderr, "Corrupt record at chunk offset %u\n", offset);
+                return;
+            }
+
+            const uint8_t* record = chunk + offset;
+            offset += header.mSize;
+
+            if (header.mType == LogFile::RecordType::Site && header.mSize >= sizeof(LogFile::SiteRecord))
+            {
+                LogFile::SiteRecord siteRecord;
+                memcpy(&siteRecord, record, sizeof(siteRecord));
+                if (sizeof(siteRecord) + siteRecord.mArgCount + siteRecord.mFileLength + siteRecord.mFormatLength > header.mSize)
+                {
+                    continue;
+                }
+
+                const uint8_t* p = record + sizeof(siteRecord);
+                Site& site = sites[siteRecord.mSiteId];
+                site.mValid = true;
+                site.mLine = siteRecord.mLine;
+                site.mLevel = static_cast<LogLevel>(siteRecord.mLevel);
+                site.mCategory = static_cast<LogCategory>(siteRecord.mCategory);
+                site.mSignature.assign(reinterpret_cast<const LogArgType*>(p), reinterpret_cast<const LogArgType*>(p) + siteRecord.mArgCount);
+                p += siteRecord.mArgCount;
+                site.mFile.assign(reinterpret_cast<const char*>(p), siteRecord.mFileLength);
+                p += siteRecord.mFileLength;
+                site.mFormat.assign(reinterpret_cast<const char*>(p), siteRecord.mFormatLength);
+            }
+            else if (header.mType == LogFile::RecordType::Message && header.mSize >= sizeof(LogFile::MessageRecord))
+            {
+                LogFile::MessageRecord message;
+                memcpy(&message, record, sizeof(message));
+                if (sizeof(message) + message.mPayloadSize > header.mSize)
+                {
+                    continue;
+                }
+
+                if (filter.mThread >= 0 && message.mThreadId != static_cast<uint64_t>(filter.mThread))
+                {
+                    continue;
+                }
+
+                const Site& site = sites[message.mSiteId];
+                if (!site.mValid)
+                {
+                    continue;
+                }
+
+                if (site.mLevel < filter.mLevel || (filter.mCategory >= 0 && static_cast<int>(site.mCategory) != filter.mCategory))
+                {
+                    continue;
+                }
+
+                if (filter.mFile != nullptr && site.mFile.find(filter.mFile) == std::string::npos)
+                {
+                    continue;
+                }
+
+                char text[4096];
+                FormatLogMessage(text, sizeof(text), site.mFormat.c_str(), site.mSignature.data(), site.mSignature.size(),
+                                 record + sizeof(message), message.mPayloadSize);
+
+                if (filter.mText != nullptr && strstr(text, filter.mText) == nullptr)
+                {
+                    continue;
+                }
+
+                const double seconds = static_cast<double>(message.mTimestamp - baseTimestamp) / static_cast<double>(ticksPerSecond);
+                printf("[%12.6f] %s(%u) [%s] [%s] tid=%u %s\n", seconds, site.mFile.c_str(), site.mLine, GetLogLevelName(site.mLevel),
+                       GetLogCategoryName(site.mCategory), message.mThreadId, text);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <log.bin> [--level <name>] [--category <name>] [--thread <id>] [--file <text>] [--grep <text>]\n", argv[0]);
+        return 1;
+    }
+
+    Filter filter;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--level") == 0)
+        {
+            int level = FindByName(argv[i + 1], static_cast<int>(LogLevel::Count), [](int index) { return GetLogLevelName(static_cast<LogLevel>(index)); });
+            if (level < 0)
+            {
+                fprintf(stderr, "Unknown level %s\n", argv[i + 1]);
+                return 1;
+            }
+            filter.mLevel = static_cast<LogLevel>(level);
+        }
+        else if (strcmp(argv[i], "--category") == 0)
+        {
+            filter.mCategory = FindByName(argv[i + 1], static_cast<int>(LogCategory::Count), [](int index) { return GetLogCategoryName(static_cast<LogCategory>(index)); });
+            if (filter.mCategory < 0)
+            {
+                fprintf(stderr, "Unknown category %s\n", argv[i + 1]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--thread") == 0)
+        {
+            filter.mThread = strtoll(argv[i + 1], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--file") == 0)
+        {
+            filter.mFile = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--grep") == 0)
+        {
+            filter.mText = argv[i + 1];
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<uint8_t> data;
+    if (!ReadFile(argv[1], data) || data.size() < LogFile::HeaderSize)
+    {
+        fprintf(stderr, "Could not read %s\n", argv[1]);
+        return 1;
+    }
+
+    LogFile::Header header;
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.mMagic != LogFile::Magic || header.mVersion != LogFile::Version || header.mChunkCount > LogFile::MaxChunks ||
+        LogFile::HeaderSize + static_cast<uint64_t>(header.mChunkSize) * header.mChunkCount > data.size())
+    {
+        fprintf(stderr, "%s is not a log file this tool understands\n", argv[1]);
+        return 1;
+    }
+
+    // Chunks are reused oldest first, so put them back in the order they were written
+    std::vector<uint32_t> order;
+    for (uint32_t i = 0; i < header.mChunkCount; ++i)
+    {
+        if (header.mChunks[i].mSequence != 0)
+        {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&header](uint32_t a, uint32_t b) { return header.mChunks[a].mSequence < header.mChunks[b].mSequence; });
+
+    if (order.empty())
+    {
+        return 0;
+    }
+
+    const uint64_t baseTimestamp = header.mChunks[order.front()].mFirstTimestamp;
+    const uint64_t ticksPerSecond = header.mTicksPerSecond != 0 ? header.mTicksPerSecond : 1;
+
+    std::vector<Site> sites(65536);
+    for (uint32_t index : order)
+    {
+        const LogFile::ChunkInfo& chunk = header.mChunks[index];
+        const uint32_t usedBytes = std::min(chunk.mUsedBytes, header.mChunkSize);
+
+        // Site ids are global but every chunk describes the sites it uses, so don't trust descriptions from older chunks
+        for (Site& site : sites)
+        {
+            site.mValid = false;
+        }
+
+        DecodeChunk(data.data() + LogFile::HeaderSize + static_cast<size_t>(index) * header.mChunkSize, usedBytes,
+                    ticksPerSecond, baseTimestamp, sites, filter);
+    }
+
+    return 0;
+}
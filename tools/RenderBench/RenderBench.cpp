@@ -0,0 +1,597 @@
+// Measures the CPU cost of a renderer frame without a GPU. The renderer runs on a RecordingBackend, which records every
+// pass the same way the D3D12 backend does, or on a SoftwareBackend, which also draws the recorded passes so the submit
+// stage measures its fill rate. The time of every stage of Renderer::Render is reported.
+//
+// Scenarios:
+//    frame         Sprites, retained labels of which one changes every frame, and debug text, like a busy game frame
+//    labels        Only retained labels. Frames where none of them change are measured against frames where a few do.
+//    text-layout   LayoutText against the loop that laid out one character at a time before it, on strings from 16
+//                  characters to 1M. Every frame lays out 1M characters worth of strings with each.
+//    sprite-batch  The CPU batching stage alone, SpriteBatch sorting and building 1k to 100k sprites spread over 8
+//                  layers, both blend modes and --images textures.
+//    upload-ring   The bookkeeping of the upload ring alone, FrameRingAllocator handing out 16 to 4096 allocations a
+//                  frame with the GPU a few frames behind, like the D3D12 backend does.
+//
+// Usage: RenderBench [--scenario frame|labels|text-layout|sprite-batch|upload-ring] [--backend recording|software]
+//                    [--frames <count>] [--sprites <count>] [--images <count>] [--labels <count>] [--changes <count>]
+//                    [--text <lines>] [--workers <count>] [--dump <file.tga>]
+//    --scenario  What to measure. Default frame.
+//    --backend   Backend the renderer runs on. Default recording.
+//    --frames    Number of frames to measure. Default 1000.
+//    --sprites   Sprites drawn every frame. Default 10000.
+//    --images    Sprite images to spread the sprites over, or textures for the sprite-batch scenario. Default 64.
+//    --labels    Retained text labels. Default 100, or 10000 for the labels scenario.
+//    --changes   Labels that change every frame in the second half of the labels scenario. Default 4.
+//    --text      Lines of debug text added every frame. Default 100.
+//    --workers   Threads that record passes, and draw tiles with the software backend, besides the main thread. Default 2,
+//                same as the game.
+//    --dump      Writes the last frame of the software backend to a TGA file.
+//
+// Times are in milliseconds. The first frames are a warm up and not measured.
+
+#include <Font.h>
+#include <FrameRingAllocator.h>
+#include <LogSinks.h>
+#include <RecordingBackend.h>
+#include <Renderer.h>
+#include <SoftwareBackend.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    enum class Scenario
+    {
+        Frame,
+        Labels,
+        TextLayout,
+        SpriteBatch,
+        UploadRing,
+    };
+
+    struct Settings
+    {
+        Scenario mScenario = Scenario::Frame;
+        bool mSoftware = false;
+        const char* mDumpPath = nullptr;
+        uint32_t mFrameCount = 1000;
+        uint32_t mSpriteCount = 10000;
+        uint32_t mImageCount = 64;
+        std::optional<uint32_t> mLabelCount;
+        uint32_t mLabelChanges = 4;
+        uint32_t mTextLines = 100;
+        uint32_t mWorkerCount = RenderPassCount - 1;
+    };
+
+    constexpr uint32_t WarmUpFrames = 16;
+    constexpr uint32_t ScreenWidth = 288;
+    constexpr uint32_t ScreenHeight = 512;
+
+    void PrintUsage()
+    {
+        fprintf(stderr, "Usage: RenderBench [--scenario frame|labels|text-layout|sprite-batch|upload-ring] [--backend recording|software]\n"
+                        "                   [--frames <count>] [--sprites <count>] [--images <count>] [--labels <count>] [--changes <count>]\n"
+                        "                   [--text <lines>] [--workers <count>] [--dump <file.tga>]\n");
+    }
+
+    void PrintStage(const char* name, std::vector<double>& times)
+    {
+        std::sort(times.begin(), times.end());
+
+        double sum = 0.0;
+        for (double time : times)
+        {
+            sum += time;
+        }
+
+        const size_t count = times.size();
+        printf("%-10s %9.4f %9.4f %9.4f %9.4f\n", name, sum / count, times[count / 2], times[std::min(count - 1, count * 99 / 100)], times[count - 1]);
+    }
+
+    // The times of every stage of Renderer::Render over a number of frames
+    class StageTimes
+    {
+    public:
+        void Add(const RenderTimings& timings)
+        {
+            mTimes[0].push_back(timings.mWait);
+            mTimes[1].push_back(timings.mRecord);
+            for (uint32_t pass = 0; pass < RenderPassCount; ++pass)
+            {
+                mTimes[2 + pass].push_back(timings.mPasses[pass]);
+            }
+            mTimes[2 + RenderPassCount].push_back(timings.mSubmit);
+            mTimes[3 + RenderPassCount].push_back(timings.mPresent);
+            mTimes[4 + RenderPassCount].push_back(timings.mFrame);
+        }
+
+        void Print()
+        {
+            printf("stage            avg    median       p99       max\n");
+            PrintStage("wait", mTimes[0]);
+            PrintStage("record", mTimes[1]);
+            PrintStage("  scene", mTimes[2 + ScenePass]);
+            PrintStage("  sprites", mTimes[2 + SpritePass]);
+            PrintStage("  text", mTimes[2 + TextPass]);
+            PrintStage("submit", mTimes[2 + RenderPassCount]);
+            PrintStage("present", mTimes[3 + RenderPassCount]);
+            PrintStage("frame", mTimes[4 + RenderPassCount]);
+        }
+
+    private:
+        std::array<std::vector<double>, 5 + RenderPassCount> mTimes;
+    };
+
+    void RunFrameScenario(const Settings& settings, Renderer& renderer)
+    {
+        // Images of a few different sizes, so they spread over more than one atlas page when there are many
+        std::mt19937 random(1234);
+        std::vector<SpriteImage> images;
+        for (uint32_t i = 0; i < settings.mImageCount; ++i)
+        {
+            const uint32_t size = 16 << (i % 4);
+            std::vector<uint8_t> pixels(size * size * 4, static_cast<uint8_t>(i));
+            images.push_back(renderer.CreateSpriteImage(size, size, pixels.data()));
+        }
+
+        const uint32_t labelCount = settings.mLabelCount.value_or(100);
+        std::vector<TextHandle> labels;
+        for (uint32_t i = 0; i < labelCount; ++i)
+        {
+            labels.push_back(renderer.CreateText("Label " + std::to_string(i), 0, static_cast<int32_t>(i * 16) % ScreenHeight));
+        }
+
+        std::uniform_real_distribution<float> position(-32.0f, static_cast<float>(ScreenWidth));
+        StageTimes times;
+        for (uint32_t frame = 0; frame < WarmUpFrames + settings.mFrameCount; ++frame)
+        {
+            for (uint32_t i = 0; i < settings.mSpriteCount; ++i)
+            {
+                Sprite sprite;
+                sprite.mX = position(random);
+                sprite.mY = position(random);
+                sprite.mWidth = 32.0f;
+                sprite.mHeight = 32.0f;
+                sprite.mLayer = static_cast<uint8_t>(i % 4);
+                sprite.mBlend = i % 8 == 0 ? SpriteBlend::Opaque : SpriteBlend::Alpha;
+                sprite.SetImage(images[i % images.size()]);
+                renderer.DrawSprite(sprite);
+            }
+
+            if (!labels.empty())
+            {
+                renderer.SetText(labels[frame % labels.size()], "Frame " + std::to_string(frame));
+            }
+
+            for (uint32_t line = 0; line < settings.mTextLines; ++line)
+            {
+                renderer.AddDebugText("The quick brown fox jumps over the lazy dog", 0, static_cast<int32_t>(line * 16) % ScreenHeight);
+            }
+
+            renderer.Render();
+            if (frame >= WarmUpFrames)
+            {
+                times.Add(renderer.GetTimings());
+            }
+        }
+
+        printf("%s backend, %u frames, %u sprites, %u images, %u labels, %u lines of text, %u workers\n\n",
+               settings.mSoftware ? "software" : "recording", settings.mFrameCount, settings.mSpriteCount, settings.mImageCount, labelCount, settings.mTextLines, settings.mWorkerCount);
+        times.Print();
+    }
+
+    // Static HUD labels should cost next to nothing once they are laid out and uploaded, and a few changing ones only
+    // what it takes to redo those
+    void RunLabelsScenario(const Settings& settings, Renderer& renderer)
+    {
+        const uint32_t labelCount = settings.mLabelCount.value_or(10000);
+        std::vector<TextHandle> labels;
+        for (uint32_t i = 0; i < labelCount; ++i)
+        {
+            const int32_t x = static_cast<int32_t>(i / (ScreenHeight / 16) * 96) % ScreenWidth;
+            labels.push_back(renderer.CreateText("Score " + std::to_string(i), x, static_cast<int32_t>(i * 16) % ScreenHeight));
+        }
+
+        // The first frames upload every label
+        StageTimes steady;
+        for (uint32_t frame = 0; frame < WarmUpFrames + settings.mFrameCount; ++frame)
+        {
+            renderer.Render();
+            if (frame >= WarmUpFrames)
+            {
+                steady.Add(renderer.GetTimings());
+            }
+        }
+
+        StageTimes changing;
+        const uint32_t changes = labels.empty() ? 0 : std::min(settings.mLabelChanges, labelCount);
+        uint32_t next = 0;
+        for (uint32_t frame = 0; frame < settings.mFrameCount; ++frame)
+        {
+            for (uint32_t i = 0; i < changes; ++i)
+            {
+                renderer.SetText(labels[next], "Score " + std::to_string(frame * changes + i));
+                next = (next + 1) % labelCount;
+            }
+
+            renderer.Render();
+            changing.Add(renderer.GetTimings());
+        }
+
+        printf("%s backend, %u frames, %u labels, %u workers\n\n", settings.mSoftware ? "software" : "recording",
+               settings.mFrameCount, labelCount, settings.mWorkerCount);
+        printf("No label changes\n");
+        steady.Print();
+        printf("\n%u label changes per frame\n", changes);
+        changing.Print();
+    }
+
+    // LayoutText as it was before it did 16 characters at a time, the baseline of the text-layout scenario
+    size_t LayoutTextReference(std::string_view text, int32_t x, int32_t y, uint32_t color, GlyphInstance* instances, size_t capacity)
+    {
+        const auto clampToInt16 = [](int32_t value) { return static_cast<int16_t>(std::clamp<int32_t>(value, INT16_MIN, INT16_MAX)); };
+        const size_t count = std::min(text.size(), capacity);
+        const int16_t glyphY = clampToInt16(y);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint8_t glyph = static_cast<uint8_t>(text[i]);
+            if (static_cast<uint32_t>(glyph) - Font::FirstChar >= Font::NumChars)
+            {
+                glyph = '?';
+            }
+
+            instances[i].mX = clampToInt16(x + static_cast<int32_t>(i * Font::CharWidth));
+            instances[i].mY = glyphY;
+            instances[i].mGlyphAndColor = PackGlyph(static_cast<uint8_t>(glyph - Font::FirstChar), color);
+        }
+
+        return count;
+    }
+
+    void RunTextLayoutScenario(const Settings& settings)
+    {
+        constexpr size_t CharsPerFrame = 1 << 20;
+        constexpr size_t Lengths[] = { 16, 64, 256, 4096, 65536, CharsPerFrame };
+
+        // Mostly printable ASCII with the odd byte outside of the font, so both loops take the '?' path now and then
+        std::mt19937 random(1234);
+        std::uniform_int_distribution<int> printable(' ', '~');
+        std::string text(CharsPerFrame, ' ');
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            text[i] = i % 61 == 0 ? static_cast<char>(0x80 + i % 128) : static_cast<char>(printable(random));
+        }
+
+        std::vector<GlyphInstance> reference(CharsPerFrame);
+        std::vector<GlyphInstance> instances(CharsPerFrame);
+
+        printf("%u frames of %zu characters, median ns per character\n\n", settings.mFrameCount, CharsPerFrame);
+        printf("length    reference  LayoutText   speedup\n");
+        for (size_t length : Lengths)
+        {
+            // Consecutive strings start at consecutive offsets, so they are laid out into one long run of instances
+            const auto layOut = [&text, length](auto layout, std::vector<GlyphInstance>& output)
+            {
+                for (size_t offset = 0; offset < CharsPerFrame; offset += length)
+                {
+                    layout(std::string_view(text).substr(offset, length), static_cast<int32_t>(offset % 512), static_cast<int32_t>(offset % 509),
+                           0x80FF40, output.data() + offset, length);
+                }
+            };
+
+            std::vector<double> referenceTimes;
+            std::vector<double> layoutTimes;
+            for (uint32_t frame = 0; frame < WarmUpFrames + settings.mFrameCount; ++frame)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                layOut(LayoutTextReference, reference);
+                const auto referenceDone = std::chrono::steady_clock::now();
+                layOut(LayoutText, instances);
+                const auto layoutDone = std::chrono::steady_clock::now();
+
+                if (frame >= WarmUpFrames)
+                {
+                    referenceTimes.push_back(std::chrono::duration<double, std::nano>(referenceDone - start).count() / CharsPerFrame);
+                    layoutTimes.push_back(std::chrono::duration<double, std::nano>(layoutDone - referenceDone).count() / CharsPerFrame);
+                }
+            }
+
+            if (memcmp(reference.data(), instances.data(), CharsPerFrame * sizeof(GlyphInstance)) != 0)
+            {
+                fprintf(stderr, "LayoutText doesn't match the reference for strings of %zu characters\n", length);
+                exit(1);
+            }
+
+            std::sort(referenceTimes.begin(), referenceTimes.end());
+            std::sort(layoutTimes.begin(), layoutTimes.end());
+            const double referenceTime = referenceTimes[referenceTimes.size() / 2];
+            const double layoutTime = layoutTimes[layoutTimes.size() / 2];
+            printf("%7zu %11.4f %11.4f %9.2f\n", length, referenceTime, layoutTime, referenceTime / layoutTime);
+        }
+    }
+
+    // Sprites are added in a random order of layers, blend modes and textures, the way a game adds them object by object,
+    // so the sort has real work to do
+    void RunSpriteBatchScenario(const Settings& settings)
+    {
+        constexpr uint32_t SpriteCounts[] = { 1000, 10000, 100000 };
+        constexpr uint32_t LayerCount = 8;
+
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> position(-32.0f, static_cast<float>(ScreenWidth));
+        std::uniform_int_distribution<uint32_t> layer(0, LayerCount - 1);
+        std::uniform_int_distribution<uint32_t> texture(0, settings.mImageCount - 1);
+
+        printf("%u frames, %u layers, %u textures, times in ms\n\n", settings.mFrameCount, LayerCount, settings.mImageCount);
+        printf("sprites    draws       add  median build   p99 build  ns/sprite\n");
+        for (uint32_t spriteCount : SpriteCounts)
+        {
+            std::vector<Sprite> sprites(spriteCount);
+            for (Sprite& sprite : sprites)
+            {
+                sprite.mX = position(random);
+                sprite.mY = position(random);
+                sprite.mWidth = 32.0f;
+                sprite.mHeight = 32.0f;
+                sprite.mLayer = static_cast<uint8_t>(layer(random));
+                sprite.mBlend = random() % 8 == 0 ? SpriteBlend::Opaque : SpriteBlend::Alpha;
+                sprite.mTexture = static_cast<SpriteTexture>(texture(random));
+            }
+
+            SpriteBatch batch;
+            std::vector<SpriteInstance> instances(spriteCount);
+            std::vector<SpriteDraw> draws;
+            std::vector<double> addTimes;
+            std::vector<double> buildTimes;
+            for (uint32_t frame = 0; frame < WarmUpFrames + settings.mFrameCount; ++frame)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                for (const Sprite& sprite : sprites)
+                {
+                    batch.Add(sprite);
+                }
+                const auto added = std::chrono::steady_clock::now();
+                draws.clear();
+                batch.Build(instances.data(), draws);
+                const auto built = std::chrono::steady_clock::now();
+                batch.Clear();
+
+                if (frame >= WarmUpFrames)
+                {
+                    addTimes.push_back(std::chrono::duration<double, std::milli>(added - start).count());
+                    buildTimes.push_back(std::chrono::duration<double, std::milli>(built - added).count());
+                }
+            }
+
+            std::sort(addTimes.begin(), addTimes.end());
+            std::sort(buildTimes.begin(), buildTimes.end());
+            const size_t count = buildTimes.size();
+            const double build = buildTimes[count / 2];
+            printf("%7u %8zu %9.4f %13.4f %11.4f %10.2f\n", spriteCount, draws.size(), addTimes[count / 2], build,
+                   buildTimes[std::min(count - 1, count * 99 / 100)], build * 1e6 / spriteCount);
+        }
+    }
+
+    // Sizes and alignments go from small constant buffers to large vertex batches. They are picked up front so the random
+    // numbers aren't timed. The GPU is FramesInFlight frames behind, so every frame retires the one that many frames back.
+    void RunUploadRingScenario(const Settings& settings)
+    {
+        constexpr uint64_t Capacity = 4 * 1024 * 1024;
+        constexpr uint64_t FramesInFlight = 3;
+        constexpr uint32_t AllocationCounts[] = { 16, 256, 4096 };
+
+        std::mt19937 random(1234);
+        std::uniform_int_distribution<uint64_t> size(16, 256);
+        const uint64_t alignments[] = { 16, 256 };
+
+        printf("%u frames, %llu MB ring, %llu frames in flight, median times\n\n", settings.mFrameCount,
+               static_cast<unsigned long long>(Capacity >> 20), static_cast<unsigned long long>(FramesInFlight));
+        printf("allocations  ns/allocate  end+retire ns   frame us  failed  high water KB\n");
+        for (uint32_t allocationCount : AllocationCounts)
+        {
+            std::vector<std::pair<uint64_t, uint64_t>> requests(allocationCount);
+            for (auto& request : requests)
+            {
+                request = { size(random), alignments[random() % 2] };
+            }
+
+            FrameRingAllocator ring;
+            ring.Initialize(Capacity);
+
+            std::vector<double> allocateTimes;
+            std::vector<double> endFrameTimes;
+            std::vector<double> frameTimes;
+            uint64_t failed = 0;
+            uint64_t checksum = 0;
+            for (uint64_t frame = 1; frame <= WarmUpFrames + settings.mFrameCount; ++frame)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                for (const auto& request : requests)
+                {
+                    const uint64_t offset = ring.Allocate(request.first, request.second);
+                    failed += offset == FrameRingAllocator::InvalidOffset ? 1 : 0;
+                    checksum += offset;
+                }
+                const auto allocated = std::chrono::steady_clock::now();
+                ring.EndFrame(frame);
+                ring.Retire(frame > FramesInFlight ? frame - FramesInFlight : 0);
+                const auto retired = std::chrono::steady_clock::now();
+
+                if (frame > WarmUpFrames)
+                {
+                    allocateTimes.push_back(std::chrono::duration<double, std::nano>(allocated - start).count() / allocationCount);
+                    endFrameTimes.push_back(std::chrono::duration<double, std::nano>(retired - allocated).count());
+                    frameTimes.push_back(std::chrono::duration<double, std::micro>(retired - start).count());
+                }
+            }
+
+            // Keeps the offsets from being optimized away
+            if (checksum == 1)
+            {
+                printf("\n");
+            }
+
+            for (std::vector<double>* times : { &allocateTimes, &endFrameTimes, &frameTimes })
+            {
+                std::sort(times->begin(), times->end());
+            }
+            const size_t median = frameTimes.size() / 2;
+            printf("%11u %12.2f %14.1f %10.3f %7llu %14llu\n", allocationCount, allocateTimes[median], endFrameTimes[median],
+                   frameTimes[median], static_cast<unsigned long long>(failed),
+                   static_cast<unsigned long long>(ring.GetHighWaterMark() / 1024));
+        }
+
+        printf("\nend+retire includes reading the clock once, which is most of it\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Settings settings;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        const char* option = argv[i];
+        const char* argument = argv[++i];
+        const uint32_t value = static_cast<uint32_t>(std::max(atoi(argument), 0));
+        if (strcmp(option, "--scenario") == 0 && strcmp(argument, "frame") == 0)
+        {
+            settings.mScenario = Scenario::Frame;
+        }
+        else if (strcmp(option, "--scenario") == 0 && strcmp(argument, "labels") == 0)
+        {
+            settings.mScenario = Scenario::Labels;
+        }
+        else if (strcmp(option, "--scenario") == 0 && strcmp(argument, "text-layout") == 0)
+        {
+            settings.mScenario = Scenario::TextLayout;
+        }
+        else if (strcmp(option, "--scenario") == 0 && strcmp(argument, "sprite-batch") == 0)
+        {
+            settings.mScenario = Scenario::SpriteBatch;
+        }
+        else if (strcmp(option, "--scenario") == 0 && strcmp(argument, "upload-ring") == 0)
+        {
+            settings.mScenario = Scenario::UploadRing;
+        }
+        else if (strcmp(option, "--backend") == 0 && (strcmp(argument, "recording") == 0 || strcmp(argument, "software") == 0))
+        {
+            settings.mSoftware = strcmp(argument, "software") == 0;
+        }
+        else if (strcmp(option, "--dump") == 0)
+        {
+            settings.mDumpPath = argument;
+        }
+        else if (strcmp(option, "--frames") == 0)
+        {
+            settings.mFrameCount = std::max(value, 1u);
+        }
+        else if (strcmp(option, "--sprites") == 0)
+        {
+            settings.mSpriteCount = value;
+        }
+        else if (strcmp(option, "--images") == 0)
+        {
+            settings.mImageCount = std::max(value, 1u);
+        }
+        else if (strcmp(option, "--labels") == 0)
+        {
+            settings.mLabelCount = value;
+        }
+        else if (strcmp(option, "--changes") == 0)
+        {
+            settings.mLabelChanges = value;
+        }
+        else if (strcmp(option, "--text") == 0)
+        {
+            settings.mTextLines = value;
+        }
+        else if (strcmp(option, "--workers") == 0)
+        {
+            settings.mWorkerCount = value;
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    Logger::Get().AddSink(std::make_unique<ConsoleLogSink>());
+    Logger::Get().Start();
+
+    if (settings.mDumpPath != nullptr && !settings.mSoftware)
+    {
+        fprintf(stderr, "--dump needs the software backend\n");
+        return 1;
+    }
+
+    // These only run the CPU stages and don't need a renderer
+    if (settings.mScenario == Scenario::TextLayout || settings.mScenario == Scenario::SpriteBatch || settings.mScenario == Scenario::UploadRing)
+    {
+        if (settings.mScenario == Scenario::TextLayout)
+        {
+            RunTextLayoutScenario(settings);
+        }
+        else if (settings.mScenario == Scenario::SpriteBatch)
+        {
+            RunSpriteBatchScenario(settings);
+        }
+        else
+        {
+            RunUploadRingScenario(settings);
+        }
+        Logger::Get().Stop();
+        return 0;
+    }
+
+    Renderer renderer;
+    if (settings.mSoftware)
+    {
+        renderer.Initialize(std::make_unique<SoftwareBackend>(ScreenWidth, ScreenHeight, settings.mWorkerCount));
+    }
+    else
+    {
+        renderer.Initialize(std::make_unique<RecordingBackend>(ScreenWidth, ScreenHeight, settings.mWorkerCount));
+    }
+
+    switch (settings.mScenario)
+    {
+    case Scenario::Frame:
+        RunFrameScenario(settings, renderer);
+        break;
+    case Scenario::Labels:
+        RunLabelsScenario(settings, renderer);
+        break;
+    case Scenario::TextLayout:
+    case Scenario::SpriteBatch:
+    case Scenario::UploadRing:
+        break;
+    }
+
+    if (settings.mDumpPath != nullptr && !static_cast<SoftwareBackend&>(renderer.GetBackend()).WriteImage(settings.mDumpPath))
+    {
+        Logger::Get().Stop();
+        return 1;
+    }
+
+    Logger::Get().Stop();
+    return 0;
+}